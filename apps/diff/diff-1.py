@@ -0,0 +1,202 @@
+##########################################################################
+#
+#  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#      * Redistributions of source code must retain the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer.
+#
+#      * Redistributions in binary form must reproduce the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer in the documentation and/or other materials provided with
+#        the distribution.
+#
+#      * Neither the name of John Haddon nor the names of
+#        any other contributors to this software may be used to endorse or
+#        promote products derived from this software without specific prior
+#        written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import os
+import time
+
+import IECore
+
+import Gaffer
+
+class diff( Gaffer.Application ) :
+
+	def __init__( self ) :
+
+		Gaffer.Application.__init__(
+			self,
+			"""
+			Compares the scenes output by a node in two Gaffer scripts,
+			printing the locations which have been added or removed, the
+			locations whose bound, transform, attributes or object have
+			changed, and whether the globals and sets differ. Subtrees whose
+			hashes match are skipped without being computed, so this is
+			suitable for regression checks on large scenes. In the manner of
+			the standard diff utility, exits with a status of 0 if the scenes
+			match, 1 if they differ and 2 if they could not be compared.
+
+			To compare the output of a node in two versions of a script :
+
+			```
+			gaffer diff old.gfr new.gfr -scene NameOfNode
+			```
+
+			To compare differently named nodes :
+
+			```
+			gaffer diff old.gfr new.gfr -scene NameOfNode -scene2 NameOfOtherNode
+			```
+			"""
+		)
+
+		self.parameters().addParameters(
+
+			[
+				IECore.FileNameParameter(
+					name = "script1",
+					description = "The first script to compare.",
+					defaultValue = "",
+					allowEmptyString = False,
+					extensions = "gfr",
+					check = IECore.FileNameParameter.CheckType.MustExist,
+				),
+
+				IECore.FileNameParameter(
+					name = "script2",
+					description = "The second script to compare.",
+					defaultValue = "",
+					allowEmptyString = False,
+					extensions = "gfr",
+					check = IECore.FileNameParameter.CheckType.MustExist,
+				),
+
+				IECore.StringParameter(
+					name = "scene",
+					description = "The name of a SceneNode or ScenePlug to compare.",
+					defaultValue = "",
+					allowEmptyString = False,
+				),
+
+				IECore.StringParameter(
+					name = "scene2",
+					description = "The name of the SceneNode or ScenePlug to compare in "
+						"the second script. Defaults to the same name as the scene parameter.",
+					defaultValue = "",
+				),
+
+				IECore.FloatParameter(
+					name = "frame",
+					description = "The frame to compare the scenes at.",
+					defaultValue = 1,
+				),
+
+			]
+
+		)
+
+		self.parameters().userData()["parser"] = IECore.CompoundObject(
+			{
+				"flagless" : IECore.StringVectorData( [ "script1", "script2" ] )
+			}
+		)
+
+	def _run( self, args ) :
+
+		import GafferScene
+
+		scripts = []
+		scenes = []
+		for scriptParameter, sceneName in (
+			( "script1", args["scene"].value ),
+			( "script2", args["scene2"].value or args["scene"].value ),
+		) :
+
+			script = Gaffer.ScriptNode()
+			script["fileName"].setValue( os.path.abspath( args[scriptParameter].value ) )
+			script.load( continueOnError = True )
+
+			scene = script.descendant( sceneName )
+			if isinstance( scene, Gaffer.Node ) :
+				scene = next( ( x for x in scene.children( GafferScene.ScenePlug ) ), None )
+
+			if scene is None :
+				IECore.msg( IECore.Msg.Level.Error, "diff", "Scene \"%s\" does not exist in \"%s\"" % ( sceneName, args[scriptParameter].value ) )
+				return 2
+
+			scripts.append( script )
+			scenes.append( scene )
+
+		# Each scene is evaluated in the context of its own script, so that
+		# script-level variables are honoured on both sides of the diff.
+		contexts = []
+		for script in scripts :
+			context = Gaffer.Context( script.context() )
+			context.setFrame( args["frame"].value )
+			contexts.append( context )
+
+		startTime = time.time()
+		result = GafferScene.sceneDiff( scenes[0], contexts[0], scenes[1], contexts[1] )
+		duration = time.time() - startTime
+
+		differences = 0
+		for name, paths in [
+			( "Added", result["added"].value ),
+			( "Removed", result["removed"].value ),
+		] + [
+			( "Changed " + p, result["changed"][p].value ) for p in ( "bound", "transform", "attributes", "object" )
+		] :
+
+			paths = paths.paths()
+			if not paths :
+				continue
+
+			print "{name} :\n".format( name = name )
+			for path in sorted( paths ) :
+				print "  " + path
+			print ""
+
+			differences += len( paths )
+
+		if result["globals"].value :
+			print "Changed globals\n"
+			differences += 1
+
+		if len( result["sets"] ) :
+			print "Changed sets :\n"
+			for setName in sorted( result["sets"] ) :
+				print "  " + setName
+			print ""
+			differences += len( result["sets"] )
+
+		print "{differences} difference{s} found in {duration:.3f}s".format(
+			differences = differences,
+			s = "" if differences == 1 else "s",
+			duration = duration,
+		)
+
+		return 0 if differences == 0 else 1
+
+IECore.registerRunTimeTyped( diff )
@@ -286,9 +286,31 @@ class stats( Gaffer.Application ) :
 		self.__timers["Scene generation"] = sceneTimer
 		self.__memory["Scene generation"] = _Memory.maxRSS() - memory
 
-		## \todo Calculate and print scene stats
-		#  - Locations
-		#  - Unique objects, attributes etc
+		with self.__performanceMonitor or _NullContextManager() :
+			stats = GafferScene.sceneStats( scene )
+
+		items = [
+			( "Locations", stats["locations"].value ),
+			( "Max depth", stats["maxDepth"].value ),
+		]
+
+		for objectType in sorted( stats["objects"].keys() ) :
+			objectStats = stats["objects"][objectType]
+			items.extend( [
+				( "", "" ),
+				( objectType.rpartition( ":" )[2], objectStats["count"].value ),
+				( "  Primitives", objectStats["primitives"].value ),
+				( "  Vertices", objectStats["vertices"].value ),
+				( "  Memory", _Memory( objectStats["memory"].value ) ),
+			] )
+
+		if len( stats["sets"] ) :
+			items.append( ( "", "" ) )
+			for setName in sorted( stats["sets"].keys() ) :
+				items.append( ( "Set " + setName, stats["sets"][setName].value ) )
+
+		print "\nScene :\n"
+		self.__printItems( items )
 
 	def __printImage( self, script, args ) :
 
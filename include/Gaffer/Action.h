@@ -96,7 +96,10 @@ class Action : public IECore::RunTimeTyped
 		/// circular reference. It is guaranteed that the subject will
 		/// remain alive for as long as the Functions are in use by the undo
 		/// system, so it is sufficient to bind only raw pointers to the subject.
-		static void enact( GraphComponentPtr subject, const Function &doFn, const Function &undoFn );
+		/// If `cancelsBackgroundTasks` is false, the action is declared
+		/// not to affect the result of any computation, so running
+		/// BackgroundTasks are allowed to continue while it is performed.
+		static void enact( GraphComponentPtr subject, const Function &doFn, const Function &undoFn, bool cancelsBackgroundTasks = true );
 
 	protected :
 
@@ -132,6 +135,12 @@ class Action : public IECore::RunTimeTyped
 		/// implementation before performing their own merging.
 		virtual void merge( const Action *other ) = 0;
 
+		/// May be reimplemented by derived classes to return false
+		/// if the action cannot affect the result of any computation,
+		/// in which case BackgroundTasks needn't be cancelled while
+		/// it is performed. The default implementation returns true.
+		virtual bool cancelsBackgroundTasks() const;
+
 	private :
 
 		friend class ScriptNode;
@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef GAFFER_BACKGROUNDTASK_H
+#define GAFFER_BACKGROUNDTASK_H
+
+#include "tbb/atomic.h"
+#include "tbb/mutex.h"
+#include "tbb/compat/thread"
+
+#include "boost/noncopyable.hpp"
+#include "boost/function.hpp"
+
+namespace Gaffer
+{
+
+class GraphComponent;
+
+/// Runs a function on a background thread, in a manner which is safe
+/// with respect to concurrent edits to the node graph. Before any edit
+/// which may affect the task's subject is made, the task is cancelled and
+/// waited for, so that the graph is never modified while the task is
+/// reading from it. Once the edit is complete, the interrupted task is
+/// run again from the beginning, so the function must be safe to rerun.
+/// Owners which want to launch a different task following an edit should
+/// simply destroy the interrupted one.
+///
+/// Edits are detected via Action::enact() and ScriptNode::undo()/redo(),
+/// so only edits made with undo support are safe. An edit is considered
+/// to affect the task if dirtiness propagated from the edited plugs would
+/// reach the subject, so edits elsewhere in the script, and edits which
+/// don't affect computation at all (such as metadata registrations), leave
+/// the task running. The background function itself must not edit the graph.
+class BackgroundTask : public boost::noncopyable
+{
+
+	public :
+
+		/// Passed to the function so that it may poll
+		/// for cancellation.
+		class Canceller : public boost::noncopyable
+		{
+
+			public :
+
+				bool cancelled() const { return m_cancelled; }
+
+			private :
+
+				Canceller();
+
+				tbb::atomic<bool> m_cancelled;
+
+				friend class BackgroundTask;
+
+		};
+
+		typedef boost::function<void ( const Canceller &canceller )> Function;
+
+		/// Launches the function on a background thread. The function should
+		/// call `canceller.cancelled()` frequently, and return promptly if it
+		/// returns true. Exceptions thrown by the function are reported via
+		/// IECore::msg(). If the task is constructed during an edit, it is
+		/// not launched until the edit is complete.
+		BackgroundTask( const GraphComponent *subject, const Function &function );
+		/// Cancels the task and waits for it to complete.
+		~BackgroundTask();
+
+		/// Requests cancellation, returning immediately.
+		void cancel();
+		/// Waits for the task to complete.
+		void wait();
+		/// Equivalent to `cancel(); wait();`.
+		void cancelAndWait();
+		/// Returns true if the function has run to completion
+		/// without being cancelled.
+		bool done() const;
+
+		/// Cancels and waits for all tasks which may be affected by an edit
+		/// to `actionSubject`, restarting them when the outermost EditScope
+		/// for the script is destroyed. Tasks in other scripts are unaffected.
+		/// Passing `cancelTasks = false` is appropriate for edits which cannot
+		/// affect computation, in which case no tasks are cancelled, but tasks
+		/// in the script are still prevented from launching until the edit is
+		/// complete. A NULL subject conservatively prevents tasks in all scripts
+		/// from launching. This is used by Action::enact() and
+		/// ScriptNode::undo()/redo(), and should not need to be used directly.
+		class EditScope : boost::noncopyable
+		{
+
+			public :
+
+				EditScope( const GraphComponent *actionSubject, bool cancelTasks = true );
+				~EditScope();
+
+			private :
+
+				const GraphComponent *m_script;
+
+		};
+
+		/// Signature of a function used to perform the waits made by
+		/// EditScope and ~BackgroundTask(). It is passed a function which
+		/// performs the wait, and must call it. The Python bindings use
+		/// this to release the GIL while waiting, so that tasks which
+		/// require Python can complete while an edit made from Python
+		/// waits for them. This should not need to be used directly.
+		typedef boost::function<void ( const boost::function<void ()> &wait )> WaitWrapper;
+		static void setWaitWrapper( const WaitWrapper &waitWrapper );
+
+	private :
+
+		void launch();
+		void run();
+		void join();
+
+		const GraphComponent *m_subject;
+		const GraphComponent *m_script;
+		Function m_function;
+		Canceller m_canceller;
+		tbb::atomic<bool> m_done;
+		std::thread m_thread;
+		// Serialises joins made concurrently by wait()
+		// and EditScope.
+		tbb::mutex m_joinMutex;
+
+		// Protected by the global task mutex.
+		bool m_interrupted;
+		// Number of EditScopes currently waiting on the task,
+		// without holding the global mutex. The destructor
+		// waits for this to reach zero. Protected by the
+		// global task mutex.
+		int m_pins;
+
+};
+
+} // namespace Gaffer
+
+#endif // GAFFER_BACKGROUNDTASK_H
@@ -129,6 +129,23 @@ class Context : public IECore::RefCounted
 		template<typename T>
 		typename Accessor<T>::ResultType get( const IECore::InternedString &name, typename Accessor<T>::ResultType defaultValue ) const;
 
+		/// Sets an IECore::Data value with the specified ownership. Using
+		/// Shared or Borrowed ownership avoids the copy made by `set()`,
+		/// subject to the constraints documented for the Ownership enum.
+		/// Values are not compared, so setting a different but equal object
+		/// is treated as a change.
+		void set( const IECore::InternedString &name, const IECore::Data *value, Ownership ownership );
+		/// As above, but additionally accepting a precomputed hash for the value,
+		/// saving `hash()` from computing it again. The hash must be identical
+		/// to the one `hash()` would compute itself, as documented below. This
+		/// allows callers which maintain hashes incrementally during scene
+		/// traversals to avoid rehashing every path from scratch.
+		void set( const IECore::InternedString &name, const IECore::Data *value, Ownership ownership, const IECore::MurmurHash &hash );
+		/// As for the templated `set()` above, but additionally accepting a
+		/// precomputed hash, with the same constraints as above.
+		template<typename T>
+		void set( const IECore::InternedString &name, const T &value, const IECore::MurmurHash &hash );
+
 		/// Removes an entry from the context if it exists
 		void remove( const IECore::InternedString& name );
 
@@ -171,6 +188,17 @@ class Context : public IECore::RefCounted
 		/// A signal emitted when an element of the context is changed.
 		ChangedSignal &changedSignal();
 
+		/// Returns a hash of all the entries in the context. Each
+		/// InternedStringVectorData entry (typically "scene:path") is hashed
+		/// by appending its elements one at a time as strings to a default
+		/// constructed MurmurHash. The hash for a path can therefore be
+		/// derived incrementally from the hash for its parent, and supplied
+		/// to `set()` to avoid the cost of rehashing deep paths.
+		/// Note that this applies to every InternedStringVectorData variable,
+		/// not just "scene:path", so the hash of any context containing such
+		/// a variable differs from that computed by previous versions. Code
+		/// which stores context hashes or compares them against hard-coded
+		/// values must be updated accordingly.
 		IECore::MurmurHash hash() const;
 
 		bool operator == ( const Context &other ) const;
@@ -248,6 +276,9 @@ class Context : public IECore::RefCounted
 			// And use this ownership flag to tell us when we need to do explicit
 			// reference count management.
 			Ownership ownership;
+			// Precomputed hash for the data, or a default constructed
+			// hash if it must be computed by `hash()`.
+			IECore::MurmurHash hash;
 		};
 
 		typedef boost::container::flat_map<IECore::InternedString, Storage> Map;
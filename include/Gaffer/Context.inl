@@ -181,6 +181,7 @@ void Context::set( const IECore::InternedString &name, const T &value )
 	Storage &s = m_map[name];
 	if( Accessor<T>().set( s, value ) )
 	{
+		s.hash = IECore::MurmurHash();
 		m_hashValid = false;
 		if( m_changedSignal )
 		{
@@ -189,6 +190,27 @@ void Context::set( const IECore::InternedString &name, const T &value )
 	}
 }
 
+template<typename T>
+void Context::set( const IECore::InternedString &name, const T &value, const IECore::MurmurHash &hash )
+{
+	Storage &s = m_map[name];
+	if( Accessor<T>().set( s, value ) )
+	{
+		s.hash = hash;
+		m_hashValid = false;
+		if( m_changedSignal )
+		{
+			(*m_changedSignal)( this, name );
+		}
+	}
+	else
+	{
+		// Value is unchanged, so the hash must be too,
+		// but we may not have stored it previously.
+		s.hash = hash;
+	}
+}
+
 template<typename T>
 typename Context::Accessor<T>::ResultType Context::get( const IECore::InternedString &name ) const
 {
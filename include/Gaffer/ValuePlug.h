@@ -38,6 +38,8 @@
 #ifndef GAFFER_VALUEPLUG_H
 #define GAFFER_VALUEPLUG_H
 
+#include "boost/noncopyable.hpp"
+
 #include "IECore/Object.h"
 
 #include "Gaffer/Plug.h"
@@ -112,6 +114,21 @@ class ValuePlug : public Plug
 		static void setCacheMemoryLimit( size_t bytes );
 		/// Returns the current memory usage of the cache in bytes.
 		static size_t cacheMemoryUsage();
+		/// While an UncachedScope is active, values requested directly
+		/// by the current thread are not stored in the cache, although
+		/// values computed upstream on their behalf are cached as usual.
+		/// This is useful when computing large values which are known to
+		/// be needed only once, and which would otherwise displace more
+		/// useful entries from the cache and prolong their own lifetime.
+		class UncachedScope : boost::noncopyable
+		{
+
+			public :
+
+				UncachedScope();
+				~UncachedScope();
+
+		};
 		//@}
 
 	protected :
@@ -95,8 +95,6 @@ class AlembicSource : public SceneNode
 		virtual IECore::ConstInternedStringVectorDataPtr computeSetNames( const Gaffer::Context *context, const ScenePlug *parent ) const;
 		virtual GafferScene::ConstPathMatcherDataPtr computeSet( const IECore::InternedString &setName, const Gaffer::Context *context, const ScenePlug *parent ) const;
 
-		IECoreAlembic::AlembicInputPtr inputForPath( const ScenePath &path ) const;
-
 		static size_t g_firstPlugIndex;
 
 };
@@ -37,6 +37,8 @@
 #ifndef GAFFERSCENE_DUPLICATE_H
 #define GAFFERSCENE_DUPLICATE_H
 
+#include "IECore/ObjectVector.h"
+
 #include "Gaffer/TransformPlug.h"
 
 #include "GafferScene/BranchCreator.h"
@@ -66,6 +68,15 @@ class Duplicate : public BranchCreator
 		Gaffer::TransformPlug *transformPlug();
 		const Gaffer::TransformPlug *transformPlug() const;
 
+		/// When on, the copies are output as a single EncapsulatedInstances
+		/// object at one location, rather than as a full branch per copy.
+		/// The target subtree is evaluated only once and shared as the
+		/// prototype for every copy, so the cost is independent of the
+		/// number of copies. Only the attributes of the target itself
+		/// are transferred to the copies.
+		Gaffer::BoolPlug *encapsulateCopiesPlug();
+		const Gaffer::BoolPlug *encapsulateCopiesPlug() const;
+
 		virtual void affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const;
 
 	protected :
@@ -109,6 +120,12 @@ class Duplicate : public BranchCreator
 
 		void sourcePath( const ScenePath &branchPath, ScenePath &source ) const;
 
+		// Computes the transforms for each of the copies, relative to the parent.
+		void copyTransforms( const ScenePath &target, std::vector<Imath::M44f> &transforms ) const;
+		// Traverses the target hierarchy for encapsulated copies, gathering
+		// the objects and their transforms relative to the target.
+		void prototypesWalk( Gaffer::Context *context, ScenePath &path, size_t rootSize, const Imath::M44f &parentTransform, IECore::ObjectVector *prototypes, std::vector<std::string> &names, std::vector<Imath::M44f> &transforms ) const;
+
 		static size_t g_firstPlugIndex;
 
 };
@@ -0,0 +1,114 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef GAFFERSCENE_ENCAPSULATEDINSTANCES_H
+#define GAFFERSCENE_ENCAPSULATEDINSTANCES_H
+
+#include "IECore/VisibleRenderable.h"
+#include "IECore/ObjectVector.h"
+#include "IECore/VectorTypedData.h"
+
+#include "GafferScene/TypeIds.h"
+
+namespace GafferScene
+{
+
+/// A compact representation of many instances of a set of prototype
+/// objects, as output by the Instancer when `encapsulateInstances` is
+/// on. Rather than generating a scene location per instance, the
+/// instance transforms and ids are stored as arrays alongside a single
+/// copy of each prototype object. Renderer backends and the viewer are
+/// therefore able to share a single copy of the prototype between all
+/// instances.
+///
+/// Only the objects and transforms of the prototype hierarchy are
+/// represented. Attributes and set memberships of locations within the
+/// prototype are not stored, so all instances take the attributes of
+/// the location holding the EncapsulatedInstances object.
+class EncapsulatedInstances : public IECore::VisibleRenderable
+{
+
+	public :
+
+		EncapsulatedInstances();
+		/// The prototypes vector should contain only VisibleRenderables. Each
+		/// prototype has a name and a transform relative to the instance root.
+		/// Names are paths relative to the instance root, with the root itself
+		/// being named "/".
+		EncapsulatedInstances(
+			IECore::ConstObjectVectorPtr prototypes,
+			IECore::ConstStringVectorDataPtr prototypeNames,
+			IECore::ConstM44fVectorDataPtr prototypeTransforms,
+			IECore::ConstM44fVectorDataPtr instanceTransforms,
+			IECore::ConstIntVectorDataPtr instanceIds
+		);
+
+		IE_CORE_DECLAREEXTENSIONOBJECT( GafferScene::EncapsulatedInstances, EncapsulatedInstancesTypeId, IECore::VisibleRenderable );
+
+		const IECore::ObjectVector *prototypes() const;
+		const IECore::StringVectorData *prototypeNames() const;
+		const IECore::M44fVectorData *prototypeTransforms() const;
+
+		const IECore::M44fVectorData *instanceTransforms() const;
+		const IECore::IntVectorData *instanceIds() const;
+
+		size_t numInstances() const;
+
+		/// Renders every prototype once for each instance.
+		virtual void render( IECore::Renderer *renderer ) const;
+		virtual Imath::Box3f bound() const;
+
+		/// Returns the bound of the prototypes, relative
+		/// to the root of a single instance.
+		Imath::Box3f prototypeBound() const;
+
+	private :
+
+		IECore::ConstObjectVectorPtr m_prototypes;
+		IECore::ConstStringVectorDataPtr m_prototypeNames;
+		IECore::ConstM44fVectorDataPtr m_prototypeTransforms;
+		IECore::ConstM44fVectorDataPtr m_instanceTransforms;
+		IECore::ConstIntVectorDataPtr m_instanceIds;
+
+		static const unsigned int m_ioVersion;
+
+};
+
+IE_CORE_DECLAREPTR( EncapsulatedInstances )
+
+} // namespace GafferScene
+
+#endif // GAFFERSCENE_ENCAPSULATEDINSTANCES_H
@@ -38,6 +38,9 @@
 #ifndef GAFFERSCENE_INSTANCER_H
 #define GAFFERSCENE_INSTANCER_H
 
+#include "IECore/ObjectVector.h"
+#include "IECore/VectorTypedData.h"
+
 #include "GafferScene/BranchCreator.h"
 
 namespace GafferScene
@@ -59,10 +62,37 @@ class Instancer : public BranchCreator
 		ScenePlug *instancePlug();
 		const ScenePlug *instancePlug() const;
 
+		/// When on, the instances are output as a single EncapsulatedInstances
+		/// object at the location specified by namePlug(), rather than as a
+		/// child location per instance. The prototype is evaluated only
+		/// once, without the "instancer:id" context variable, so it may not
+		/// vary per instance.
+		Gaffer::BoolPlug *encapsulateInstancesPlug();
+		const Gaffer::BoolPlug *encapsulateInstancesPlug() const;
+
+		/// The names of optional primitive variables used to construct
+		/// the instance transforms, in addition to the "P" primitive
+		/// variable. The orientation must be a QuatfVectorData, the
+		/// scale either a V3fVectorData or a FloatVectorData, and the
+		/// pivot, about which rotation and scaling are applied, a
+		/// V3fVectorData.
+		Gaffer::StringPlug *orientationPlug();
+		const Gaffer::StringPlug *orientationPlug() const;
+
+		Gaffer::StringPlug *scalePlug();
+		const Gaffer::StringPlug *scalePlug() const;
+
+		Gaffer::StringPlug *pivotPlug();
+		const Gaffer::StringPlug *pivotPlug() const;
+
 		virtual void affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const;
 
 	protected :
 
+		/// Implemented for instanceTransformsPlug().
+		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+
 		virtual void hashBranchBound( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual Imath::Box3f computeBranchBound( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context ) const;
 
@@ -80,8 +110,29 @@ class Instancer : public BranchCreator
 
 	private :
 
+		// Stores the transforms for all instances, so that they
+		// are built in a single batch and then shared between the
+		// transform, bound and object computations. Evaluated with
+		// the scene:path set to the parent location.
+		Gaffer::ObjectPlug *instanceTransformsPlug();
+		const Gaffer::ObjectPlug *instanceTransformsPlug() const;
+
+		IECore::ConstM44fVectorDataPtr computeInstanceTransforms() const;
+		IECore::ConstM44fVectorDataPtr instanceTransforms( const ScenePath &parentPath ) const;
+		IECore::MurmurHash instanceTransformsHash( const ScenePath &parentPath ) const;
+
 		struct BoundHash;
 		struct BoundUnion;
+		struct TransformedBoundUnion;
+
+		// Makes a context for evaluating the prototype root once
+		// for all instances, without the "instancer:id" variable.
+		Gaffer::ContextPtr prototypeContext( const Gaffer::Context *parentContext ) const;
+		// Returns false if the bound of the instance prototype is known to
+		// be identical for all instances, in which case it need only be
+		// evaluated once, in prototypeContext(). The hash of the prototype
+		// bound is returned in prototypeHash.
+		bool prototypeBoundVaries( const Gaffer::Context *context, IECore::MurmurHash &prototypeHash ) const;
 
 		IECore::ConstV3fVectorDataPtr sourcePoints( const ScenePath &parentPath ) const;
 		int instanceIndex( const ScenePath &branchPath ) const;
@@ -90,7 +141,11 @@ class Instancer : public BranchCreator
 		// Fills an existing context with the fields needed for evaluating instancePlug()
 		void fillInstanceContext( Gaffer::Context *instanceContext, const ScenePath &branchPath ) const;
 		void fillInstanceContext( Gaffer::Context *instanceContext, const ScenePath &branchPath, int instanceId ) const;
-		Imath::M44f instanceTransform( const IECore::V3fVectorData *p, int instanceId ) const;
+
+		// Traverses the prototype hierarchy for encapsulated instances,
+		// gathering the objects and their transforms relative to the
+		// prototype root.
+		void prototypesWalk( Gaffer::Context *context, ScenePath &path, const Imath::M44f &parentTransform, IECore::ObjectVector *prototypes, std::vector<std::string> &names, std::vector<Imath::M44f> &transforms ) const;
 
 		static size_t g_firstPlugIndex;
 
@@ -38,6 +38,7 @@
 #define GAFFERSCENE_PREVIEW_INTERACTIVERENDER_H
 
 #include "Gaffer/Node.h"
+#include "Gaffer/BackgroundTask.h"
 
 #include "GafferScene/ScenePlug.h"
 #include "GafferScene/Private/IECoreScenePreview/Renderer.h"
@@ -56,6 +57,8 @@ namespace GafferScene
 namespace Preview
 {
 
+IE_CORE_FORWARDDECLARE( AttributesCache )
+
 class InteractiveRender : public Gaffer::Node
 {
 
@@ -107,16 +110,22 @@ class InteractiveRender : public Gaffer::Node
 		void plugDirtied( const Gaffer::Plug *plug );
 		void contextChanged( const IECore::InternedString &name );
 
+		// Performs the synchronous part of an update, launching
+		// updateInBackground() to apply any scene edits.
 		void update();
+		void updateInBackground( const Gaffer::BackgroundTask::Canceller &canceller, Gaffer::ConstContextPtr context );
+		void cancelUpdate();
 		void updateEffectiveContext();
 		void updateDefaultCamera();
 		void stop();
 
 		class SceneGraph;
+		class SceneGraphPrefetchTask;
 		class SceneGraphUpdateTask;
 
 		std::vector<boost::shared_ptr<SceneGraph> > m_sceneGraphs;
 		IECoreScenePreview::RendererPtr m_renderer;
+		AttributesCachePtr m_attributesCache;
 		State m_state;
 		unsigned m_dirtyComponents;
 		IECore::ConstCompoundObjectPtr m_globals;
@@ -128,6 +137,8 @@ class InteractiveRender : public Gaffer::Node
 		Gaffer::ContextPtr m_effectiveContext; // Context actually used for rendering
 		boost::signals::scoped_connection m_contextChangedConnection;
 
+		boost::shared_ptr<Gaffer::BackgroundTask> m_updateTask;
+
 		static size_t g_firstPlugIndex;
 
 };
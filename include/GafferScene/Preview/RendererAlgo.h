@@ -37,6 +37,8 @@
 #ifndef GAFFERSCENE_PREVIEW_RENDERERALGO_H
 #define GAFFERSCENE_PREVIEW_RENDERERALGO_H
 
+#include "tbb/concurrent_hash_map.h"
+
 #include "GafferScene/Private/IECoreScenePreview/Renderer.h"
 
 namespace GafferScene
@@ -47,15 +49,68 @@ IE_CORE_FORWARDDECLARE( ScenePlug )
 namespace Preview
 {
 
+/// Deduplicates the AttributesInterfaces created by a renderer, so that
+/// locations with identical attribute state share a single interface.
+/// Attribute blocks are identified by the hash of their contents. May
+/// be used concurrently from multiple threads.
+class AttributesCache : public IECore::RefCounted
+{
+
+	public :
+
+		AttributesCache( IECoreScenePreview::Renderer *renderer );
+		virtual ~AttributesCache();
+
+		IE_CORE_DECLAREMEMBERPTR( AttributesCache )
+
+		/// Returns the interface for the specified attributes, calling
+		/// Renderer::attributes() only if no interface exists already for
+		/// identical attributes.
+		IECoreScenePreview::Renderer::AttributesInterfacePtr get( const IECore::CompoundObject *attributes );
+		/// Removes all interfaces not referenced outside of the cache.
+		void clearUnused();
+
+	private :
+
+		struct HashCompare
+		{
+			static size_t hash( const IECore::MurmurHash &h );
+			static bool equal( const IECore::MurmurHash &h1, const IECore::MurmurHash &h2 );
+		};
+
+		typedef tbb::concurrent_hash_map<IECore::MurmurHash, IECoreScenePreview::Renderer::AttributesInterfacePtr, HashCompare> Map;
+
+		IECoreScenePreview::Renderer *m_renderer;
+		Map m_map;
+
+};
+
+IE_CORE_DECLAREPTR( AttributesCache )
+
 void outputOptions( const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer );
 void outputOptions( const IECore::CompoundObject *globals, const IECore::CompoundObject *previousGlobals, IECoreScenePreview::Renderer *renderer );
 
 void outputOutputs( const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer );
 void outputOutputs( const IECore::CompoundObject *globals, const IECore::CompoundObject *previousGlobals, IECoreScenePreview::Renderer *renderer );
 
-void outputCameras( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer );
-void outputLights( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer );
-void outputObjects( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer );
+/// Locations with identical attributes share the same AttributesInterface. If
+/// an AttributesCache is provided, interfaces will also be shared between
+/// calls, otherwise a new cache is used for each call.
+void outputCameras( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer, AttributesCache *attributesCache = NULL );
+void outputLights( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer, AttributesCache *attributesCache = NULL );
+void outputObjects( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer, AttributesCache *attributesCache = NULL );
+
+/// Limits the number of objects which outputObjects() evaluates concurrently,
+/// bounding the memory used by objects which have not yet been passed to the
+/// renderer. Defaults to the number of hardware threads.
+void setMaxObjectsInFlight( size_t maxObjectsInFlight );
+size_t getMaxObjectsInFlight();
+
+/// Outputs a single object to the renderer, expanding GafferScene::EncapsulatedInstances
+/// objects into a renderer object per instance, each sharing the same prototype
+/// object. The returned ObjectInterface may be used to transform or assign attributes
+/// to all the instances at once.
+IECoreScenePreview::Renderer::ObjectInterfacePtr outputObject( const std::string &name, const IECore::Object *object, const IECoreScenePreview::Renderer::AttributesInterface *attributes, IECoreScenePreview::Renderer *renderer );
 
 } // namespace Preview
 
@@ -81,6 +81,8 @@ class PrimitiveVariableProcessor : public SceneElementProcessor
 		virtual IECore::ConstObjectPtr computeProcessedObject( const ScenePath &path, const Gaffer::Context *context, IECore::ConstObjectPtr inputObject ) const;
 
 		/// Must be implemented by subclasses to process the primitive variable in place.
+		/// The data held by the variable is shared with inputGeometry, so it must not
+		/// be modified in place - instead, new data should be assigned to the variable.
 		virtual void processPrimitiveVariable( const ScenePath &path, const Gaffer::Context *context, IECore::ConstPrimitivePtr inputGeometry, IECore::PrimitiveVariable &inputVariable ) const = 0;
 
 	private :
@@ -0,0 +1,233 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORESCENEPREVIEW_CAPTURINGRENDERER_H
+#define IECORESCENEPREVIEW_CAPTURINGRENDERER_H
+
+#include "tbb/atomic.h"
+#include "tbb/concurrent_hash_map.h"
+#include "tbb/concurrent_vector.h"
+#include "tbb/spin_mutex.h"
+
+#include "GafferScene/Private/IECoreScenePreview/Renderer.h"
+
+namespace IECoreScenePreview
+{
+
+/// A renderer which simply captures everything it is given, storing it in
+/// memory so that it may be queried afterwards. This is useful for testing
+/// and benchmarking the output of scenes, without requiring a real renderer.
+/// Objects are captured by reference rather than by copying, so must not be
+/// modified after being passed to the renderer.
+///
+/// A "Null" renderer which discards everything is also registered, for
+/// measuring the cost of scene output without the cost of capturing.
+class CapturingRenderer : public Renderer
+{
+
+	public :
+
+		CapturingRenderer( RenderType renderType = Interactive, const std::string &fileName = "" );
+		virtual ~CapturingRenderer();
+
+		IE_CORE_DECLAREMEMBERPTR( CapturingRenderer )
+
+		class CapturedAttributes;
+		class CapturedObject;
+
+		IE_CORE_DECLAREPTR( CapturedAttributes );
+		IE_CORE_DECLAREPTR( CapturedObject );
+
+		/// Querying captured state
+		/// =======================
+
+		/// Returns the value of the option with the specified name,
+		/// or NULL if no such option has been specified.
+		const IECore::Data *capturedOption( const IECore::InternedString &name ) const;
+		/// Returns the output with the specified name, or NULL if
+		/// no such output has been specified.
+		const Output *capturedOutput( const IECore::InternedString &name ) const;
+		/// Returns the object (or light or camera) with the specified
+		/// name, or NULL if no such object exists. In Interactive mode,
+		/// objects cease to exist when their ObjectInterface is released,
+		/// although previously returned CapturedObjects remain valid.
+		CapturedObjectPtr capturedObject( const std::string &name ) const;
+		/// Returns the number of objects, lights and cameras
+		/// currently existing.
+		size_t numCapturedObjects() const;
+		/// Returns the number of calls made to attributes().
+		size_t numAttributesCalls() const;
+
+	private :
+
+		// The ObjectInterface returned to clients. It forwards edits
+		// to the CapturedObject, and removes it from the map when
+		// destroyed.
+		class ObjectHandle;
+
+	public :
+
+		/// Captured types
+		/// ==============
+
+		class CapturedAttributes : public AttributesInterface
+		{
+
+			public :
+
+				IE_CORE_DECLAREMEMBERPTR( CapturedAttributes )
+
+				const IECore::CompoundObject *attributes() const;
+
+			private :
+
+				CapturedAttributes( const IECore::CompoundObject *attributes );
+				virtual ~CapturedAttributes();
+
+				IECore::ConstCompoundObjectPtr m_attributes;
+
+				friend class CapturingRenderer;
+
+		};
+
+		/// The state captured for an object. This is distinct from the
+		/// ObjectInterface returned to the client, so that queries can
+		/// safely hold references to it while the ObjectInterface is
+		/// being released.
+		class CapturedObject : public IECore::RefCounted
+		{
+
+			public :
+
+				IE_CORE_DECLAREMEMBERPTR( CapturedObject )
+
+				const std::string &name() const;
+
+				/// The object samples, and their times. Times are empty
+				/// for objects which are not deforming.
+				const std::vector<IECore::ConstObjectPtr> &capturedSamples() const;
+				const std::vector<float> &capturedSampleTimes() const;
+
+				/// The most recently specified transform samples, and their
+				/// times. Times are empty for transforms which are not moving.
+				/// Copies are returned, since edits may be made concurrently.
+				std::vector<Imath::M44f> capturedTransforms() const;
+				std::vector<float> capturedTransformTimes() const;
+
+				/// The most recently specified attributes.
+				ConstCapturedAttributesPtr capturedAttributes() const;
+
+				/// The number of calls made to transform() and attributes()
+				/// since the object was created. These are useful for verifying
+				/// the edits made during an interactive render.
+				int numTransformEdits() const;
+				int numAttributeEdits() const;
+
+			private :
+
+				CapturedObject( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const AttributesInterface *attributes );
+				virtual ~CapturedObject();
+
+				void transform( const std::vector<Imath::M44f> &samples, const std::vector<float> &times );
+				void attributes( const AttributesInterface *attributes );
+
+				const std::string m_name;
+				const std::vector<IECore::ConstObjectPtr> m_capturedSamples;
+				const std::vector<float> m_capturedSampleTimes;
+
+				// Protects the members below, since edits may
+				// be made concurrently with queries.
+				typedef tbb::spin_mutex Mutex;
+				mutable Mutex m_mutex;
+				std::vector<Imath::M44f> m_capturedTransforms;
+				std::vector<float> m_capturedTransformTimes;
+				ConstCapturedAttributesPtr m_capturedAttributes;
+				int m_numTransformEdits;
+				int m_numAttributeEdits;
+
+				friend class CapturingRenderer;
+				friend class ObjectHandle;
+
+		};
+
+		/// Renderer interface
+		/// ==================
+
+		virtual void option( const IECore::InternedString &name, const IECore::Data *value );
+		virtual void output( const IECore::InternedString &name, const Output *output );
+
+		virtual AttributesInterfacePtr attributes( const IECore::CompoundObject *attributes );
+
+		virtual ObjectInterfacePtr camera( const std::string &name, const IECore::Camera *camera, const AttributesInterface *attributes );
+		virtual ObjectInterfacePtr light( const std::string &name, const IECore::Object *object, const AttributesInterface *attributes );
+		virtual ObjectInterfacePtr object( const std::string &name, const IECore::Object *object, const AttributesInterface *attributes );
+		virtual ObjectInterfacePtr object( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const AttributesInterface *attributes );
+
+		virtual void render();
+		virtual void pause();
+
+	private :
+
+		ObjectInterfacePtr capture( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const AttributesInterface *attributes );
+		void release( const CapturedObject *object );
+
+		RenderType m_renderType;
+
+		typedef std::map<IECore::InternedString, IECore::ConstDataPtr> OptionMap;
+		OptionMap m_options;
+		typedef std::map<IECore::InternedString, IECore::ConstDisplayPtr> OutputMap;
+		OutputMap m_outputs;
+
+		// Entries are removed by ~ObjectHandle(). Since the map holds
+		// its own reference to each CapturedObject, it is always safe
+		// for capturedObject() to return a reference to an entry.
+		typedef tbb::concurrent_hash_map<std::string, CapturedObjectPtr> ObjectMap;
+		ObjectMap m_capturedObjects;
+
+		// Used to keep objects alive in non-interactive modes.
+		tbb::concurrent_vector<ObjectInterfacePtr> m_batchObjects;
+
+		tbb::atomic<size_t> m_numAttributesCalls;
+
+		static Renderer::TypeDescription<CapturingRenderer> g_typeDescription;
+
+};
+
+IE_CORE_DECLAREPTR( CapturingRenderer )
+
+} // namespace IECoreScenePreview
+
+#endif // IECORESCENEPREVIEW_CAPTURINGRENDERER_H
@@ -212,6 +212,39 @@ class Renderer : public IECore::RefCounted
 		/// As above, but specifying a deforming object.
 		virtual ObjectInterfacePtr object( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const AttributesInterface *attributes ) = 0;
 
+		IE_CORE_FORWARDDECLARE( PrototypeInterface );
+
+		/// A handle to an object which may be instanced
+		/// any number of times using instance().
+		class PrototypeInterface : public IECore::RefCounted
+		{
+
+			public :
+
+				IE_CORE_DECLAREMEMBERPTR( PrototypeInterface )
+
+			protected :
+
+				virtual ~PrototypeInterface();
+
+		};
+
+		/// Creates a prototype from an object, so that it may be added to the
+		/// render many times using instance(). The object must not be modified
+		/// while the prototype exists.
+		///
+		/// The default implementations of prototype() and instance() simply retain
+		/// the object and pass it to object() for each instance, duplicating it.
+		/// Renderers with native support for instancing should reimplement all
+		/// three methods together to share a single object between instances.
+		virtual PrototypeInterfacePtr prototype( const IECore::Object *object );
+		/// As above, but specifying a deforming object.
+		virtual PrototypeInterfacePtr prototype( const std::vector<const IECore::Object *> &samples, const std::vector<float> &times );
+		/// Adds a named instance of a prototype to the render, with the supplied
+		/// attributes. The semantics of the returned ObjectInterface are as for
+		/// object().
+		virtual ObjectInterfacePtr instance( const std::string &name, const PrototypeInterface *prototype, const AttributesInterface *attributes );
+
 		/// Performs the render - should be called after the
 		/// entire scene has been specified using the methods
 		/// above. Batch and SceneDescripton renders will have
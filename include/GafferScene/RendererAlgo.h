@@ -112,6 +112,11 @@ void outputTransform( const ScenePlug *scene, IECore::Renderer *renderer, size_t
 /// object types cannot be interpolated anyway.
 void objectSamples( const ScenePlug *scene, size_t segments, const Imath::V2f &shutter, std::vector<IECore::ConstVisibleRenderablePtr> &samples, std::set<float> &sampleTimes );
 
+/// Returns a hash which uniquely identifies the samples that objectSamples() would generate
+/// for the same arguments. This is computed from the hashes of the objects alone, so is
+/// considerably cheaper than generating the samples themselves.
+IECore::MurmurHash objectSamplesHash( const ScenePlug *scene, size_t segments, const Imath::V2f &shutter );
+
 /// Outputs the object for the current location, using objectSamples() to generate the samples.
 void outputObject( const ScenePlug *scene, IECore::Renderer *renderer, size_t segments = 0, const Imath::V2f &shutter = Imath::V2i( 0 ) );
 
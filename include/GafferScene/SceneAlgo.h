@@ -51,6 +51,13 @@ IE_CORE_FORWARDDECLARE( CompoundData )
 
 } // namespace IECore
 
+namespace Gaffer
+{
+
+IE_CORE_FORWARDDECLARE( Context )
+
+} // namespace Gaffer
+
 namespace GafferScene
 {
 
@@ -75,6 +82,35 @@ void matchingPaths( const Gaffer::IntPlug *filterPlug, const ScenePlug *scene, P
 /// As above, but specifying the filter as a PathMatcher.
 void matchingPaths( const PathMatcher &filter, const ScenePlug *scene, PathMatcher &paths );
 
+/// Invokes the Functor at every location in the scene,
+/// visiting parent locations before their children, but
+/// otherwise processing locations in parallel as much
+/// as possible. Sibling locations are processed in batches,
+/// so traversal overhead remains low even for locations
+/// with very large numbers of children.
+///
+/// Functor should be of the following form.
+///
+/// ```
+/// struct Functor
+/// {
+///
+///     /// Called to construct a new functor to be used at
+///     /// each child location. This allows state to be
+///     /// accumulated as the scene is traversed, with each
+///     /// parent passing its state to its children.
+///     Functor( const Functor &parent );
+///
+///     /// Called to process a specific location. May return
+///     /// false to prune the traversal, or true to continue
+///     /// to the children.
+///     bool operator()( const ScenePlug *scene, const ScenePlug::ScenePath &path );
+///
+/// };
+/// ```
+template <class Functor>
+void parallelProcessLocations( const ScenePlug *scene, Functor &f );
+
 /// Calls a functor on all paths in the scene
 /// The functor must take ( const ScenePlug*, const ScenePlug::ScenePath& ), and can return false to prune traversal
 template <class ThreadableFunctor>
@@ -102,6 +138,17 @@ Imath::V2f shutter( const IECore::CompoundObject *globals );
 /// location if motionBlur is true.
 IECore::TransformPtr transform( const ScenePlug *scene, const ScenePlug::ScenePath &path, const Imath::V2f &shutter, bool motionBlur );
 
+/// Samples the local transform for the specified location at each of the specified
+/// times, filling samples with one matrix per time. The samples are hashed and computed
+/// in parallel, and samples whose hash matches that of another are computed only once.
+/// Returns true if the hashes indicate that the transform varies over the sample times,
+/// and false if it is static.
+bool sampleTransform( const ScenePlug *scene, const ScenePlug::ScenePath &path, const std::vector<float> &sampleTimes, std::vector<Imath::M44f> &samples );
+/// As above, but sampling the full (world space) transform.
+bool sampleFullTransform( const ScenePlug *scene, const ScenePlug::ScenePath &path, const std::vector<float> &sampleTimes, std::vector<Imath::M44f> &samples );
+/// As above, but sampling the object.
+bool sampleObject( const ScenePlug *scene, const ScenePlug::ScenePath &path, const std::vector<float> &sampleTimes, std::vector<IECore::ConstObjectPtr> &samples );
+
 /// Returns the primary render camera, with all globals settings such as
 /// crop, resolution, overscan etc applied as they would be for rendering.
 /// The globals may be passed if they are available, if not they will be computed.
@@ -119,6 +166,39 @@ bool setExists( const ScenePlug *scene, const IECore::InternedString &setName );
 /// computations in parallel for improved performance.
 IECore::ConstCompoundDataPtr sets( const ScenePlug *scene );
 
+/// Computes statistics for the scene using a parallel traversal with
+/// per-thread accumulators. The result contains the following members :
+///
+/// - "locations" : The number of locations, including the root (UInt64Data).
+/// - "maxDepth" : The depth of the deepest location, where the root has depth 0 (IntData).
+/// - "objects" : A CompoundData for each type of object, containing "count", "primitives",
+///   "vertices" and "memory" (UInt64Data). Primitives are counted as uniform elements
+///   (faces for meshes, curves for curves), and memory counts each unique object only once.
+/// - "sets" : The number of paths in each set (UInt64Data).
+IECore::CompoundDataPtr sceneStats( const ScenePlug *scene );
+
+/// Compares two scenes, traversing them in parallel. Subtrees with matching
+/// ScenePlug::hierarchyHash() values are pruned without their values being
+/// fetched, so the cost of a comparison is proportional to the size of the
+/// difference rather than the size of the scenes. Where hashes differ, values
+/// are compared to confirm that a change has occurred. The result contains the
+/// following members :
+///
+/// - "added" : The locations present only in scene2 (PathMatcherData). Only the
+///   root of each added subtree is listed.
+/// - "removed" : The locations present only in scene1 (PathMatcherData). Only the
+///   root of each removed subtree is listed.
+/// - "changed" : A PathMatcherData for each of "bound", "transform", "attributes"
+///   and "object", listing the locations present in both scenes at which that
+///   property differs.
+/// - "globals" : True if the globals differ (BoolData).
+/// - "sets" : The names of the sets which differ, including sets present in only
+///   one of the scenes (InternedStringVectorData).
+IECore::CompoundDataPtr sceneDiff( const ScenePlug *scene1, const ScenePlug *scene2 );
+/// As above, but evaluating each scene in its own context. This allows
+/// scenes from different scripts, or from different frames, to be compared.
+IECore::CompoundDataPtr sceneDiff( const ScenePlug *scene1, const Gaffer::Context *context1, const ScenePlug *scene2, const Gaffer::Context *context2 );
+
 /// Returns a bounding box for the specified object. Typically
 /// this is provided by the VisibleRenderable::bound() method, but
 /// for other object types we must return a synthetic bound.
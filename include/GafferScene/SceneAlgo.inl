@@ -34,7 +34,8 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
-#include "tbb/task.h"
+#include "tbb/parallel_for.h"
+
 #include "Gaffer/Context.h"
 
 namespace GafferScene
@@ -43,69 +44,122 @@ namespace GafferScene
 namespace Detail
 {
 
-template <class ThreadableFunctor>
-class TraverseTask : public tbb::task
+template<class Functor>
+void processLocation( const GafferScene::ScenePlug *scene, const Gaffer::Context *baseContext, Gaffer::Context *context, ScenePlug::ScenePath &path, const IECore::MurmurHash &pathHash, Functor &f );
+
+// Body for a `tbb::parallel_for()` over a range of sibling locations.
+// Each subrange reuses a single context and path, updating them in place
+// for each location, so that the cost of setting up the traversal is
+// amortised over many siblings rather than being paid per location.
+// Path hashes are derived incrementally from the parent's hash, as
+// documented in `Context::hash()`, so deep paths needn't be rehashed.
+template<class Functor>
+class ChildLocationsBody
 {
 
 	public :
 
-		TraverseTask(
+		ChildLocationsBody(
 			const GafferScene::ScenePlug *scene,
-			const Gaffer::Context *context,
-			ThreadableFunctor &f
+			const Gaffer::Context *baseContext,
+			const ScenePlug::ScenePath &parentPath,
+			const IECore::MurmurHash &parentPathHash,
+			const std::vector<IECore::InternedString> &childNames,
+			const Functor &parentFunctor
 		)
-			:	m_scene( scene ), m_context( context ), m_f( f )
-		{
-		}
-
-		virtual ~TraverseTask()
+			:	m_scene( scene ), m_baseContext( baseContext ), m_parentPath( parentPath ), m_parentPathHash( parentPathHash ), m_childNames( childNames ), m_parentFunctor( parentFunctor )
 		{
 		}
 
-		virtual task *execute()
+		void operator()( const tbb::blocked_range<size_t> &r ) const
 		{
-
-			Gaffer::ContextPtr context = new Gaffer::Context( *m_context, Gaffer::Context::Borrowed );
-			context->set( ScenePlug::scenePathContextName, m_path );
+			Gaffer::ContextPtr context = new Gaffer::Context( *m_baseContext, Gaffer::Context::Borrowed );
 			Gaffer::Context::Scope scopedContext( context.get() );
 
-			if( m_f( m_scene, m_path ) )
+			ScenePlug::ScenePath path;
+			path.reserve( m_parentPath.size() + 8 );
+			path.insert( path.end(), m_parentPath.begin(), m_parentPath.end() );
+			path.push_back( IECore::InternedString() ); // space for the child name
+
+			for( size_t i = r.begin(); i != r.end(); ++i )
 			{
-				IECore::ConstInternedStringVectorDataPtr childNamesData = m_scene->childNamesPlug()->getValue();
-				const std::vector<IECore::InternedString> &childNames = childNamesData->readable();
-
-				set_ref_count( 1 + childNames.size() );
-
-				ScenePlug::ScenePath childPath = m_path;
-				childPath.push_back( IECore::InternedString() ); // space for the child name
-				for( std::vector<IECore::InternedString>::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; it++ )
-				{
-					childPath[m_path.size()] = *it;
-					TraverseTask *t = new( allocate_child() ) TraverseTask( *this, childPath );
-					spawn( *t );
-				}
-				wait_for_all();
+				path.back() = m_childNames[i];
+				IECore::MurmurHash pathHash( m_parentPathHash );
+				pathHash.append( path.back().string() );
+				Functor childFunctor( m_parentFunctor );
+				processLocation( m_scene, m_baseContext, context.get(), path, pathHash, childFunctor );
 			}
-
-			return NULL;
 		}
 
-	protected :
+	private :
 
-		TraverseTask( const TraverseTask &other, const ScenePlug::ScenePath &path )
-			:	m_scene( other.m_scene ),
-				m_context( other.m_context ),
-				m_f( other.m_f ),
-				m_path( path )
-		{
-		}
+		const GafferScene::ScenePlug *m_scene;
+		const Gaffer::Context *m_baseContext;
+		const ScenePlug::ScenePath &m_parentPath;
+		const IECore::MurmurHash &m_parentPathHash;
+		const std::vector<IECore::InternedString> &m_childNames;
+		const Functor &m_parentFunctor;
+
+};
+
+// Processes the location specified by `path`, which must also be
+// the current context, and then processes its children. `path` is
+// modified during traversal, but is restored before returning.
+template<class Functor>
+void processLocation( const GafferScene::ScenePlug *scene, const Gaffer::Context *baseContext, Gaffer::Context *context, ScenePlug::ScenePath &path, const IECore::MurmurHash &pathHash, Functor &f )
+{
+	context->set( ScenePlug::scenePathContextName, path, pathHash );
+	if( !f( scene, path ) )
+	{
+		return;
+	}
+
+	IECore::ConstInternedStringVectorDataPtr childNamesData = scene->childNamesPlug()->getValue();
+	const std::vector<IECore::InternedString> &childNames = childNamesData->readable();
+	if( childNames.empty() )
+	{
+		return;
+	}
+	else if( childNames.size() == 1 )
+	{
+		// Nothing to be gained by going parallel, so we just
+		// continue on this thread, reusing the current context
+		// and path.
+		path.push_back( childNames[0] );
+		IECore::MurmurHash childPathHash( pathHash );
+		childPathHash.append( childNames[0].string() );
+		Functor childFunctor( f );
+		processLocation( scene, baseContext, context, path, childPathHash, childFunctor );
+		path.pop_back();
+	}
+	else
+	{
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, childNames.size() ),
+			ChildLocationsBody<Functor>( scene, baseContext, path, pathHash, childNames, f )
+		);
+	}
+}
+
+// Adaptor allowing a single ThreadableFunctor to be shared
+// by all locations visited by `parallelProcessLocations()`.
+template<class ThreadableFunctor>
+struct TraverseFunctor
+{
+
+	TraverseFunctor( ThreadableFunctor &f )
+		:	m_f( f )
+	{
+	}
+
+	bool operator()( const GafferScene::ScenePlug *scene, const GafferScene::ScenePlug::ScenePath &path )
+	{
+		return m_f( scene, path );
+	}
 
 	private :
 
-		const GafferScene::ScenePlug *m_scene;
-		const Gaffer::Context *m_context;
 		ThreadableFunctor &m_f;
-		GafferScene::ScenePlug::ScenePath m_path;
 
 };
 
@@ -165,13 +219,24 @@ struct PathMatcherFunctor
 
 } // namespace Detail
 
-template <class ThreadableFunctor>
-void parallelTraverse( const GafferScene::ScenePlug *scene, ThreadableFunctor &f )
+template <class Functor>
+void parallelProcessLocations( const GafferScene::ScenePlug *scene, Functor &f )
 {
 	Gaffer::ContextPtr c = new Gaffer::Context( *Gaffer::Context::current(), Gaffer::Context::Borrowed );
 	GafferScene::Filter::setInputScene( c.get(), scene );
-	Detail::TraverseTask<ThreadableFunctor> *task = new( tbb::task::allocate_root() ) Detail::TraverseTask<ThreadableFunctor>( scene, c.get(), f );
-	tbb::task::spawn_root_and_wait( *task );
+
+	Gaffer::ContextPtr context = new Gaffer::Context( *c, Gaffer::Context::Borrowed );
+	Gaffer::Context::Scope scopedContext( context.get() );
+
+	ScenePlug::ScenePath path;
+	Detail::processLocation( scene, c.get(), context.get(), path, IECore::MurmurHash(), f );
+}
+
+template <class ThreadableFunctor>
+void parallelTraverse( const GafferScene::ScenePlug *scene, ThreadableFunctor &f )
+{
+	Detail::TraverseFunctor<ThreadableFunctor> tf( f );
+	parallelProcessLocations( scene, tf );
 }
 
 template <class ThreadableFunctor>
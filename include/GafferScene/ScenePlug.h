@@ -38,6 +38,8 @@
 #ifndef GAFFER_SCENEPLUG_H
 #define GAFFER_SCENEPLUG_H
 
+#include "tbb/atomic.h"
+
 #include "Gaffer/TypedObjectPlug.h"
 #include "Gaffer/TypedPlug.h"
 #include "Gaffer/BoxPlug.h"
@@ -163,6 +165,18 @@ class ScenePlug : public Gaffer::ValuePlug
 		IECore::MurmurHash fullAttributesHash( const ScenePath &scenePath ) const;
 		IECore::MurmurHash objectHash( const ScenePath &scenePath ) const;
 		IECore::MurmurHash childNamesHash( const ScenePath &scenePath ) const;
+		/// Returns a hash representing the entire subtree below the specified
+		/// location, combining the bound, transform, attributes, object and
+		/// child names hashes of every location within it. Children are hashed
+		/// in parallel, and results are cached per location so that repeated
+		/// queries of an unchanged scene are cheap. Any edit upstream of this
+		/// plug invalidates all its cached results, so the next query revisits
+		/// the entire subtree, although the individual plug hashes may still
+		/// be retrieved from the ValuePlug hash cache. Edits elsewhere do not
+		/// affect the cached results. Two locations with equal hierarchy hashes
+		/// have identical contents, so this may be used to prune comparisons
+		/// and scene traversals.
+		IECore::MurmurHash hierarchyHash( const ScenePath &scenePath ) const;
 		/// See comments for `globals()` method.
 		IECore::MurmurHash globalsHash() const;
 		/// See comments for `setNames()` method.
@@ -176,6 +190,19 @@ class ScenePlug : public Gaffer::ValuePlug
 		static void stringToPath( const std::string &s, ScenePlug::ScenePath &path );
 		static void pathToString( const ScenePlug::ScenePath &path, std::string &s );
 
+	protected :
+
+		/// Reimplemented to invalidate the cache used by hierarchyHash().
+		virtual void dirty();
+
+	private :
+
+		// Identifies the current state of the plug in the hierarchy
+		// hash cache. This is assigned a new globally unique value
+		// each time the plug is dirtied. It is atomic because it is
+		// read by hierarchyHash() on arbitrary threads.
+		tbb::atomic<uint64_t> m_hierarchyHashGeneration;
+
 };
 
 IE_CORE_DECLAREPTR( ScenePlug );
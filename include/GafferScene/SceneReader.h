@@ -37,9 +37,8 @@
 #ifndef GAFFERSCENE_SCENEREADER_H
 #define GAFFERSCENE_SCENEREADER_H
 
-#include "tbb/enumerable_thread_specific.h"
-
 #include "IECore/SceneInterface.h"
+#include "IECore/CompoundData.h"
 
 #include "GafferScene/SceneNode.h"
 
@@ -80,6 +79,10 @@ class SceneReader : public SceneNode
 
 	protected :
 
+		/// Implemented for setsPlug().
+		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+
 		/// \todo These methods defer to SceneInterface::hash() to do most of the work, but we could go further.
 		/// Currently we still hash in fileNamePlug() and refreshCountPlug() because we don't trust the current
 		/// implementation of SceneCache::hash() - it should hash the filename and modification time, but instead
@@ -107,23 +110,20 @@ class SceneReader : public SceneNode
 
 		void plugSet( Gaffer::Plug *plug );
 
-		// The typical access patterns for the SceneReader include accessing
-		// the same file repeatedly, and also the same path within the file
-		// repeatedly (to hash a value then compute it for instance, or to get
-		// the bound and then the object). We take advantage of that by storing
-		// the last accessed scene in thread local storage - we can then avoid
-		// the relatively expensive lookups necessary to find the appropriate
-		// SceneInterfacePtr for a query.
-		struct LastScene
-		{
-			std::string fileName;
-			IECore::ConstSceneInterfacePtr fileNameScene;
-			ScenePlug::ScenePath path;
-			IECore::ConstSceneInterfacePtr pathScene;
-		};
-		mutable tbb::enumerable_thread_specific<LastScene> m_lastScene;
+		// Stores a CompoundData mapping from set name to PathMatcherData
+		// for every tag in the file. This is loaded in a single parallel
+		// pass over the file, and computeSet() simply picks the required
+		// set out of it.
+		Gaffer::ObjectPlug *setsPlug();
+		const Gaffer::ObjectPlug *setsPlug() const;
+		IECore::ConstCompoundDataPtr loadSets() const;
+
 		// Returns the SceneInterface for the current filename (in the current Context)
-		// and specified path, using m_lastScene to accelerate the lookups.
+		// and specified path. Handles are cached in a bounded cache shared between all
+		// SceneReaders, keyed by filename and path, and child handles are resolved from
+		// the cached handles of their parents. This makes the lookup cost independent
+		// of the depth of the location, even when a parallel traversal interleaves
+		// queries for many different locations.
 		IECore::ConstSceneInterfacePtr scene( const ScenePath &path ) const;
 
 		static const double g_frameRate;
@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef GAFFERSCENE_SCENESTATS_H
+#define GAFFERSCENE_SCENESTATS_H
+
+#include "Gaffer/ComputeNode.h"
+#include "Gaffer/TypedObjectPlug.h"
+
+#include "GafferScene/ScenePlug.h"
+
+namespace GafferScene
+{
+
+/// Provides statistics about a scene - the number of locations, the
+/// number of objects, primitives and vertices of each type, the memory
+/// used by the objects, and the sizes of the sets. See `sceneStats()`
+/// in SceneAlgo.h for details of the output.
+class SceneStats : public Gaffer::ComputeNode
+{
+
+	public :
+
+		SceneStats( const std::string &name=defaultName<SceneStats>() );
+		virtual ~SceneStats();
+
+		IE_CORE_DECLARERUNTIMETYPEDEXTENSION( GafferScene::SceneStats, SceneStatsTypeId, Gaffer::ComputeNode );
+
+		ScenePlug *inPlug();
+		const ScenePlug *inPlug() const;
+
+		Gaffer::AtomicCompoundDataPlug *statsPlug();
+		const Gaffer::AtomicCompoundDataPlug *statsPlug() const;
+
+		virtual void affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const;
+
+	protected :
+
+		/// Implemented to hash the object and child names at every location
+		/// in the scene, along with the sets. Hashing is much cheaper than
+		/// computing the statistics, but it still requires a full traversal
+		/// of the scene.
+		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+
+	private :
+
+		static size_t g_firstPlugIndex;
+
+};
+
+IE_CORE_DECLAREPTR( SceneStats );
+
+} // namespace GafferScene
+
+#endif // GAFFERSCENE_SCENESTATS_H
@@ -72,17 +72,29 @@ class SceneWriter : public GafferDispatch::TaskNode
 
 		virtual void execute() const;
 
-		/// Re-implemented to open the file for writing, then iterate through the
-		/// frames, modifying the current Context and calling writeLocation().
+		/// Re-implemented to open the file for writing, then write the scene
+		/// for each frame. Several frames are evaluated concurrently, and the
+		/// locations for each are computed in parallel, ahead of a single thread
+		/// which writes them to the file in order.
 		virtual void executeSequence( const std::vector<float> &frames ) const;
 
 		/// Re-implemented to return true, since the entire file must be written at once.
 		virtual bool requiresSequenceExecution() const;
 
+		/// Limits the number of locations which may have been computed but
+		/// not yet written to the file, thereby bounding the memory used
+		/// while writing.
+		static void setMaxLocationsInFlight( size_t maxLocationsInFlight );
+		static size_t getMaxLocationsInFlight();
+
+		/// Limits the number of frames which are evaluated concurrently
+		/// by executeSequence().
+		static void setMaxFramesInFlight( size_t maxFramesInFlight );
+		static size_t getMaxFramesInFlight();
+
 	private :
 
 		void createDirectories( const std::string &fileName ) const;
-		void writeLocation( const GafferScene::ScenePlug *scene, const ScenePlug::ScenePath &scenePath, Gaffer::Context *context, IECore::SceneInterface *output, double time ) const;
 
 		static size_t g_firstPlugIndex;
 
@@ -62,6 +62,9 @@ class Seeds : public BranchCreator
 		Gaffer::StringPlug *pointTypePlug();
 		const Gaffer::StringPlug *pointTypePlug() const;
 
+		Gaffer::StringPlug *densityPrimitiveVariablePlug();
+		const Gaffer::StringPlug *densityPrimitiveVariablePlug() const;
+
 		virtual void affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const;
 
 	protected :
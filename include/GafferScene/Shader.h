@@ -43,8 +43,9 @@
 #include "IECore/ObjectVector.h"
 #include "IECore/Shader.h"
 
-#include "Gaffer/DependencyNode.h"
+#include "Gaffer/ComputeNode.h"
 #include "Gaffer/TypedPlug.h"
+#include "Gaffer/TypedObjectPlug.h"
 #include "Gaffer/CompoundNumericPlug.h"
 
 #include "GafferScene/TypeIds.h"
@@ -59,7 +60,7 @@ IE_CORE_FORWARDDECLARE( StringPlug )
 namespace GafferScene
 {
 
-class Shader : public Gaffer::DependencyNode
+class Shader : public Gaffer::ComputeNode
 {
 
 	public :
@@ -67,7 +68,7 @@ class Shader : public Gaffer::DependencyNode
 		Shader( const std::string &name=defaultName<Shader>() );
 		virtual ~Shader();
 
-		IE_CORE_DECLARERUNTIMETYPEDEXTENSION( GafferScene::Shader, ShaderTypeId, Gaffer::DependencyNode );
+		IE_CORE_DECLARERUNTIMETYPEDEXTENSION( GafferScene::Shader, ShaderTypeId, Gaffer::ComputeNode );
 
 		/// A plug defining the name of the shader.
 		Gaffer::StringPlug *namePlug();
@@ -106,11 +107,18 @@ class Shader : public Gaffer::DependencyNode
 		IECore::MurmurHash stateHash() const;
 		void stateHash( IECore::MurmurHash &h ) const;
 		/// Returns a series of IECore::StateRenderables suitable for specifying this
-		/// shader (and it's inputs) to an IECore::Renderer.
+		/// shader (and it's inputs) to an IECore::Renderer. The network is computed
+		/// via an internal output plug, so repeated calls retrieve the state from
+		/// the cache rather than rebuilding it. The "scene:path" context variable
+		/// is removed before evaluation, so the state is shared by all locations.
+		/// The result is shared with the cache and must not be modified.
 		IECore::ConstObjectVectorPtr state() const;
 
 	protected :
 
+		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+
 		class NetworkBuilder
 		{
 
@@ -184,6 +192,9 @@ class Shader : public Gaffer::DependencyNode
 		// during compute.
 		Gaffer::Color3fPlug *nodeColorPlug();
 		const Gaffer::Color3fPlug *nodeColorPlug() const;
+		// Output plug used to compute and cache the result of state().
+		Gaffer::ObjectVectorPlug *statePlug();
+		const Gaffer::ObjectVectorPlug *statePlug() const;
 
 		static size_t g_firstPlugIndex;
 
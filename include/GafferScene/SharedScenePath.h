@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef GAFFERSCENE_SHAREDSCENEPATH_H
+#define GAFFERSCENE_SHAREDSCENEPATH_H
+
+#include "tbb/atomic.h"
+
+#include "IECore/RefCounted.h"
+#include "IECore/MurmurHash.h"
+#include "IECore/VectorTypedData.h"
+
+#include "GafferScene/ScenePlug.h"
+
+namespace GafferScene
+{
+
+/// An immutable, reference counted representation of a location in a scene.
+/// Each SharedScenePath references its parent rather than storing a copy of
+/// it, so making a child path costs a single small allocation regardless of
+/// depth, and its hash is computed incrementally from the parent's when it is
+/// constructed. This makes it suitable for representing locations during deep
+/// traversals, and for storing large numbers of paths with common prefixes.
+///
+/// For compatibility with ScenePlug::ScenePath, the path can be retrieved in
+/// vector form via `data()`. This is computed on first use and cached, and
+/// may be shared with a Context as the value for `scene:path`. Because `hash()`
+/// is computed in the same way as the Context hashes paths, it may be passed
+/// too, avoiding both the copy and the rehashing that would otherwise be made :
+///
+/// ```
+/// context->set( ScenePlug::scenePathContextName, path->data(), Context::Shared, path->hash() );
+/// ```
+class SharedScenePath : public IECore::RefCounted
+{
+
+	public :
+
+		/// Constructs the root path.
+		SharedScenePath();
+		/// Constructs the child of parent with the specified name.
+		SharedScenePath( const SharedScenePath *parent, const IECore::InternedString &name );
+		virtual ~SharedScenePath();
+
+		IE_CORE_DECLAREMEMBERPTR( SharedScenePath )
+
+		/// Returns the parent path, or NULL for the root.
+		const SharedScenePath *parent() const;
+		/// Returns the name of the last element in the path,
+		/// or an empty string for the root.
+		const IECore::InternedString &name() const;
+		/// Returns the number of elements in the path.
+		size_t size() const;
+
+		/// Returns a hash uniquely identifying the path. This matches the
+		/// hash used for the path by `Gaffer::Context::hash()`.
+		const IECore::MurmurHash &hash() const;
+
+		bool operator == ( const SharedScenePath &other ) const;
+		bool operator != ( const SharedScenePath &other ) const;
+
+		/// Returns the path in the vector form used by ScenePlug.
+		/// This is safe to call concurrently from multiple threads.
+		const IECore::InternedStringVectorData *data() const;
+		/// Convenience returning `data()->readable()`.
+		const ScenePlug::ScenePath &names() const;
+
+	private :
+
+		ConstPtr m_parent;
+		IECore::InternedString m_name;
+		size_t m_size;
+		IECore::MurmurHash m_hash;
+		mutable tbb::atomic<IECore::InternedStringVectorData *> m_data;
+
+};
+
+IE_CORE_DECLAREPTR( SharedScenePath )
+
+} // namespace GafferScene
+
+#endif // GAFFERSCENE_SHAREDSCENEPATH_H
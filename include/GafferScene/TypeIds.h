@@ -128,6 +128,8 @@ enum TypeId
 	AttributeVisualiserTypeId = 110583,
 	SceneLoopTypeId = 110584,
 	RenderTypeId = 110585,
+	EncapsulatedInstancesTypeId = 110586,
+	SceneStatsTypeId = 110587,
 
 	PreviewInteractiveRenderTypeId = 110649,
 
@@ -37,10 +37,16 @@
 #ifndef GAFFERSCENETEST_SCENEPLUGTEST_H
 #define GAFFERSCENETEST_SCENEPLUGTEST_H
 
+#include "GafferScene/ScenePlug.h"
+
 namespace GafferSceneTest
 {
 
 void testManyStringToPathCalls();
+void testSharedScenePath();
+/// Traverses the scene, asserting that the context hash for each location
+/// matches the hash of an equivalent context built from scratch.
+void testTraversalContextHash( const GafferScene::ScenePlug *scene );
 
 } // namespace GafferSceneTest
 
@@ -38,6 +38,7 @@
 import os
 import shutil
 import unittest
+import threading
 
 import IECore
 import IECoreAlembic
@@ -112,6 +113,54 @@ class AlembicSourceTest( GafferSceneTest.SceneTestCase ) :
 		self.assertEqual( a["out"].fullTransform( "/group1/pCube1" ), IECore.M44f.createTranslated( IECore.V3f( -1, 0, 0 ) )  * a["out"].fullTransform( "/group1" ) )
 		self.assertEqual( a["out"].fullTransform( "/group1/pCube1/pCubeShape1" ), a["out"].fullTransform( "/group1/pCube1" ) )
 
+	def testConcurrentReads( self ) :
+
+		a = GafferScene.AlembicSource()
+		a["fileName"].setValue( os.path.dirname( __file__ ) + "/alembicFiles/animatedCube.abc" )
+
+		# Evaluate many frames from many threads at once, leasing
+		# archives from the pool concurrently, and check the results
+		# match a serial evaluation.
+
+		times = [ t / 24.0 for t in range( 1, 50 ) ]
+
+		def computeTransform( time ) :
+			c = Gaffer.Context()
+			c.setTime( time )
+			with c :
+				return a["out"].fullTransform( "/pCube1/pCubeShape1" )
+
+		expected = [ computeTransform( time ) for time in times ]
+
+		a["refreshCount"].setValue( a["refreshCount"].getValue() + 1 )
+
+		results = {}
+		exceptions = []
+		def reader( time ) :
+
+			try :
+				c = Gaffer.Context()
+				c.setTime( time )
+				with c :
+					GafferSceneTest.traverseScene( a["out"] )
+				results[time] = computeTransform( time )
+			except Exception, e :
+				exceptions.append( e )
+
+		threads = []
+		for time in times :
+			thread = threading.Thread( target = reader, args = ( time, ) )
+			threads.append( thread )
+			thread.start()
+
+		for thread in threads :
+			thread.join()
+
+		for e in exceptions :
+			raise e
+
+		self.assertEqual( [ results[time] for time in times ], expected )
+
 	def testRefresh( self ) :
 
 		fileName = self.temporaryDirectory() + "/refreshTest.abc"
@@ -0,0 +1,234 @@
+##########################################################################
+#
+#  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#      * Redistributions of source code must retain the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer.
+#
+#      * Redistributions in binary form must reproduce the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer in the documentation and/or other materials provided with
+#        the distribution.
+#
+#      * Neither the name of John Haddon nor the names of
+#        any other contributors to this software may be used to endorse or
+#        promote products derived from this software without specific prior
+#        written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import unittest
+
+import IECore
+
+import Gaffer
+import GafferTest
+import GafferScene
+import GafferSceneTest
+
+class CapturingRendererTest( GafferSceneTest.SceneTestCase ) :
+
+	def testTypes( self ) :
+
+		self.assertTrue( "Capturing" in GafferScene.Private.IECoreScenePreview.Renderer.types() )
+		self.assertTrue( "Null" in GafferScene.Private.IECoreScenePreview.Renderer.types() )
+
+	def testCapture( self ) :
+
+		renderer = GafferScene.Private.IECoreScenePreview.CapturingRenderer()
+
+		renderer.option( "test", IECore.IntData( 10 ) )
+		self.assertEqual( renderer.capturedOption( "test" ), IECore.IntData( 10 ) )
+		renderer.option( "test", None )
+		self.assertEqual( renderer.capturedOption( "test" ), None )
+
+		attributes = renderer.attributes( IECore.CompoundObject( { "a" : IECore.IntData( 1 ) } ) )
+		self.assertEqual( renderer.numAttributesCalls(), 1 )
+
+		sphere = IECore.SpherePrimitive()
+		o = renderer.object( "/sphere", sphere, attributes )
+		o.transform( IECore.M44f.createTranslated( IECore.V3f( 1, 2, 3 ) ) )
+
+		c = renderer.capturedObject( "/sphere" )
+		self.assertEqual( c.name(), "/sphere" )
+		self.assertEqual( c.capturedSamples(), [ sphere ] )
+		self.assertEqual( c.capturedSampleTimes(), [] )
+		self.assertEqual( c.capturedTransforms(), [ IECore.M44f.createTranslated( IECore.V3f( 1, 2, 3 ) ) ] )
+		self.assertEqual( c.capturedAttributes().attributes(), IECore.CompoundObject( { "a" : IECore.IntData( 1 ) } ) )
+		self.assertEqual( c.numTransformEdits(), 1 )
+		self.assertEqual( c.numAttributeEdits(), 0 )
+		self.assertEqual( renderer.numCapturedObjects(), 1 )
+
+		attributes2 = renderer.attributes( IECore.CompoundObject( { "a" : IECore.IntData( 2 ) } ) )
+		o.attributes( attributes2 )
+		self.assertEqual( c.numAttributeEdits(), 1 )
+		self.assertEqual( c.capturedAttributes().attributes(), IECore.CompoundObject( { "a" : IECore.IntData( 2 ) } ) )
+
+		# Releasing the object removes it from an interactive render,
+		# even while we still hold a reference to the captured object.
+
+		del o
+		self.assertEqual( renderer.capturedObject( "/sphere" ), None )
+		self.assertEqual( renderer.numCapturedObjects(), 0 )
+		self.assertEqual( c.name(), "/sphere" )
+		self.assertEqual( c.numAttributeEdits(), 1 )
+
+	def testBatchObjectsPersist( self ) :
+
+		renderer = GafferScene.Private.IECoreScenePreview.CapturingRenderer( GafferScene.Private.IECoreScenePreview.Renderer.RenderType.Batch )
+		attributes = renderer.attributes( IECore.CompoundObject() )
+		renderer.object( "/sphere", IECore.SpherePrimitive(), attributes )
+
+		self.assertTrue( renderer.capturedObject( "/sphere" ) is not None )
+		self.assertEqual( renderer.numCapturedObjects(), 1 )
+
+	def testOutputObjects( self ) :
+
+		sphere = GafferScene.Sphere()
+		sphere["transform"]["translate"].setValue( IECore.V3f( 1, 0, 0 ) )
+
+		duplicate = GafferScene.Duplicate()
+		duplicate["in"].setInput( sphere["out"] )
+		duplicate["target"].setValue( "/sphere" )
+		duplicate["copies"].setValue( 100 )
+
+		renderer = GafferScene.Private.IECoreScenePreview.CapturingRenderer( GafferScene.Private.IECoreScenePreview.Renderer.RenderType.Batch )
+		GafferScene.Preview.outputObjects( duplicate["out"], duplicate["out"]["globals"].getValue(), renderer )
+
+		self.assertEqual( renderer.numCapturedObjects(), 101 )
+		attributes = renderer.capturedObject( "/sphere" ).capturedAttributes()
+		for name in [ "sphere" ] + [ "sphere%d" % i for i in range( 1, 101 ) ] :
+			o = renderer.capturedObject( "/" + name )
+			self.assertEqual( o.capturedSamples(), [ sphere["out"].object( "/sphere" ) ] )
+			self.assertEqual( o.capturedTransforms(), [ duplicate["out"].fullTransform( "/" + name ) ] )
+			# All locations have identical attributes, so should
+			# share a single attributes block. Threads may race to
+			# create it, but only one block may ever be used.
+			self.assertTrue( o.capturedAttributes().isSame( attributes ) )
+
+	def testMaxObjectsInFlight( self ) :
+
+		sphere = GafferScene.Sphere()
+
+		group = GafferScene.Group()
+		group["in"][0].setInput( sphere["out"] )
+
+		duplicate = GafferScene.Duplicate()
+		duplicate["in"].setInput( group["out"] )
+		duplicate["target"].setValue( "/group" )
+		duplicate["copies"].setValue( 20 )
+
+		hiddenFilter = GafferScene.PathFilter()
+		hiddenFilter["paths"].setValue( IECore.StringVectorData( [ "/group3" ] ) )
+
+		hidden = GafferScene.StandardAttributes()
+		hidden["in"].setInput( duplicate["out"] )
+		hidden["filter"].setInput( hiddenFilter["out"] )
+		hidden["attributes"]["visibility"]["enabled"].setValue( True )
+		hidden["attributes"]["visibility"]["value"].setValue( False )
+
+		originalMaxObjectsInFlight = GafferScene.Preview.getMaxObjectsInFlight()
+		self.addCleanup( GafferScene.Preview.setMaxObjectsInFlight, originalMaxObjectsInFlight )
+
+		GafferScene.Preview.setMaxObjectsInFlight( 0 )
+		self.assertEqual( GafferScene.Preview.getMaxObjectsInFlight(), 1 )
+
+		for maxObjectsInFlight in ( 1, 3, 100 ) :
+
+			GafferScene.Preview.setMaxObjectsInFlight( maxObjectsInFlight )
+			self.assertEqual( GafferScene.Preview.getMaxObjectsInFlight(), maxObjectsInFlight )
+
+			renderer = GafferScene.Private.IECoreScenePreview.CapturingRenderer( GafferScene.Private.IECoreScenePreview.Renderer.RenderType.Batch )
+			GafferScene.Preview.outputObjects( hidden["out"], hidden["out"]["globals"].getValue(), renderer )
+
+			# Invisible locations and their descendants should be pruned,
+			# and all other objects should be output exactly once.
+			self.assertEqual( renderer.numCapturedObjects(), 20 )
+			self.assertEqual( renderer.capturedObject( "/group3/sphere" ), None )
+			for name in [ "group" ] + [ "group%d" % i for i in range( 1, 21 ) if i != 3 ] :
+				o = renderer.capturedObject( "/" + name + "/sphere" )
+				self.assertEqual( o.capturedSamples(), [ sphere["out"].object( "/sphere" ) ] )
+				self.assertEqual( o.capturedTransforms(), [ hidden["out"].fullTransform( "/" + name + "/sphere" ) ] )
+
+	def testOutputUniqueAndSharedObjects( self ) :
+
+		sphere = GafferScene.Sphere()
+		plane = GafferScene.Plane()
+
+		duplicate = GafferScene.Duplicate()
+		duplicate["in"].setInput( plane["out"] )
+		duplicate["target"].setValue( "/plane" )
+		duplicate["copies"].setValue( 2 )
+
+		group = GafferScene.Group()
+		group["in"][0].setInput( sphere["out"] )
+		group["in"][1].setInput( duplicate["out"] )
+
+		renderer = GafferScene.Private.IECoreScenePreview.CapturingRenderer( GafferScene.Private.IECoreScenePreview.Renderer.RenderType.Batch )
+		GafferScene.Preview.outputObjects( group["out"], group["out"]["globals"].getValue(), renderer )
+
+		# Only locations with objects should be output.
+		self.assertEqual( renderer.numCapturedObjects(), 4 )
+		self.assertEqual( renderer.capturedObject( "/group" ), None )
+
+		for name in [ "sphere", "plane", "plane1", "plane2" ] :
+			o = renderer.capturedObject( "/group/" + name )
+			self.assertEqual( o.capturedSamples(), [ group["out"].object( "/group/" + name ) ] )
+			self.assertEqual( o.capturedTransforms(), [ group["out"].fullTransform( "/group/" + name ) ] )
+
+	def testIdenticalAttributesShareInterface( self ) :
+
+		sphere = GafferScene.Sphere()
+		plane = GafferScene.Plane()
+
+		group = GafferScene.Group()
+		group["in"][0].setInput( sphere["out"] )
+		group["in"][1].setInput( plane["out"] )
+
+		# Assign the same attributes to each location using
+		# separate nodes, so that they arrive via different
+		# routes through the graph.
+
+		sphereFilter = GafferScene.PathFilter()
+		sphereFilter["paths"].setValue( IECore.StringVectorData( [ "/group/sphere" ] ) )
+
+		sphereAttributes = GafferScene.CustomAttributes()
+		sphereAttributes["in"].setInput( group["out"] )
+		sphereAttributes["filter"].setInput( sphereFilter["out"] )
+		sphereAttributes["attributes"].addMember( "test", IECore.IntData( 1 ) )
+
+		planeFilter = GafferScene.PathFilter()
+		planeFilter["paths"].setValue( IECore.StringVectorData( [ "/group/plane" ] ) )
+
+		planeAttributes = GafferScene.CustomAttributes()
+		planeAttributes["in"].setInput( sphereAttributes["out"] )
+		planeAttributes["filter"].setInput( planeFilter["out"] )
+		planeAttributes["attributes"].addMember( "test", IECore.IntData( 1 ) )
+
+		renderer = GafferScene.Private.IECoreScenePreview.CapturingRenderer( GafferScene.Private.IECoreScenePreview.Renderer.RenderType.Batch )
+		GafferScene.Preview.outputObjects( planeAttributes["out"], planeAttributes["out"]["globals"].getValue(), renderer )
+
+		sphereObject = renderer.capturedObject( "/group/sphere" )
+		planeObject = renderer.capturedObject( "/group/plane" )
+		self.assertEqual( sphereObject.capturedAttributes().attributes()["test"], IECore.IntData( 1 ) )
+		self.assertTrue( sphereObject.capturedAttributes().isSame( planeObject.capturedAttributes() ) )
+
+if __name__ == "__main__":
+	unittest.main()
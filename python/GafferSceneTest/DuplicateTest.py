@@ -204,5 +204,59 @@ class DuplicateTest( GafferSceneTest.SceneTestCase ) :
 		self.assertEqual( m.plugStatistics( d["out"]["setNames"] ).hashCount, 0 )
 		self.assertEqual( m.plugStatistics( d["out"]["setNames"] ).computeCount, 0 )
 
+	def testEncapsulateCopies( self ) :
+
+		s = GafferScene.Sphere()
+		s["sets"].setValue( "testSet" )
+		g = GafferScene.Group()
+		g["in"][0].setInput( s["out"] )
+		g["transform"]["translate"].setValue( IECore.V3f( 0, 1, 0 ) )
+
+		d = GafferScene.Duplicate()
+		d["in"].setInput( g["out"] )
+		d["target"].setValue( "/group" )
+		d["transform"]["translate"].setValue( IECore.V3f( 1, 0, 0 ) )
+		d["copies"].setValue( 10 )
+
+		expandedBound = d["out"].bound( "/" )
+		copyTransforms = [ d["out"].transform( "/group%d" % i ) for i in range( 1, 11 ) ]
+
+		d["encapsulateCopies"].setValue( True )
+		self.assertSceneValid( d["out"] )
+
+		self.assertEqual( d["out"].childNames( "/" ), IECore.InternedStringVectorData( [ "group", "group1" ] ) )
+		self.assertEqual( d["out"].childNames( "/group1" ), IECore.InternedStringVectorData() )
+		self.assertEqual( d["out"].transform( "/group1" ), IECore.M44f() )
+		self.assertEqual( d["out"].attributes( "/group1" ), d["in"].attributes( "/group" ) )
+		self.assertEqual( d["out"].bound( "/" ), expandedBound )
+
+		copies = d["out"].object( "/group1" )
+		self.assertTrue( isinstance( copies, GafferScene.EncapsulatedInstances ) )
+		self.assertEqual( copies.numInstances(), 10 )
+		self.assertEqual( list( copies.instanceIds() ), range( 0, 10 ) )
+		self.assertEqual( list( copies.instanceTransforms() ), copyTransforms )
+		self.assertEqual( list( copies.prototypeNames() ), [ "/sphere" ] )
+		self.assertEqual( copies.prototypes()[0], s["out"].object( "/sphere" ) )
+
+		self.assertEqual( d["out"].set( "testSet" ).value.paths(), [ "/group/sphere" ] )
+
+		# The prototype must update when the target changes.
+
+		s["radius"].setValue( 2 )
+		self.assertEqual( d["out"].object( "/group1" ).prototypes()[0], s["out"].object( "/sphere" ) )
+
+		# And the bound must update when the target transform changes.
+
+		encapsulatedBound = d["out"].bound( "/group1" )
+
+		cs = GafferTest.CapturingSlot( d.plugDirtiedSignal() )
+		g["transform"]["translate"].setValue( IECore.V3f( 0, 2, 0 ) )
+		self.assertTrue( d["out"]["bound"] in [ x[0] for x in cs ] )
+		self.assertNotEqual( d["out"].bound( "/group1" ), encapsulatedBound )
+
+		encapsulatedBound = d["out"].bound( "/" )
+		d["encapsulateCopies"].setValue( False )
+		self.assertEqual( d["out"].bound( "/" ), encapsulatedBound )
+
 if __name__ == "__main__":
 	unittest.main()
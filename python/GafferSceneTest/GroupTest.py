@@ -768,6 +768,36 @@ class GroupTest( GafferSceneTest.SceneTestCase ) :
 
 		self.assertEqual( s["g"]["out"].childNames( "/group" ), IECore.InternedStringVectorData( [ "plane", "sphere" ] ) )
 
+	def testManyInputs( self ) :
+
+		sphere = GafferScene.Sphere()
+		sphere["sets"].setValue( "A" )
+
+		sphere3 = GafferScene.Sphere()
+		sphere3["name"].setValue( "sphere3" )
+
+		plane = GafferScene.Plane()
+		plane["sets"].setValue( "A" )
+
+		group = GafferScene.Group()
+		inputs = [ sphere, sphere3, sphere, sphere, sphere, sphere3, plane ] + [ sphere ] * 1000
+		for i, node in enumerate( inputs ) :
+			group["in"][i].setInput( node["out"] )
+
+		childNames = [ str( n ) for n in group["out"].childNames( "/group" ) ]
+		self.assertEqual(
+			childNames[:7],
+			[ "sphere", "sphere3", "sphere1", "sphere2", "sphere4", "sphere5", "plane" ]
+		)
+		self.assertEqual( len( childNames ), len( inputs ) )
+		self.assertEqual( len( set( childNames ) ), len( inputs ) )
+		self.assertEqual( childNames[-1], "sphere1005" )
+
+		expectedSet = set( [ "/group/" + n for n, node in zip( childNames, inputs ) if node is not sphere3 ] )
+		self.assertEqual( set( group["out"].set( "A" ).value.paths() ), expectedSet )
+
+		self.assertSceneValid( group["out"] )
+
 	def setUp( self ) :
 
 		GafferSceneTest.SceneTestCase.setUp( self )
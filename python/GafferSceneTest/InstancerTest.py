@@ -35,6 +35,8 @@
 #
 ##########################################################################
 
+import math
+
 import IECore
 
 import Gaffer
@@ -247,6 +249,159 @@ class InstancerTest( GafferSceneTest.SceneTestCase ) :
 		for i in range( 0, 100 ) :
 			self.assertEqual( instancer["out"].boundHash( "/plane/instances" ), h )
 
+	def testBoundWithVaryingAndUniformPrototypes( self ) :
+
+		script = Gaffer.ScriptNode()
+
+		script["plane"] = GafferScene.Plane()
+		script["plane"]["divisions"].setValue( IECore.V2i( 5 ) )
+
+		script["sphere"] = GafferScene.Sphere()
+
+		script["instancer"] = GafferScene.Instancer()
+		script["instancer"]["in"].setInput( script["plane"]["out"] )
+		script["instancer"]["instance"].setInput( script["sphere"]["out"] )
+		script["instancer"]["parent"].setValue( "/plane" )
+
+		def expectedBound() :
+
+			result = IECore.Box3f()
+			for name in script["instancer"]["out"].childNames( "/plane/instances" ) :
+				b = script["instancer"]["out"].bound( "/plane/instances/" + str( name ) )
+				m = script["instancer"]["out"].transform( "/plane/instances/" + str( name ) )
+				result.extendBy( b.transform( m ) )
+
+			return result
+
+		uniformBound = script["instancer"]["out"].bound( "/plane/instances" )
+		self.assertEqual( uniformBound, expectedBound() )
+
+		script["expression"] = Gaffer.Expression()
+		script["expression"].setExpression( "parent['sphere']['radius'] = 1 + float( context['instancer:id'] )" )
+
+		varyingBound = script["instancer"]["out"].bound( "/plane/instances" )
+		self.assertEqual( varyingBound, expectedBound() )
+		self.assertNotEqual( varyingBound, uniformBound )
+
+	def testEncapsulateInstances( self ) :
+
+		plane = GafferScene.Plane()
+		plane["divisions"].setValue( IECore.V2i( 2 ) )
+
+		sphere = GafferScene.Sphere()
+
+		instancer = GafferScene.Instancer()
+		instancer["in"].setInput( plane["out"] )
+		instancer["instance"].setInput( sphere["out"] )
+		instancer["parent"].setValue( "/plane" )
+
+		expandedBound = instancer["out"].bound( "/plane/instances" )
+		instanceTransforms = [
+			instancer["out"].transform( "/plane/instances/" + str( n ) )
+			for n in instancer["out"].childNames( "/plane/instances" )
+		]
+
+		instancer["encapsulateInstances"].setValue( True )
+
+		self.assertEqual( instancer["out"].childNames( "/plane/instances" ), IECore.InternedStringVectorData() )
+		self.assertEqual( instancer["out"].bound( "/plane/instances" ), expandedBound )
+
+		instances = instancer["out"].object( "/plane/instances" )
+		self.assertTrue( isinstance( instances, GafferScene.EncapsulatedInstances ) )
+		self.assertEqual( instances.numInstances(), 9 )
+		self.assertEqual( list( instances.instanceIds() ), range( 0, 9 ) )
+		self.assertEqual( list( instances.instanceTransforms() ), instanceTransforms )
+		self.assertEqual( list( instances.prototypeNames() ), [ "/sphere" ] )
+		self.assertEqual( instances.prototypes()[0], sphere["out"].object( "/sphere" ) )
+		self.assertEqual( instances.bound(), expandedBound )
+
+		self.assertSceneValid( instancer["out"] )
+
+	def testInvalidInstanceIndex( self ) :
+
+		plane = GafferScene.Plane()
+		sphere = GafferScene.Sphere()
+
+		instancer = GafferScene.Instancer()
+		instancer["in"].setInput( plane["out"] )
+		instancer["instance"].setInput( sphere["out"] )
+		instancer["parent"].setValue( "/plane" )
+
+		self.assertEqual( len( instancer["out"].childNames( "/plane/instances" ) ), 4 )
+		instancer["out"].transform( "/plane/instances/3" )
+
+		self.assertRaises( RuntimeError, instancer["out"].transform, "/plane/instances/4" )
+		self.assertRaises( RuntimeError, instancer["out"].transform, "/plane/instances/-1" )
+
+	def testOrientationScaleAndPivot( self ) :
+
+		points = IECore.PointsPrimitive( IECore.V3fVectorData( [ IECore.V3f( 1, 0, 0 ), IECore.V3f( 0, 2, 0 ) ] ) )
+		points["orientation"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.QuatfVectorData( [ IECore.Quatf(), IECore.Quatf( math.cos( 0.75 ), 0, 0, math.sin( 0.75 ) ) ] )
+		)
+		points["scale"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.V3fVectorData( [ IECore.V3f( 1, 2, 3 ), IECore.V3f( 4 ) ] )
+		)
+		points["uniformScale"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.FloatVectorData( [ 2, 3 ] )
+		)
+		points["pivot"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.V3fVectorData( [ IECore.V3f( 0 ), IECore.V3f( 1, 0, 0 ) ] )
+		)
+
+		objectToScene = GafferScene.ObjectToScene()
+		objectToScene["object"].setValue( points )
+
+		sphere = GafferScene.Sphere()
+
+		instancer = GafferScene.Instancer()
+		instancer["in"].setInput( objectToScene["out"] )
+		instancer["instance"].setInput( sphere["out"] )
+		instancer["parent"].setValue( "/object" )
+
+		def assertTransforms( expected ) :
+
+			for i, m in enumerate( expected ) :
+				self.assertTrue( instancer["out"].transform( "/object/instances/%d" % i ).equalWithAbsError( m, 0.00001 ) )
+
+		assertTransforms( [ IECore.M44f.createTranslated( p ) for p in points["P"].data ] )
+
+		instancer["orientation"].setValue( "orientation" )
+		assertTransforms( [
+			q.toMatrix44() * IECore.M44f.createTranslated( p )
+			for p, q in zip( points["P"].data, points["orientation"].data )
+		] )
+
+		instancer["scale"].setValue( "scale" )
+		assertTransforms( [
+			IECore.M44f.createScaled( s ) * q.toMatrix44() * IECore.M44f.createTranslated( p )
+			for p, q, s in zip( points["P"].data, points["orientation"].data, points["scale"].data )
+		] )
+
+		instancer["scale"].setValue( "uniformScale" )
+		assertTransforms( [
+			IECore.M44f.createScaled( IECore.V3f( s ) ) * q.toMatrix44() * IECore.M44f.createTranslated( p )
+			for p, q, s in zip( points["P"].data, points["orientation"].data, points["uniformScale"].data )
+		] )
+
+		instancer["pivot"].setValue( "pivot" )
+		assertTransforms( [
+			IECore.M44f.createTranslated( -o ) * IECore.M44f.createScaled( IECore.V3f( s ) ) * q.toMatrix44() * IECore.M44f.createTranslated( p )
+			for p, q, s, o in zip( points["P"].data, points["orientation"].data, points["uniformScale"].data, points["pivot"].data )
+		] )
+
+		self.assertSceneValid( instancer["out"] )
+
+		instancer["orientation"].setValue( "scale" )
+		self.assertRaises( RuntimeError, instancer["out"].transform, "/object/instances/0" )
+
+		instancer["orientation"].setValue( "doesNotExist" )
+		self.assertRaises( RuntimeError, instancer["out"].transform, "/object/instances/0" )
+
 	def testObjectAffectsChildNames( self ) :
 
 		plane = GafferScene.Plane()
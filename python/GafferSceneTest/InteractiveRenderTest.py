@@ -1395,6 +1395,94 @@ class InteractiveRenderTest( GafferSceneTest.SceneTestCase ) :
 		self.assertEqual( len( errors ), 0 )
 		box["r"]["state"].setValue( box["r"].State.Stopped )
 
+	def testEditsDuringBackgroundUpdate( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["s"] = GafferScene.Sphere()
+
+		# A slow Python expression, so that our edits are made
+		# while background updates are still in progress, and
+		# so that the updates need the GIL to make progress.
+		s["e"] = Gaffer.Expression()
+		s["e"].setExpression(
+			inspect.cleandoc(
+				"""
+				for i in range( 0, 100000 ) :
+					pass
+				parent["s"]["radius"] = parent["s"]["transform"]["translate"]["y"] + 1
+				"""
+			)
+		)
+
+		s["o"] = GafferScene.Outputs()
+		s["o"].addOutput(
+			"beauty",
+			IECore.Display(
+				"test",
+				"ieDisplay",
+				"rgba",
+				{
+					"driverType" : "ImageDisplayDriver",
+					"handle" : "myLovelySphere",
+				}
+			)
+		)
+		s["o"]["in"].setInput( s["s"]["out"] )
+
+		s["r"] = self._createInteractiveRender()
+		s["r"]["in"].setInput( s["o"]["out"] )
+
+		s["r"]["state"].setValue( s["r"].State.Running )
+
+		# Edit repeatedly while updates are in flight. Each edit
+		# cancels the update in progress, and the final update
+		# must reflect the final edit.
+
+		for x in ( 1, 0, 3, 2 ) :
+			s["s"]["transform"]["translate"]["x"].setValue( x )
+			time.sleep( 0.01 )
+
+		time.sleep( 1 )
+
+		image = IECore.ImageDisplayDriver.storedImage( "myLovelySphere" )
+		self.assertAlmostEqual( self.__color4fAtUV( image, IECore.V2f( 0.5 ) ).r, 0, delta = 0.01 )
+
+		# Edits which don't affect the scene must not interrupt
+		# the render.
+
+		Gaffer.Metadata.registerNodeValue( s["s"], "nodeGadget:color", IECore.Color3f( 1, 0, 0 ) )
+		s["s"]["transform"]["translate"]["x"].setValue( 0 )
+		Gaffer.Metadata.registerNodeValue( s["s"], "nodeGadget:color", IECore.Color3f( 0, 1, 0 ) )
+
+		time.sleep( 1 )
+
+		image = IECore.ImageDisplayDriver.storedImage( "myLovelySphere" )
+		self.assertAlmostEqual( self.__color4fAtUV( image, IECore.V2f( 0.5 ) ).r, 1, delta = 0.01 )
+
+	def testDeleteDuringBackgroundUpdate( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["s"] = GafferScene.Sphere()
+
+		s["e"] = Gaffer.Expression()
+		s["e"].setExpression(
+			inspect.cleandoc(
+				"""
+				for i in range( 0, 100000 ) :
+					pass
+				parent["s"]["radius"] = 1
+				"""
+			)
+		)
+
+		s["r"] = self._createInteractiveRender()
+		s["r"]["in"].setInput( s["s"]["out"] )
+		s["r"]["state"].setValue( s["r"].State.Running )
+
+		# Destroying the node must wait for the update
+		# without deadlocking on the GIL.
+		del s["r"]
+
 	## Should be implemented by derived classes to return an
 	# appropriate InteractiveRender node.
 	def _createInteractiveRender( self ) :
@@ -77,5 +77,23 @@ class MapOffsetTest( GafferSceneTest.SceneTestCase ) :
 		for i, t in enumerate( offset["out"].object( "/plane" )["t"].data ) :
 			self.assertEqual( t, inputObject["t"].data[i] + 3.5 )
 
+	def testInputDataIsShared( self ) :
+
+		plane = GafferScene.Plane()
+		offset = GafferScene.MapOffset()
+		offset["in"].setInput( plane["out"] )
+		offset["offset"].setValue( IECore.V2f( 0.5, 1.5 ) )
+
+		inputObject = plane["out"].object( "/plane", _copy = False )
+		outputObject = offset["out"].object( "/plane", _copy = False )
+
+		self.assertTrue( outputObject["P"].data.isSame( inputObject["P"].data ) )
+		self.assertFalse( outputObject["s"].data.isSame( inputObject["s"].data ) )
+		self.assertFalse( outputObject["t"].data.isSame( inputObject["t"].data ) )
+
+		# Modifying the output must not have modified the input.
+		self.assertEqual( inputObject, plane["out"].object( "/plane" ) )
+		self.assertEqual( outputObject["s"].data[0], inputObject["s"].data[0] + 0.5 )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -68,5 +68,48 @@ class PrimitiveVariablesTest( GafferSceneTest.SceneTestCase ) :
 		del o2["a"]
 		self.assertEqual( o1, o2 )
 
+	def testInputDataIsShared( self ) :
+
+		s = GafferScene.Sphere()
+		p = GafferScene.PrimitiveVariables()
+		p["in"].setInput( s["out"] )
+		p["primitiveVariables"].addMember( "a", IECore.IntData( 10 ) )
+
+		o1 = s["out"].object( "/sphere", _copy = False )
+		o2 = p["out"].object( "/sphere", _copy = False )
+
+		for name in o1.keys() :
+			self.assertTrue( o2[name].data.isSame( o1[name].data ) )
+
+	def testSharedDataCacheMemoryUsage( self ) :
+
+		points = IECore.PointsPrimitive( IECore.V3fVectorData( [ IECore.V3f( 0 ) ] * 100000 ) )
+
+		objectToScene = GafferScene.ObjectToScene()
+		objectToScene["object"].setValue( points )
+
+		nodes = []
+		out = objectToScene["out"]
+		for i in range( 0, 5 ) :
+			primitiveVariables = GafferScene.PrimitiveVariables()
+			primitiveVariables["in"].setInput( out )
+			primitiveVariables["primitiveVariables"].addMember( "a%d" % i, IECore.IntData( i ) )
+			nodes.append( primitiveVariables )
+			out = primitiveVariables["out"]
+
+		cacheMemoryLimit = Gaffer.ValuePlug.getCacheMemoryLimit()
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		try :
+			Gaffer.ValuePlug.setCacheMemoryLimit( cacheMemoryLimit )
+			self.assertEqual( Gaffer.ValuePlug.cacheMemoryUsage(), 0 )
+
+			out.object( "/object", _copy = False )
+
+			# Every node in the chain holds the same "P" data in the
+			# cache, but it should only be charged for once.
+			self.assertLess( Gaffer.ValuePlug.cacheMemoryUsage(), 2 * points.memoryUsage() )
+		finally :
+			Gaffer.ValuePlug.setCacheMemoryLimit( cacheMemoryLimit )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -34,10 +34,12 @@
 #
 ##########################################################################
 
+import os
 import unittest
 
 import IECore
 
+import Gaffer
 import GafferScene
 import GafferSceneTest
 
@@ -179,6 +181,130 @@ class SceneAlgoTest( GafferSceneTest.SceneTestCase ) :
 
 		self.assertEqual( set( m.paths() ), { "/group/sphere", "/group/sphere1", "/group/sphere2" } )
 
+	def testTraversalScaling( self ) :
+
+		# Checks that the traversal engine used by matchingPaths(),
+		# parallelTraverse() and the renderer output functions visits
+		# every location in both a flat hierarchy with many children at
+		# a single location, and a deep hierarchy with nested branching
+		# and chains of single children.
+
+		# Flat hierarchy
+
+		flatPlane = GafferScene.Plane()
+		flatPlane["divisions"].setValue( IECore.V2i( 99, 99 ) ) # 10000 instances
+
+		flatInstancer = GafferScene.Instancer()
+		flatInstancer["in"].setInput( flatPlane["out"] )
+		flatInstancer["parent"].setValue( "/plane" )
+
+		matchingPaths = GafferScene.PathMatcher()
+		GafferScene.matchingPaths( GafferScene.PathMatcher( [ "/plane/instances/*" ] ), flatInstancer["out"], matchingPaths )
+
+		self.assertEqual( len( matchingPaths.paths() ), 10000 )
+
+		# Deep hierarchy
+
+		plane = GafferScene.Plane()
+		plane["divisions"].setValue( IECore.V2i( 9, 9 ) ) # 100 instances
+
+		innerInstancer = GafferScene.Instancer()
+		innerInstancer["in"].setInput( plane["out"] )
+		innerInstancer["parent"].setValue( "/plane" )
+
+		group = GafferScene.Group()
+		group["in"][0].setInput( innerInstancer["out"] )
+		for i in range( 0, 2 ) :
+			outerGroup = GafferScene.Group()
+			outerGroup["in"][0].setInput( group["out"] )
+			group = outerGroup
+
+		outerInstancer = GafferScene.Instancer()
+		outerInstancer["in"].setInput( plane["out"] )
+		outerInstancer["parent"].setValue( "/plane" )
+		outerInstancer["instance"].setInput( group["out"] )
+
+		matchingPaths = GafferScene.PathMatcher()
+		GafferScene.matchingPaths( GafferScene.PathMatcher( [ "/plane/instances/*/group/group/group/plane/instances/*" ] ), outerInstancer["out"], matchingPaths )
+
+		self.assertEqual( len( matchingPaths.paths() ), 10000 )
+		self.assertEqual( matchingPaths.match( "/plane/instances/10/group/group/group/plane/instances/99" ), GafferScene.Filter.Result.ExactMatch )
+
+	@unittest.skipUnless( "GAFFER_PERFORMANCE_TESTS" in os.environ, "Set GAFFER_PERFORMANCE_TESTS to run benchmarks" )
+	def testTraversalPerformance( self ) :
+
+		# Benchmarks the traversal engine used by matchingPaths(),
+		# parallelTraverse() and the renderer output functions, using
+		# two synthetic scenes of around a million locations each :
+		#
+		#    * a flat hierarchy with a million children at a single location
+		#    * a deep hierarchy with nested branching and chains of single children
+		#
+		# This is too slow to be run as part of the unit tests, so is only
+		# run when GAFFER_PERFORMANCE_TESTS is set in the environment.
+
+		# Flat hierarchy
+
+		flatPlane = GafferScene.Plane()
+		flatPlane["divisions"].setValue( IECore.V2i( 999, 999 ) ) # 1000000 instances
+
+		flatInstancer = GafferScene.Instancer()
+		flatInstancer["in"].setInput( flatPlane["out"] )
+		flatInstancer["parent"].setValue( "/plane" )
+
+		t = IECore.Timer()
+		matchingPaths = GafferScene.PathMatcher()
+		GafferScene.matchingPaths( GafferScene.PathMatcher( [ "/plane/instances/*" ] ), flatInstancer["out"], matchingPaths )
+		print "\nTraverse flat hierarchy : %.3fs" % t.stop()
+
+		self.assertEqual( len( matchingPaths.paths() ), 1000000 )
+
+		# Deep hierarchy
+
+		plane = GafferScene.Plane()
+		plane["divisions"].setValue( IECore.V2i( 9, 99 ) ) # 1000 instances
+
+		innerInstancer = GafferScene.Instancer()
+		innerInstancer["in"].setInput( plane["out"] )
+		innerInstancer["parent"].setValue( "/plane" )
+
+		group = GafferScene.Group()
+		group["in"][0].setInput( innerInstancer["out"] )
+		for i in range( 0, 2 ) :
+			outerGroup = GafferScene.Group()
+			outerGroup["in"][0].setInput( group["out"] )
+			group = outerGroup
+
+		outerInstancer = GafferScene.Instancer()
+		outerInstancer["in"].setInput( plane["out"] )
+		outerInstancer["parent"].setValue( "/plane" )
+		outerInstancer["instance"].setInput( group["out"] )
+
+		t = IECore.Timer()
+		matchingPaths = GafferScene.PathMatcher()
+		GafferScene.matchingPaths( GafferScene.PathMatcher( [ "/plane/instances/*/group/group/group/plane/instances/*" ] ), outerInstancer["out"], matchingPaths )
+		print "Traverse deep hierarchy : %.3fs" % t.stop()
+
+		self.assertEqual( len( matchingPaths.paths() ), 1000000 )
+
+	def testParallelProcessLocationsVisitsEveryLocation( self ) :
+
+		sphere = GafferScene.Sphere()
+		group = GafferScene.Group()
+		for i in range( 0, 10 ) :
+			group["in"][i].setInput( sphere["out"] )
+
+		outerGroup = GafferScene.Group()
+		outerGroup["in"][0].setInput( group["out"] )
+
+		matchingPaths = GafferScene.PathMatcher()
+		GafferScene.matchingPaths( GafferScene.PathMatcher( [ "/group", "/group/group", "/group/group/*" ] ), outerGroup["out"], matchingPaths )
+
+		self.assertEqual(
+			set( matchingPaths.paths() ),
+			set( [ "/group", "/group/group" ] + [ "/group/group/sphere" + ( str( i ) if i else "" ) for i in range( 0, 10 ) ] )
+		)
+
 	def testDefaultCamera( self ) :
 
 		o = GafferScene.StandardOptions()
@@ -189,5 +315,175 @@ class SceneAlgoTest( GafferSceneTest.SceneTestCase ) :
 		c2 = GafferScene.camera( o["out"] )
 		self.assertEqual( c1, c2 )
 
+	def testSampleTransform( self ) :
+
+		s = Gaffer.ScriptNode()
+
+		s["sphere"] = GafferScene.Sphere()
+		s["group"] = GafferScene.Group()
+		s["group"]["in"][0].setInput( s["sphere"]["out"] )
+		s["group"]["transform"]["translate"]["y"].setValue( 2 )
+
+		s["expression"] = Gaffer.Expression()
+		s["expression"].setExpression( 'parent["sphere"]["transform"]["translate"]["x"] = context.getFrame()' )
+
+		times = [ 0.75, 1, 1.25 ]
+		samples, moving = GafferScene.sampleTransform( s["group"]["out"], "/group/sphere", times )
+		self.assertTrue( moving )
+		fullSamples, fullMoving = GafferScene.sampleFullTransform( s["group"]["out"], "/group/sphere", times )
+		self.assertTrue( fullMoving )
+		groupSamples, groupMoving = GafferScene.sampleTransform( s["group"]["out"], "/group", times )
+		self.assertFalse( groupMoving )
+
+		self.assertEqual( len( samples ), 3 )
+		self.assertEqual( len( fullSamples ), 3 )
+		self.assertEqual( len( groupSamples ), 3 )
+
+		for time, sample, fullSample, groupSample in zip( times, samples, fullSamples, groupSamples ) :
+			self.assertEqual( sample, IECore.M44f.createTranslated( IECore.V3f( time, 0, 0 ) ) )
+			self.assertEqual( fullSample, IECore.M44f.createTranslated( IECore.V3f( time, 2, 0 ) ) )
+			self.assertEqual( groupSample, IECore.M44f.createTranslated( IECore.V3f( 0, 2, 0 ) ) )
+
+	def testSampleObject( self ) :
+
+		s = Gaffer.ScriptNode()
+
+		s["sphere"] = GafferScene.Sphere()
+		s["plane"] = GafferScene.Plane()
+
+		s["expression"] = Gaffer.Expression()
+		s["expression"].setExpression( 'parent["sphere"]["radius"] = context.getFrame()' )
+
+		times = [ 1, 2, 3 ]
+		path = "/sphere"
+		samples, moving = GafferScene.sampleObject( s["sphere"]["out"], path, times )
+		self.assertTrue( moving )
+		self.assertEqual( len( samples ), 3 )
+		for time, sample in zip( times, samples ) :
+			with Gaffer.Context() as c :
+				c.setFrame( time )
+				self.assertEqual( sample, s["sphere"]["out"].object( path ) )
+
+		path = "/plane"
+		samples, moving = GafferScene.sampleObject( s["plane"]["out"], path, times )
+		self.assertFalse( moving )
+		self.assertEqual( len( samples ), 3 )
+		for sample in samples :
+			self.assertEqual( sample, s["plane"]["out"].object( path ) )
+
+	def testStaticSamplesAreShared( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["sphere"] = GafferScene.Sphere()
+		s["sphere"]["transform"]["translate"]["x"].setValue( 1 )
+
+		times = [ 0.75, 1, 1.25 ]
+
+		samples, moving = GafferScene.sampleTransform( s["sphere"]["out"], "/sphere", times )
+		self.assertFalse( moving )
+		self.assertEqual( samples, [ s["sphere"]["out"].transform( "/sphere" ) ] * 3 )
+
+		samples, moving = GafferScene.sampleFullTransform( s["sphere"]["out"], "/sphere", times )
+		self.assertFalse( moving )
+		self.assertEqual( samples, [ s["sphere"]["out"].fullTransform( "/sphere" ) ] * 3 )
+
+		# Static objects are computed only once, so every sample
+		# should be the very same object.
+
+		samples, moving = GafferScene.sampleObject( s["sphere"]["out"], "/sphere", times, _copy = False )
+		self.assertFalse( moving )
+		self.assertTrue( samples[1].isSame( samples[0] ) )
+		self.assertTrue( samples[2].isSame( samples[0] ) )
+
+	def testSceneDiff( self ) :
+
+		sphere1 = GafferScene.Sphere()
+		cube = GafferScene.Cube()
+
+		group1 = GafferScene.Group()
+		group1["in"][0].setInput( sphere1["out"] )
+		group1["in"][1].setInput( cube["out"] )
+
+		sphere2 = GafferScene.Sphere()
+		sphere2["radius"].setValue( 2 )
+		plane = GafferScene.Plane()
+
+		group2 = GafferScene.Group()
+		group2["in"][0].setInput( sphere2["out"] )
+		group2["in"][1].setInput( plane["out"] )
+
+		setNode = GafferScene.Set()
+		setNode["in"].setInput( group2["out"] )
+		setNode["name"].setValue( "A" )
+		setNode["paths"].setValue( IECore.StringVectorData( [ "/group/plane" ] ) )
+
+		# Identical scenes
+
+		diff = GafferScene.sceneDiff( group1["out"], group1["out"] )
+		self.assertTrue( diff["added"].value.isEmpty() )
+		self.assertTrue( diff["removed"].value.isEmpty() )
+		for property in ( "bound", "transform", "attributes", "object" ) :
+			self.assertTrue( diff["changed"][property].value.isEmpty() )
+		self.assertEqual( diff["globals"], IECore.BoolData( False ) )
+		self.assertEqual( diff["sets"], IECore.InternedStringVectorData() )
+
+		# Equal scenes from different nodes
+
+		sphere2["radius"].setValue( 1 )
+		group2["in"][1].setInput( cube["out"] )
+
+		diff = GafferScene.sceneDiff( group1["out"], group2["out"] )
+		self.assertTrue( diff["added"].value.isEmpty() )
+		self.assertTrue( diff["removed"].value.isEmpty() )
+		for property in ( "bound", "transform", "attributes", "object" ) :
+			self.assertTrue( diff["changed"][property].value.isEmpty() )
+
+		# Differing scenes
+
+		sphere2["radius"].setValue( 2 )
+		group2["in"][1].setInput( plane["out"] )
+
+		diff = GafferScene.sceneDiff( group1["out"], setNode["out"] )
+		self.assertEqual( diff["added"].value.paths(), [ "/group/plane" ] )
+		self.assertEqual( diff["removed"].value.paths(), [ "/group/cube" ] )
+		self.assertEqual( diff["changed"]["object"].value.paths(), [ "/group/sphere" ] )
+		self.assertEqual( set( diff["changed"]["bound"].value.paths() ), { "/", "/group", "/group/sphere" } )
+		self.assertTrue( diff["changed"]["transform"].value.isEmpty() )
+		self.assertTrue( diff["changed"]["attributes"].value.isEmpty() )
+		self.assertEqual( diff["globals"], IECore.BoolData( False ) )
+		self.assertEqual( diff["sets"], IECore.InternedStringVectorData( [ "A" ] ) )
+
+	def testSceneDiffWithContexts( self ) :
+
+		script = Gaffer.ScriptNode()
+		script["sphere"] = GafferScene.Sphere()
+		script["expression"] = Gaffer.Expression()
+		script["expression"].setExpression( 'parent["sphere"]["radius"] = context.getFrame()' )
+
+		context1 = Gaffer.Context()
+		context1.setFrame( 1 )
+		context2 = Gaffer.Context()
+		context2.setFrame( 1 )
+
+		diff = GafferScene.sceneDiff( script["sphere"]["out"], context1, script["sphere"]["out"], context2 )
+		self.assertTrue( diff["changed"]["object"].value.isEmpty() )
+		self.assertTrue( diff["changed"]["bound"].value.isEmpty() )
+
+		context2.setFrame( 2 )
+
+		diff = GafferScene.sceneDiff( script["sphere"]["out"], context1, script["sphere"]["out"], context2 )
+		self.assertEqual( diff["changed"]["object"].value.paths(), [ "/sphere" ] )
+		self.assertEqual( set( diff["changed"]["bound"].value.paths() ), { "/", "/sphere" } )
+		self.assertTrue( diff["changed"]["transform"].value.isEmpty() )
+		self.assertTrue( diff["added"].value.isEmpty() )
+		self.assertTrue( diff["removed"].value.isEmpty() )
+
+		# The current context should be irrelevant.
+
+		with Gaffer.Context() as c :
+			c.setFrame( 2 )
+			diff = GafferScene.sceneDiff( script["sphere"]["out"], context1, script["sphere"]["out"], context1 )
+			self.assertTrue( diff["changed"]["object"].value.isEmpty() )
+
 if __name__ == "__main__":
 	unittest.main()
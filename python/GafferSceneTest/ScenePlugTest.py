@@ -208,6 +208,24 @@ class ScenePlugTest( GafferSceneTest.SceneTestCase ) :
 
 		GafferSceneTest.testManyStringToPathCalls()
 
+	def testSharedScenePath( self ) :
+
+		GafferSceneTest.testSharedScenePath()
+
+	def testTraversalContextHash( self ) :
+
+		sphere = GafferScene.Sphere()
+
+		innerGroup = GafferScene.Group()
+		for i in range( 0, 5 ) :
+			innerGroup["in"][i].setInput( sphere["out"] )
+
+		outerGroup = GafferScene.Group()
+		for i in range( 0, 5 ) :
+			outerGroup["in"][i].setInput( innerGroup["out"] )
+
+		GafferSceneTest.testTraversalContextHash( outerGroup["out"] )
+
 	def testSetPlugs( self ) :
 
 		p = GafferScene.ScenePlug()
@@ -233,5 +251,87 @@ class ScenePlugTest( GafferSceneTest.SceneTestCase ) :
 		self.assertEqual( p.globalsHash(), p["globals"].hash() )
 		self.assertEqual( p.setNamesHash(), p["setNames"].hash() )
 
+	def testHierarchyHash( self ) :
+
+		sphere = GafferScene.Sphere()
+		cube = GafferScene.Cube()
+
+		group = GafferScene.Group()
+		group["in"][0].setInput( sphere["out"] )
+		group["in"][1].setInput( cube["out"] )
+
+		attributes = GafferScene.StandardAttributes()
+		attributes["in"].setInput( group["out"] )
+
+		rootHash = attributes["out"].hierarchyHash( "/" )
+		sphereHash = attributes["out"].hierarchyHash( "/group/sphere" )
+		cubeHash = attributes["out"].hierarchyHash( "/group/cube" )
+
+		self.assertNotEqual( sphereHash, cubeHash )
+		self.assertEqual( attributes["out"].hierarchyHash( "/" ), rootHash )
+		self.assertEqual( group["out"].hierarchyHash( "/group/sphere" ), sphereHash )
+
+		# Changing a nested object must change the hashes for
+		# all ancestors, but not for sibling subtrees.
+
+		sphere["radius"].setValue( 2 )
+
+		self.assertNotEqual( attributes["out"].hierarchyHash( "/" ), rootHash )
+		self.assertNotEqual( attributes["out"].hierarchyHash( "/group/sphere" ), sphereHash )
+		self.assertEqual( attributes["out"].hierarchyHash( "/group/cube" ), cubeHash )
+
+		sphere["radius"].setValue( 1 )
+
+		self.assertEqual( attributes["out"].hierarchyHash( "/" ), rootHash )
+		self.assertEqual( attributes["out"].hierarchyHash( "/group/sphere" ), sphereHash )
+
+		# Likewise for a nested attribute.
+
+		cubeFilter = GafferScene.PathFilter()
+		cubeFilter["paths"].setValue( IECore.StringVectorData( [ "/group/cube" ] ) )
+		attributes["filter"].setInput( cubeFilter["out"] )
+		attributes["attributes"]["visibility"]["enabled"].setValue( True )
+
+		self.assertNotEqual( attributes["out"].hierarchyHash( "/" ), rootHash )
+		self.assertNotEqual( attributes["out"].hierarchyHash( "/group/cube" ), cubeHash )
+		self.assertEqual( attributes["out"].hierarchyHash( "/group/sphere" ), sphereHash )
+
+	def testHierarchyHashAfterDeepEdit( self ) :
+
+		sphere = GafferScene.Sphere()
+
+		innerGroup = GafferScene.Group()
+		innerGroup["in"][0].setInput( sphere["out"] )
+
+		outerGroup = GafferScene.Group()
+		outerGroup["in"][0].setInput( innerGroup["out"] )
+
+		sphereFilter = GafferScene.PathFilter()
+		sphereFilter["paths"].setValue( IECore.StringVectorData( [ "/group/group/sphere" ] ) )
+
+		attributes = GafferScene.CustomAttributes()
+		attributes["in"].setInput( outerGroup["out"] )
+		attributes["filter"].setInput( sphereFilter["out"] )
+
+		rootHash = attributes["out"].hierarchyHash( "/" )
+		rootBoundHash = attributes["out"].boundHash( "/" )
+		rootChildNamesHash = attributes["out"].childNamesHash( "/" )
+
+		# An attribute edit three levels down doesn't affect anything
+		# at the root, but must still change the root hierarchy hash.
+
+		attributes["attributes"].addMember( "test", IECore.IntData( 1 ) )
+
+		self.assertEqual( attributes["out"].boundHash( "/" ), rootBoundHash )
+		self.assertEqual( attributes["out"].childNamesHash( "/" ), rootChildNamesHash )
+		self.assertNotEqual( attributes["out"].hierarchyHash( "/" ), rootHash )
+
+		# And subsequent edits must continue to be reflected.
+
+		newRootHash = attributes["out"].hierarchyHash( "/" )
+		attributes["attributes"][0]["value"].setValue( 2 )
+		self.assertNotEqual( attributes["out"].hierarchyHash( "/" ), newRootHash )
+		self.assertNotEqual( attributes["out"].hierarchyHash( "/" ), rootHash )
+
 if __name__ == "__main__":
 	unittest.main()
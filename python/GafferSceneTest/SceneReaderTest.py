@@ -451,6 +451,32 @@ class SceneReaderTest( GafferSceneTest.SceneTestCase ) :
 		self.assertEqual( s["out"].set( "ObjectType:SpherePrimitive" ).value.paths(), [ "/sphereGroup/sphere" ] )
 		self.assertEqual( s["out"].set( "ObjectType:MeshPrimitive" ).value.paths(), [ "/planeGroup/plane" ] )
 
+	def testManyTagsAsSets( self ) :
+
+		sc = IECore.SceneCache( self.__testFile, IECore.IndexedIO.OpenMode.Write )
+
+		for i in range( 0, 10 ) :
+			group = sc.createChild( "group%d" % i )
+			for j in range( 0, 10 ) :
+				child = group.createChild( "child%d" % j )
+				child.writeTags( [ "tag%d" % ( ( i + j ) % 60 ), "tag%d" % ( 50 + j ) ] )
+
+		del sc, group, child
+
+		reader = GafferScene.SceneReader()
+		reader["fileName"].setValue( self.__testFile )
+		reader["refreshCount"].setValue( self.uniqueInt( self.__testFile ) )
+
+		for n in range( 0, 60 ) :
+			expected = set()
+			for i in range( 0, 10 ) :
+				for j in range( 0, 10 ) :
+					if ( i + j ) % 60 == n or 50 + j == n :
+						expected.add( "/group%d/child%d" % ( i, j ) )
+			self.assertEqual( set( reader["out"].set( "tag%d" % n ).value.paths() ), expected )
+
+		self.assertEqual( reader["out"].set( "notATag" ).value.paths(), [] )
+
 	def testInvalidFiles( self ) :
 
 		reader = GafferScene.SceneReader()
@@ -486,6 +512,34 @@ class SceneReaderTest( GafferSceneTest.SceneTestCase ) :
 		self.assertEqual( r1["out"]["globals"].getValue(), IECore.CompoundObject() )
 		self.assertTrue( r1["out"]["globals"].getValue( _copy = False ).isSame( r2["out"]["globals"].getValue( _copy = False ) ) )
 
+	def testParallelReadOfDeepHierarchy( self ) :
+
+		sc = IECore.SceneCache( self.__testFile, IECore.IndexedIO.OpenMode.Write )
+
+		def writeHierarchy( parent, depth ) :
+
+			for i in range( 0, 4 ) :
+				child = parent.createChild( str( i ) )
+				child.writeTransform( IECore.M44dData( IECore.M44d.createTranslated( IECore.V3d( i, depth, 0 ) ) ), 0.0 )
+				if depth < 5 :
+					writeHierarchy( child, depth + 1 )
+
+		writeHierarchy( sc, 0 )
+		del sc
+
+		reader = GafferScene.SceneReader()
+		reader["fileName"].setValue( self.__testFile )
+		reader["refreshCount"].setValue( self.uniqueInt( self.__testFile ) )
+
+		# Interleaved parallel queries for many locations, of the
+		# sort which used to defeat the SceneInterface lookup caching.
+		GafferSceneTest.traverseScene( reader["out"] )
+
+		self.assertEqual( reader["out"].transform( "/3/2/1/0/3/2" ), IECore.M44f.createTranslated( IECore.V3f( 2, 5, 0 ) ) )
+		self.assertEqual( reader["out"].childNames( "/3/2/1/0/3/2" ), IECore.InternedStringVectorData() )
+		self.assertEqual( reader["out"].childNames( "/1/1" ), IECore.InternedStringVectorData( [ "0", "1", "2", "3" ] ) )
+		self.assertRaises( RuntimeError, reader["out"].transform, "/1/1/4" )
+
 	def testComputeSetInEmptyScene( self ) :
 
 		# this used to cause a crash:
@@ -0,0 +1,130 @@
+##########################################################################
+#
+#  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#      * Redistributions of source code must retain the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer.
+#
+#      * Redistributions in binary form must reproduce the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer in the documentation and/or other materials provided with
+#        the distribution.
+#
+#      * Neither the name of John Haddon nor the names of
+#        any other contributors to this software may be used to endorse or
+#        promote products derived from this software without specific prior
+#        written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import unittest
+
+import IECore
+
+import Gaffer
+import GafferTest
+import GafferScene
+import GafferSceneTest
+
+class SceneStatsTest( GafferSceneTest.SceneTestCase ) :
+
+	def __scene( self ) :
+
+		s = Gaffer.ScriptNode()
+
+		s["plane"] = GafferScene.Plane()
+		s["plane"]["divisions"].setValue( IECore.V2i( 2 ) )
+
+		s["duplicate"] = GafferScene.Duplicate()
+		s["duplicate"]["in"].setInput( s["plane"]["out"] )
+		s["duplicate"]["target"].setValue( "/plane" )
+		s["duplicate"]["copies"].setValue( 2 )
+
+		s["set"] = GafferScene.Set()
+		s["set"]["in"].setInput( s["duplicate"]["out"] )
+		s["set"]["name"].setValue( "A" )
+		s["set"]["paths"].setValue( IECore.StringVectorData( [ "/plane", "/plane1" ] ) )
+
+		return s
+
+	def testSceneAlgo( self ) :
+
+		s = self.__scene()
+		stats = GafferScene.sceneStats( s["set"]["out"] )
+
+		self.assertEqual( stats["locations"], IECore.UInt64Data( 4 ) )
+		self.assertEqual( stats["maxDepth"], IECore.IntData( 1 ) )
+
+		self.assertEqual( stats["objects"].keys(), [ "MeshPrimitive" ] )
+		meshStats = stats["objects"]["MeshPrimitive"]
+		self.assertEqual( meshStats["count"], IECore.UInt64Data( 3 ) )
+		self.assertEqual( meshStats["primitives"], IECore.UInt64Data( 12 ) )
+		self.assertEqual( meshStats["vertices"], IECore.UInt64Data( 27 ) )
+
+		# The duplicates share the same object, so its memory
+		# should only be counted once.
+		plane = s["set"]["out"].object( "/plane" )
+		self.assertEqual( meshStats["memory"], IECore.UInt64Data( plane.memoryUsage() ) )
+
+		self.assertEqual( stats["sets"]["A"], IECore.UInt64Data( 2 ) )
+
+	def testNode( self ) :
+
+		s = self.__scene()
+
+		s["stats"] = GafferScene.SceneStats()
+		s["stats"]["in"].setInput( s["set"]["out"] )
+
+		self.assertEqual( s["stats"]["stats"].getValue(), GafferScene.sceneStats( s["set"]["out"] ) )
+
+		cs = GafferTest.CapturingSlot( s["stats"].plugDirtiedSignal() )
+		s["duplicate"]["copies"].setValue( 3 )
+		self.assertTrue( s["stats"]["stats"] in [ x[0] for x in cs ] )
+
+		stats = s["stats"]["stats"].getValue()
+		self.assertEqual( stats["locations"], IECore.UInt64Data( 5 ) )
+		self.assertEqual( stats["objects"]["MeshPrimitive"]["count"], IECore.UInt64Data( 4 ) )
+
+		del cs[:]
+		s["set"]["paths"].setValue( IECore.StringVectorData( [ "/plane" ] ) )
+		self.assertTrue( s["stats"]["stats"] in [ x[0] for x in cs ] )
+		self.assertEqual( s["stats"]["stats"].getValue()["sets"]["A"], IECore.UInt64Data( 1 ) )
+
+		# Changes which don't affect the statistics shouldn't
+		# cause them to be recomputed.
+		del cs[:]
+		s["plane"]["transform"]["translate"]["x"].setValue( 10 )
+		self.assertFalse( s["stats"]["stats"] in [ x[0] for x in cs ] )
+
+	def testSerialisation( self ) :
+
+		s = self.__scene()
+		s["stats"] = GafferScene.SceneStats()
+		s["stats"]["in"].setInput( s["set"]["out"] )
+
+		s2 = Gaffer.ScriptNode()
+		s2.execute( s.serialise() )
+
+		self.assertTrue( s2["stats"]["in"].getInput().isSame( s2["set"]["out"] ) )
+		self.assertEqual( s2["stats"]["stats"].getValue(), s["stats"]["stats"].getValue() )
+
+if __name__ == "__main__":
+	unittest.main()
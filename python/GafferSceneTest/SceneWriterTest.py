@@ -97,6 +97,50 @@ class SceneWriterTest( GafferSceneTest.SceneTestCase ) :
 		self.assertEqual( t.readTransformAsMatrix( 1.5 / 24.0 ), IECore.M44d.createTranslated( IECore.V3d( 1.5, 0, 3 ) ) )
 		self.assertEqual( t.readTransformAsMatrix( 2 / 24.0 ), IECore.M44d.createTranslated( IECore.V3d( 2, 0, 4 ) ) )
 
+	def testWriteAnimationWithConcurrentFrames( self ) :
+
+		script = Gaffer.ScriptNode()
+		script["sphere"] = GafferScene.Sphere()
+		script["cube"] = GafferScene.Cube()
+		script["group"] = GafferScene.Group()
+		script["group"]["in"][0].setInput( script["sphere"]["out"] )
+		script["group"]["in"][1].setInput( script["cube"]["out"] )
+		script["xExpression"] = Gaffer.Expression()
+		script["xExpression"].setExpression( 'parent["group"]["transform"]["translate"]["x"] = context.getFrame()' )
+
+		# Make the hierarchy vary over time, so that the cube only
+		# exists on some of the frames.
+		script["filter"] = GafferScene.PathFilter()
+		script["filter"]["paths"].setValue( IECore.StringVectorData( [ "/group/cube" ] ) )
+		script["prune"] = GafferScene.Prune()
+		script["prune"]["in"].setInput( script["group"]["out"] )
+		script["prune"]["filter"].setInput( script["filter"]["out"] )
+		script["pruneExpression"] = Gaffer.Expression()
+		script["pruneExpression"].setExpression( 'parent["prune"]["enabled"] = context.getFrame() > 2' )
+
+		script["writer"] = GafferScene.SceneWriter()
+		script["writer"]["in"].setInput( script["prune"]["out"] )
+		script["writer"]["fileName"].setValue( self.temporaryDirectory() + "/test.scc" )
+
+		originalMaxFramesInFlight = GafferScene.SceneWriter.getMaxFramesInFlight()
+		try :
+			GafferScene.SceneWriter.setMaxFramesInFlight( 2 )
+			self.assertEqual( GafferScene.SceneWriter.getMaxFramesInFlight(), 2 )
+			with Gaffer.Context() :
+				script["writer"].executeSequence( [ 1, 2, 3, 4, 5 ] )
+		finally :
+			GafferScene.SceneWriter.setMaxFramesInFlight( originalMaxFramesInFlight )
+
+		sc = IECore.SceneCache( self.temporaryDirectory() + "/test.scc", IECore.IndexedIO.OpenMode.Read )
+		group = sc.child( "group" )
+
+		for frame in range( 1, 6 ) :
+			self.assertEqual( group.readTransformAsMatrix( frame / 24.0 ), IECore.M44d.createTranslated( IECore.V3d( frame, 0, 0 ) ) )
+
+		self.assertEqual( group.childNames(), [ "sphere", "cube" ] )
+		self.assertEqual( group.child( "sphere" ).numBoundSamples(), 5 )
+		self.assertEqual( group.child( "cube" ).numBoundSamples(), 2 )
+
 	def testSceneCacheRoundtrip( self ) :
 
 		scene = IECore.SceneCache( self.temporaryDirectory() + "/fromPython.scc", IECore.IndexedIO.OpenMode.Write )
@@ -143,6 +187,37 @@ class SceneWriterTest( GafferSceneTest.SceneTestCase ) :
 
 		testCacheFile( self.temporaryDirectory() + "/test.scc" )
 
+	def testWriteManyLocations( self ) :
+
+		plane = GafferScene.Plane()
+		plane["divisions"].setValue( IECore.V2i( 9 ) )
+
+		sphere = GafferScene.Sphere()
+
+		instancer = GafferScene.Instancer()
+		instancer["in"].setInput( plane["out"] )
+		instancer["parent"].setValue( "/plane" )
+		instancer["instance"].setInput( sphere["out"] )
+
+		writer = GafferScene.SceneWriter()
+		writer["in"].setInput( instancer["out"] )
+		writer["fileName"].setValue( self.temporaryDirectory() + "/test.scc" )
+
+		originalMaxLocationsInFlight = GafferScene.SceneWriter.getMaxLocationsInFlight()
+		try :
+			# A small limit forces the computation and writing
+			# of locations to be interleaved.
+			GafferScene.SceneWriter.setMaxLocationsInFlight( 4 )
+			self.assertEqual( GafferScene.SceneWriter.getMaxLocationsInFlight(), 4 )
+			writer.execute()
+		finally :
+			GafferScene.SceneWriter.setMaxLocationsInFlight( originalMaxLocationsInFlight )
+
+		reader = GafferScene.SceneReader()
+		reader["fileName"].setValue( writer["fileName"].getValue() )
+
+		self.assertScenesEqual( reader["out"], instancer["out"], childPlugNames = ( "transform", "childNames" ) )
+
 	def testHash( self ) :
 
 		c = Gaffer.Context()
@@ -194,6 +269,18 @@ class SceneWriterTest( GafferSceneTest.SceneTestCase ) :
 		writer["in"].setInput( cube["out"] )
 		self.assertNotEqual( writer.hash( c ), current )
 
+		# and by the contents of the input scene
+		current = writer.hash( c )
+		cube["dimensions"].setValue( IECore.V3f( 2 ) )
+		self.assertNotEqual( writer.hash( c ), current )
+
+		# but not by the identity of the node producing it
+		current = writer.hash( c )
+		cube2 = GafferScene.Cube()
+		cube2["dimensions"].setValue( IECore.V3f( 2 ) )
+		writer["in"].setInput( cube2["out"] )
+		self.assertEqual( writer.hash( c ), current )
+
 	def testPassThrough( self ) :
 
 		s = Gaffer.ScriptNode()
@@ -193,5 +193,62 @@ class SeedsTest( GafferSceneTest.SceneTestCase ) :
 		self.assertEqual( s["in"]["globals"].hash(), s["out"]["globals"].hash() )
 		self.assertEqual( s["in"]["globals"].getValue(), s["out"]["globals"].getValue() )
 
+	def testDeterministic( self ) :
+
+		p = GafferScene.Plane()
+		p["divisions"].setValue( IECore.V2i( 200 ) )
+
+		s = GafferScene.Seeds()
+		s["in"].setInput( p["out"] )
+		s["parent"].setValue( "/plane" )
+		s["density"].setValue( 1000 )
+
+		points = s["out"].object( "/plane/seeds" )
+		self.assertTrue( points.numPoints > 500 )
+
+		# Points should be identical each time, even though
+		# they are computed in parallel.
+		cacheMemoryLimit = Gaffer.ValuePlug.getCacheMemoryLimit()
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		try :
+			for i in range( 0, 5 ) :
+				self.assertEqual( s["out"].object( "/plane/seeds" ), points )
+		finally :
+			Gaffer.ValuePlug.setCacheMemoryLimit( cacheMemoryLimit )
+
+		for position in points["P"].data :
+			self.assertEqual( position.z, 0 )
+
+		# Points on the edges shared between triangles
+		# should only be emitted once.
+		self.assertEqual( len( set( tuple( position ) for position in points["P"].data ) ), points.numPoints )
+
+	def testDensityPrimitiveVariable( self ) :
+
+		mesh = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ), IECore.V2i( 2, 1 ) )
+		mesh["density"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Uniform, IECore.FloatVectorData( [ 0, 1 ] ) )
+
+		objectToScene = GafferScene.ObjectToScene()
+		objectToScene["object"].setValue( mesh )
+
+		s = GafferScene.Seeds()
+		s["in"].setInput( objectToScene["out"] )
+		s["parent"].setValue( "/object" )
+		s["density"].setValue( 100 )
+
+		self.assertEqual( s["densityPrimitiveVariable"].getValue(), "density" )
+		points = s["out"].object( "/object/seeds" )
+		for position in points["P"].data :
+			self.assertGreaterEqual( position.x, 0 )
+
+		# Missing variables should give a uniform distribution.
+
+		s["densityPrimitiveVariable"].setValue( "doesNotExist" )
+		numPoints = s["out"].object( "/object/seeds" ).numPoints
+		self.assertTrue( 0 < points.numPoints < numPoints )
+
+		s["densityPrimitiveVariable"].setValue( "" )
+		self.assertEqual( s["out"].object( "/object/seeds" ).numPoints, numPoints )
+
 if __name__ == "__main__":
 	unittest.main()
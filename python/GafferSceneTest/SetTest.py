@@ -237,5 +237,18 @@ class SetTest( GafferSceneTest.SceneTestCase ) :
 		self.assertEqual( set( s["out"].set( "shinyThings" ).value.paths() ), set( [ "/two", "/sphere" ] ) )
 		self.assertEqual( set( s["out"].set( "dullThings" ).value.paths() ), set( [ "/two", "/sphere" ] ) )
 
+	def testManyPaths( self ) :
+
+		paths = [ "/a/b%d/c%d" % ( i, j ) for i in range( 0, 100 ) for j in range( 0, 100 ) ]
+
+		s = GafferScene.Set()
+		s["paths"].setValue( IECore.StringVectorData( paths ) )
+
+		self.assertEqual( set( s["out"].set( "set" ).value.paths() ), set( paths ) )
+
+		paths[5000] = "/a/b*/c"
+		s["paths"].setValue( IECore.StringVectorData( paths ) )
+		self.assertRaises( RuntimeError, s["out"].set, "set" )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -179,5 +179,54 @@ class ShaderTest( GafferSceneTest.SceneTestCase ) :
 			self.assertRaisesRegexp( RuntimeError, "cycle", node.stateHash )
 			self.assertRaisesRegexp( RuntimeError, "cycle", node.state )
 
+	def testStateIsCached( self ) :
+
+		n1 = GafferSceneTest.TestShader()
+		n2 = GafferSceneTest.TestShader()
+		n2["parameters"]["i"].setInput( n1["out"]["r"] )
+		n1["parameters"]["i"].setValue( 1 )
+
+		# The network state only depends on the shader plugs, so
+		# querying it from many different locations should only
+		# hash and build the network once.
+
+		m = Gaffer.PerformanceMonitor()
+		with m :
+			for i in range( 0, 10 ) :
+				with Gaffer.Context() as c :
+					c["scene:path"] = IECore.InternedStringVectorData( [ str( i ) ] )
+					s = n2.state()
+					h = n2.stateHash()
+
+		self.assertEqual( len( s ), 2 )
+		self.assertEqual( s[0].parameters["i"], IECore.IntData( 1 ) )
+		self.assertEqual( m.plugStatistics( n2["__state"] ).hashCount, 1 )
+		self.assertEqual( m.plugStatistics( n2["__state"] ).computeCount, 1 )
+
+		# Changing an upstream parameter must dirty the cached
+		# state so that it is rebuilt.
+
+		cs = GafferTest.CapturingSlot( n2.plugDirtiedSignal() )
+		n1["parameters"]["i"].setValue( 2 )
+		self.assertTrue( n2["__state"] in [ x[0] for x in cs ] )
+
+		self.assertNotEqual( n2.stateHash(), h )
+		self.assertEqual( n2.state()[0].parameters["i"], IECore.IntData( 2 ) )
+
+	def testStateIsCopied( self ) :
+
+		n = GafferSceneTest.TestShader()
+		n["parameters"]["i"].setValue( 1 )
+
+		# The cached state must not be modifiable
+		# from python.
+
+		s = n.state()
+		s[0].parameters["i"] = IECore.IntData( 2 )
+		del s[:]
+
+		self.assertEqual( len( n.state() ), 1 )
+		self.assertEqual( n.state()[0].parameters["i"], IECore.IntData( 1 ) )
+
 if __name__ == "__main__":
 	unittest.main()
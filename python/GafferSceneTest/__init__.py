@@ -112,6 +112,8 @@ from SceneLoopTest import SceneLoopTest
 from SceneProcessorTest import SceneProcessorTest
 from MeshToPointsTest import MeshToPointsTest
 from InteractiveRenderTest import InteractiveRenderTest
+from CapturingRendererTest import CapturingRendererTest
+from SceneStatsTest import SceneStatsTest
 
 if __name__ == "__main__":
 	import unittest
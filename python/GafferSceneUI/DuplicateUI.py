@@ -117,5 +117,22 @@ Gaffer.Metadata.registerNode(
 
 		],
 
+		"encapsulateCopies" : [
+
+			"description",
+			"""
+			Outputs all the copies as a single compact object at
+			one location, rather than as a full branch per copy.
+			The target is evaluated only once and shared by all
+			the copies, so the memory and time needed to process
+			the scene are independent of the number of copies,
+			and the renderer and viewer can share a single copy
+			of the geometry. Note that only the attributes of the
+			target itself are applied to the copies, and that
+			only the target's own set memberships are transferred.
+			""",
+
+		],
+
 	}
 )
@@ -105,6 +105,62 @@ Gaffer.Metadata.registerNode(
 
 		],
 
+		"encapsulateInstances" : [
+
+			"description",
+			"""
+			Outputs all the instances as a single compact object
+			at the location specified by name, rather than as
+			one location per instance. This keeps the memory and
+			time needed to process the scene independent of
+			the number of instances, and allows the renderer and
+			viewer to share a single copy of the instanced
+			geometry. Note that the instance scene is evaluated
+			only once in this mode, so the ${instancer:id} variable
+			is not available for creating per-instance variations.
+			Only the objects and transforms of the instance scene
+			are retained - attributes and set memberships within
+			it are ignored, and all instances take the attributes
+			of the location specified by name.
+			""",
+
+		],
+
+		"orientation" : [
+
+			"description",
+			"""
+			The name of a primitive variable on the parent object,
+			of type QuatfVectorData, used to orient each instance.
+			If empty, the instances are not rotated.
+			""",
+
+		],
+
+		"scale" : [
+
+			"description",
+			"""
+			The name of a primitive variable on the parent object
+			used to scale each instance. This may be either a
+			V3fVectorData or a FloatVectorData for uniform scaling.
+			If empty, the instances are not scaled.
+			""",
+
+		],
+
+		"pivot" : [
+
+			"description",
+			"""
+			The name of a V3fVectorData primitive variable on the
+			parent object specifying the point, in the space of
+			the instance, about which it is rotated and scaled.
+			If empty, the origin of the instance is used.
+			""",
+
+		],
+
 	}
 
 )
@@ -102,7 +102,21 @@ Gaffer.Metadata.registerNode(
 
 			"plugValueWidget:type", "GafferUI.PresetsPlugValueWidget",
 
-		]
+		],
+
+		"densityPrimitiveVariable" : [
+
+			"description",
+			"""
+			The name of a float primitive variable on the mesh,
+			used to modulate the density of the points. Values
+			should be in the range 0 to 1, with 1 giving the full
+			density specified by the density plug, and 0 giving
+			no points at all. If the mesh has no such variable,
+			the points are distributed uniformly.
+			""",
+
+		],
 
 	}
 
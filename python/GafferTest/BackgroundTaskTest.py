@@ -0,0 +1,191 @@
+##########################################################################
+#
+#  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#      * Redistributions of source code must retain the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer.
+#
+#      * Redistributions in binary form must reproduce the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer in the documentation and/or other materials provided with
+#        the distribution.
+#
+#      * Neither the name of John Haddon nor the names of
+#        any other contributors to this software may be used to endorse or
+#        promote products derived from this software without specific prior
+#        written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import time
+import threading
+import unittest
+
+import IECore
+
+import Gaffer
+import GafferTest
+
+class BackgroundTaskTest( GafferTest.TestCase ) :
+
+	def testCompletion( self ) :
+
+		n = GafferTest.AddNode()
+		n["op1"].setValue( 1 )
+		n["op2"].setValue( 2 )
+
+		results = []
+		t = Gaffer.BackgroundTask( n, lambda canceller : results.append( n["sum"].getValue() ) )
+		t.wait()
+
+		self.assertTrue( t.done() )
+		self.assertEqual( results, [ 3 ] )
+
+	def testCancellation( self ) :
+
+		n = GafferTest.AddNode()
+
+		started = threading.Event()
+		def f( canceller ) :
+			started.set()
+			while not canceller.cancelled() :
+				time.sleep( 0.01 )
+
+		t = Gaffer.BackgroundTask( n, f )
+		started.wait( 10 )
+		self.assertTrue( started.is_set() )
+		self.assertFalse( t.done() )
+
+		t.cancelAndWait()
+		self.assertFalse( t.done() )
+
+	def testEditDuringCompute( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["a1"] = GafferTest.AddNode()
+		s["a2"] = GafferTest.AddNode()
+		s["a2"]["op1"].setInput( s["a1"]["sum"] )
+
+		# Both the expression and the AddNode compute in
+		# Python, so the task needs the GIL to make progress.
+		s["e"] = Gaffer.Expression()
+		s["e"].setExpression( 'parent["a1"]["op2"] = int( context.getFrame() )' )
+
+		runs = []
+		results = []
+		def f( canceller ) :
+			runs.append( s["a2"]["op2"].getValue() )
+			frame = 0
+			while not canceller.cancelled() :
+				frame += 1
+				with Gaffer.Context( s.context() ) as c :
+					c.setFrame( frame )
+					results.append( s["a2"]["sum"].getValue() )
+
+		t = Gaffer.BackgroundTask( s["a2"]["sum"], f )
+		self.__waitFor( lambda : len( results ) )
+
+		# Edits which can't affect the task shouldn't interrupt it.
+
+		s["a3"] = GafferTest.AddNode()
+		s["a3"]["op1"].setValue( 100 )
+		Gaffer.Metadata.registerNodeValue( s["a2"], "test", 10 )
+		Gaffer.Metadata.registerPlugValue( s["a2"]["op2"], "test", 10 )
+
+		time.sleep( 0.1 )
+		self.assertEqual( runs, [ 0 ] )
+		self.assertFalse( t.done() )
+
+		# But this edit must cancel and restart the task. The edit
+		# is made while holding the GIL, which must be released
+		# while waiting for the task, to avoid deadlock.
+
+		s["a2"]["op2"].setInput( s["a3"]["sum"] )
+		self.__waitFor( lambda : len( runs ) == 2 )
+		self.assertEqual( runs, [ 0, 100 ] )
+
+		# As must undo.
+
+		with Gaffer.UndoContext( s ) :
+			s["a3"]["op1"].setValue( 200 )
+		self.__waitFor( lambda : len( runs ) == 3 )
+		self.assertEqual( runs, [ 0, 100, 200 ] )
+
+		s.undo()
+		self.__waitFor( lambda : len( runs ) == 4 )
+		self.assertEqual( runs, [ 0, 100, 200, 100 ] )
+
+		t.cancelAndWait()
+
+	def testDeleteDuringCompute( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["n"] = GafferTest.AddNode()
+
+		results = []
+		def f( canceller ) :
+			frame = 0
+			while not canceller.cancelled() :
+				frame += 1
+				with Gaffer.Context( s.context() ) as c :
+					c.setFrame( frame )
+					results.append( s["n"]["sum"].getValue() )
+
+		t = Gaffer.BackgroundTask( s["n"]["sum"], f )
+		self.__waitFor( lambda : len( results ) )
+
+		# Destruction must wait for the task without
+		# deadlocking on the GIL.
+		del t
+
+	def testEditToOtherScriptDoesntBlockLaunch( self ) :
+
+		s1 = Gaffer.ScriptNode()
+		s1["n"] = GafferTest.AddNode()
+
+		s2 = Gaffer.ScriptNode()
+		s2["n"] = GafferTest.AddNode()
+		s2["n"]["op1"].setValue( 2 )
+
+		# Tasks launched in s2 while s1 is being edited
+		# should run immediately, rather than waiting for
+		# the edit to s1 to complete.
+
+		results = []
+		def plugSet( plug ) :
+			t = Gaffer.BackgroundTask( s2["n"]["sum"], lambda canceller : results.append( s2["n"]["sum"].getValue() ) )
+			t.wait()
+			self.assertTrue( t.done() )
+
+		c = s1["n"].plugSetSignal().connect( plugSet )
+		s1["n"]["op1"].setValue( 1 )
+
+		self.assertEqual( results, [ 2 ] )
+
+	def __waitFor( self, condition, timeout = 10 ) :
+
+		startTime = time.time()
+		while not condition() :
+			self.assertLess( time.time() - startTime, timeout )
+			time.sleep( 0.01 )
+
+if __name__ == "__main__":
+	unittest.main()
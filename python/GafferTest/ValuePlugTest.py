@@ -617,6 +617,33 @@ class ValuePlugTest( GafferTest.TestCase ) :
 
 		self.failUnless( n["p"] is p )
 
+	def testUncachedScope( self ) :
+
+		n = GafferTest.CachingTestNode()
+		n["in"].setValue( "uncached" )
+
+		# Values computed within an UncachedScope should not be
+		# retained in the cache, so each request must recompute.
+
+		with Gaffer.ValuePlug.UncachedScope() :
+			a1 = n["out"].getValue( _copy = False )
+			a2 = n["out"].getValue( _copy = False )
+
+		self.assertEqual( a1, IECore.StringData( "uncached" ) )
+		self.assertEqual( a2, a1 )
+		self.assertFalse( a2.isSame( a1 ) )
+
+		# Outside the scope we should get a fresh value, and
+		# that value should be cached as usual.
+
+		a3 = n["out"].getValue( _copy = False )
+		a4 = n["out"].getValue( _copy = False )
+
+		self.assertEqual( a3, a1 )
+		self.assertFalse( a3.isSame( a1 ) )
+		self.assertFalse( a3.isSame( a2 ) )
+		self.assertTrue( a4.isSame( a3 ) )
+
 	def setUp( self ) :
 
 		GafferTest.TestCase.setUp( self )
@@ -129,6 +129,7 @@ from AnimationTest import AnimationTest
 from StatsApplicationTest import StatsApplicationTest
 from DownstreamIteratorTest import DownstreamIteratorTest
 from PerformanceMonitorTest import PerformanceMonitorTest
+from BackgroundTaskTest import BackgroundTaskTest
 
 if __name__ == "__main__":
 	import unittest
@@ -39,6 +39,7 @@
 #include "IECore/RunTimeTyped.h"
 
 #include "Gaffer/Action.h"
+#include "Gaffer/BackgroundTask.h"
 #include "Gaffer/ScriptNode.h"
 
 using namespace Gaffer;
@@ -60,6 +61,8 @@ Action::~Action()
 
 void Action::enact( ActionPtr action )
 {
+	BackgroundTask::EditScope editScope( action->subject(), action->cancelsBackgroundTasks() );
+
 	ScriptNode *s = IECore::runTimeCast<ScriptNode>( action->subject() );
 	if( !s )
 	{
@@ -104,6 +107,11 @@ void Action::merge( const Action *other )
 {
 }
 
+bool Action::cancelsBackgroundTasks() const
+{
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // SimpleAction implementation and Action::enact() convenience overload.
 //////////////////////////////////////////////////////////////////////////
@@ -116,8 +124,8 @@ class SimpleAction : public Action
 
 	public :
 
-		SimpleAction( const GraphComponentPtr subject, const Function &doFn, const Function &undoFn )
-			:	m_subject( subject.get() ), m_doFn( doFn ), m_undoFn( undoFn )
+		SimpleAction( const GraphComponentPtr subject, const Function &doFn, const Function &undoFn, bool cancelsBackgroundTasks )
+			:	m_subject( subject.get() ), m_doFn( doFn ), m_undoFn( undoFn ), m_cancelsBackgroundTasks( cancelsBackgroundTasks )
 		{
 			// In the documentation for Action::enact(), we promise that we'll keep
 			// the subject alive for as long as the Functions are in use. If the subject
@@ -174,23 +182,29 @@ class SimpleAction : public Action
 		{
 		}
 
+		bool cancelsBackgroundTasks() const
+		{
+			return m_cancelsBackgroundTasks;
+		}
+
 	private :
 
 		GraphComponent *m_subject;
 		Function m_doFn;
 		Function m_undoFn;
+		bool m_cancelsBackgroundTasks;
 
 };
 
 IE_CORE_DEFINERUNTIMETYPED( SimpleAction );
 
-void Action::enact( GraphComponentPtr subject, const Function &doFn, const Function &undoFn )
+void Action::enact( GraphComponentPtr subject, const Function &doFn, const Function &undoFn, bool cancelsBackgroundTasks )
 {
 	/// \todo We might want to optimise away the construction of a SimpleAction
 	/// when we know that enact() will just call doFn and throw it away (when undo
 	/// is disabled). If we do that we should make it easy for other subclasses to do
 	/// the same.
-	enact( new SimpleAction( subject, doFn, undoFn ) );
+	enact( new SimpleAction( subject, doFn, undoFn, cancelsBackgroundTasks ) );
 }
 
 } // namespace Gaffer
@@ -0,0 +1,409 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <set>
+
+#include "tbb/mutex.h"
+
+#include "boost/bind.hpp"
+#include "boost/unordered_set.hpp"
+
+#include "IECore/MessageHandler.h"
+
+#include "Gaffer/BackgroundTask.h"
+#include "Gaffer/ScriptNode.h"
+#include "Gaffer/DependencyNode.h"
+
+using namespace Gaffer;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Tasks are identified with the script containing their subject, and
+// may only be interrupted by edits within that script. Subjects outside
+// of a script are identified by the root of their hierarchy instead.
+const GraphComponent *script( const GraphComponent *subject )
+{
+	if( const ScriptNode *s = IECore::runTimeCast<const ScriptNode>( subject ) )
+	{
+		return s;
+	}
+	if( const ScriptNode *s = subject->ancestor<ScriptNode>() )
+	{
+		return s;
+	}
+	while( subject->parent<GraphComponent>() )
+	{
+		subject = subject->parent<GraphComponent>();
+	}
+	return subject;
+}
+
+// Returns true if an edit to `actionSubject` may affect the result
+// of a task operating on `subject`. This follows the same route as
+// dirty propagation, through connections and DependencyNode::affects(),
+// erring on the side of caution where it can't be sure.
+bool affects( const GraphComponent *actionSubject, const GraphComponent *subject )
+{
+	if( actionSubject == subject || subject->isAncestorOf( actionSubject ) )
+	{
+		return true;
+	}
+
+	std::vector<const Plug *> toVisit;
+	if( const Plug *plug = IECore::runTimeCast<const Plug>( actionSubject ) )
+	{
+		toVisit.push_back( plug );
+		for( RecursivePlugIterator it( plug ); !it.done(); ++it )
+		{
+			toVisit.push_back( it->get() );
+		}
+	}
+	else if( IECore::runTimeCast<const ScriptNode>( actionSubject ) )
+	{
+		// Nodes are being added to or removed from the script. Any
+		// connections affected by a removal are broken by separate
+		// actions on the plugs in question, so we needn't worry.
+		return false;
+	}
+	else if( const Node *node = IECore::runTimeCast<const Node>( actionSubject ) )
+	{
+		// Structural edit to the node itself, such as the addition
+		// or removal of a plug. We consider any of its plugs to
+		// be affected.
+		for( RecursivePlugIterator it( node ); !it.done(); ++it )
+		{
+			toVisit.push_back( it->get() );
+		}
+	}
+	else
+	{
+		return true;
+	}
+
+	boost::unordered_set<const Plug *> visited;
+	DependencyNode::AffectedPlugsContainer affected;
+	while( !toVisit.empty() )
+	{
+		const Plug *plug = toVisit.back();
+		toVisit.pop_back();
+		if( !visited.insert( plug ).second )
+		{
+			continue;
+		}
+
+		if( plug == subject || subject->isAncestorOf( plug ) )
+		{
+			return true;
+		}
+
+		for( Plug::OutputContainer::const_iterator it = plug->outputs().begin(), eIt = plug->outputs().end(); it != eIt; ++it )
+		{
+			toVisit.push_back( *it );
+		}
+
+		// Dirtiness propagates from child plugs to their parents.
+		if( const Plug *parent = plug->parent<Plug>() )
+		{
+			toVisit.push_back( parent );
+		}
+
+		if( plug->direction() == Plug::In && plug->children().empty() )
+		{
+			if( const DependencyNode *node = IECore::runTimeCast<const DependencyNode>( plug->node() ) )
+			{
+				affected.clear();
+				try
+				{
+					node->affects( plug, affected );
+				}
+				catch( ... )
+				{
+					return true;
+				}
+				toVisit.insert( toVisit.end(), affected.begin(), affected.end() );
+			}
+		}
+	}
+
+	return false;
+}
+
+typedef std::set<BackgroundTask *> ActiveTasks;
+typedef std::map<const GraphComponent *, int> EditDepths;
+
+// Registry of all live tasks, and the current depth of
+// EditScope nesting for each script being edited. Edits
+// without a subject are counted against the NULL key, and
+// block tasks in all scripts. Both are protected by g_mutex,
+// as are the m_interrupted and m_pins members of each task.
+// Note that g_mutex is never held while waiting for a task.
+ActiveTasks g_activeTasks;
+EditDepths g_editDepths;
+tbb::mutex g_mutex;
+
+// Returns true if tasks in `script` must not be launched
+// because an edit is in progress. Must be called with
+// g_mutex held.
+bool editing( const GraphComponent *script )
+{
+	return g_editDepths.count( script ) || g_editDepths.count( NULL );
+}
+
+BackgroundTask::WaitWrapper g_waitWrapper;
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// BackgroundTask
+//////////////////////////////////////////////////////////////////////////
+
+BackgroundTask::Canceller::Canceller()
+{
+	m_cancelled = false;
+}
+
+BackgroundTask::BackgroundTask( const GraphComponent *subject, const Function &function )
+	:	m_subject( subject ), m_script( script( subject ) ), m_function( function ), m_interrupted( false ), m_pins( 0 )
+{
+	m_done = false;
+
+	tbb::mutex::scoped_lock lock( g_mutex );
+	g_activeTasks.insert( this );
+	if( editing( m_script ) )
+	{
+		// Don't start reading from the graph while
+		// it is being edited - we'll be launched by
+		// ~EditScope() instead.
+		m_interrupted = true;
+	}
+	else
+	{
+		launch();
+	}
+}
+
+BackgroundTask::~BackgroundTask()
+{
+	{
+		tbb::mutex::scoped_lock lock( g_mutex );
+		g_activeTasks.erase( this );
+	}
+	cancelAndWait();
+
+	// An EditScope on another thread may still be
+	// waiting on us, so we must not die until it
+	// is done.
+	while( true )
+	{
+		{
+			tbb::mutex::scoped_lock lock( g_mutex );
+			if( !m_pins )
+			{
+				break;
+			}
+		}
+		std::this_thread::yield();
+	}
+}
+
+void BackgroundTask::cancel()
+{
+	m_canceller.m_cancelled = true;
+}
+
+void BackgroundTask::wait()
+{
+	if( g_waitWrapper )
+	{
+		g_waitWrapper( boost::bind( &BackgroundTask::join, this ) );
+	}
+	else
+	{
+		join();
+	}
+}
+
+void BackgroundTask::cancelAndWait()
+{
+	cancel();
+	wait();
+}
+
+bool BackgroundTask::done() const
+{
+	return m_done;
+}
+
+void BackgroundTask::setWaitWrapper( const WaitWrapper &waitWrapper )
+{
+	g_waitWrapper = waitWrapper;
+}
+
+void BackgroundTask::launch()
+{
+	tbb::mutex::scoped_lock lock( m_joinMutex );
+	m_canceller.m_cancelled = false;
+	m_done = false;
+	m_interrupted = false;
+	std::thread thread( boost::bind( &BackgroundTask::run, this ) );
+	m_thread.swap( thread );
+}
+
+void BackgroundTask::run()
+{
+	try
+	{
+		m_function( m_canceller );
+	}
+	catch( const std::exception &e )
+	{
+		IECore::msg( IECore::Msg::Error, "BackgroundTask", e.what() );
+	}
+	catch( ... )
+	{
+		IECore::msg( IECore::Msg::Error, "BackgroundTask", "Unknown error" );
+	}
+	m_done = !m_canceller.cancelled();
+}
+
+void BackgroundTask::join()
+{
+	tbb::mutex::scoped_lock lock( m_joinMutex );
+	if( !m_thread.joinable() )
+	{
+		return;
+	}
+
+	if( m_thread.get_id() == std::this_thread::get_id() )
+	{
+		// A thread can't join itself, which can happen if the
+		// function destroys its own task. We detach instead so
+		// that `m_thread` isn't left joinable, which would
+		// terminate the process when it is destroyed or swapped.
+		m_thread.detach();
+	}
+	else
+	{
+		m_thread.join();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// EditScope
+//////////////////////////////////////////////////////////////////////////
+
+BackgroundTask::EditScope::EditScope( const GraphComponent *actionSubject, bool cancelTasks )
+	:	m_script( actionSubject ? script( actionSubject ) : NULL )
+{
+	// Find the tasks which might be affected, pinning them so
+	// that they stay alive after we release the lock.
+	std::vector<BackgroundTask *> candidates;
+	{
+		tbb::mutex::scoped_lock lock( g_mutex );
+		g_editDepths[m_script]++;
+
+		if( !actionSubject || !cancelTasks || g_activeTasks.empty() )
+		{
+			return;
+		}
+
+		for( ActiveTasks::const_iterator it = g_activeTasks.begin(), eIt = g_activeTasks.end(); it != eIt; ++it )
+		{
+			BackgroundTask *task = *it;
+			if( task->m_script == m_script && !task->m_interrupted )
+			{
+				task->m_pins++;
+				candidates.push_back( task );
+			}
+		}
+	}
+
+	// Cancel the affected tasks, and only then wait for them,
+	// so that they may all wind down concurrently.
+	std::vector<BackgroundTask *> affected;
+	for( std::vector<BackgroundTask *>::const_iterator it = candidates.begin(), eIt = candidates.end(); it != eIt; ++it )
+	{
+		if( affects( actionSubject, (*it)->m_subject ) )
+		{
+			(*it)->cancel();
+			affected.push_back( *it );
+		}
+	}
+
+	for( std::vector<BackgroundTask *>::const_iterator it = affected.begin(), eIt = affected.end(); it != eIt; ++it )
+	{
+		(*it)->wait();
+	}
+
+	tbb::mutex::scoped_lock lock( g_mutex );
+	for( std::vector<BackgroundTask *>::const_iterator it = affected.begin(), eIt = affected.end(); it != eIt; ++it )
+	{
+		// There's no need to rerun a task which
+		// completed before we cancelled it.
+		(*it)->m_interrupted = !(*it)->m_done;
+	}
+	for( std::vector<BackgroundTask *>::const_iterator it = candidates.begin(), eIt = candidates.end(); it != eIt; ++it )
+	{
+		(*it)->m_pins--;
+	}
+}
+
+BackgroundTask::EditScope::~EditScope()
+{
+	tbb::mutex::scoped_lock lock( g_mutex );
+	EditDepths::iterator depthIt = g_editDepths.find( m_script );
+	if( --depthIt->second )
+	{
+		return;
+	}
+	g_editDepths.erase( depthIt );
+
+	// Relaunch the tasks which were interrupted, unless an
+	// edit to their script is still in progress elsewhere.
+	for( ActiveTasks::const_iterator it = g_activeTasks.begin(), eIt = g_activeTasks.end(); it != eIt; ++it )
+	{
+		if( (*it)->m_interrupted && !editing( (*it)->m_script ) )
+		{
+			(*it)->launch();
+		}
+	}
+}
@@ -51,6 +51,7 @@ static char **environ = *_NSGetEnviron();
 #include "boost/lexical_cast.hpp"
 
 #include "IECore/SimpleTypedData.h"
+#include "IECore/VectorTypedData.h"
 
 #include "Gaffer/Context.h"
 
@@ -118,6 +119,27 @@ Environment g_environment;
 static InternedString g_frame( "frame" );
 static InternedString g_framesPerSecond( "framesPerSecond" );
 
+// Hashes InternedStringVectorData element by element, so that
+// the hash for a path can be derived incrementally from the hash
+// for its parent. See `Context::hash()`.
+static void hashData( const Data *data, MurmurHash &h )
+{
+	if( data->typeId() == InternedStringVectorDataTypeId )
+	{
+		const std::vector<InternedString> &names = static_cast<const InternedStringVectorData *>( data )->readable();
+		MurmurHash namesHash;
+		for( std::vector<InternedString>::const_iterator it = names.begin(), eIt = names.end(); it != eIt; ++it )
+		{
+			namesHash.append( it->string() );
+		}
+		h.append( namesHash );
+	}
+	else
+	{
+		data->hash( h );
+	}
+}
+
 Context::Context()
 	:	m_changedSignal( NULL ), m_hashValid( false )
 {
@@ -167,6 +189,61 @@ Context::~Context()
 	delete m_changedSignal;
 }
 
+void Context::set( const IECore::InternedString &name, const IECore::Data *value, Ownership ownership )
+{
+	set( name, value, ownership, IECore::MurmurHash() );
+}
+
+void Context::set( const IECore::InternedString &name, const IECore::Data *value, Ownership ownership, const IECore::MurmurHash &hash )
+{
+	Storage &s = m_map[name];
+	// Equal values have equal hashes, so this never
+	// invalidates a previously computed context hash.
+	s.hash = hash;
+	if( s.data == value && s.ownership == ownership )
+	{
+		return;
+	}
+
+	const bool changed = s.data != value;
+
+	// Take our reference to the new value before releasing
+	// the old one, in case they are the same object.
+	const IECore::Data *newData = value;
+	switch( ownership )
+	{
+		case Copied :
+			{
+				DataPtr valueCopy = value->copy();
+				valueCopy->addRef();
+				newData = valueCopy.get();
+				break;
+			}
+		case Shared :
+			newData->addRef();
+			break;
+		case Borrowed :
+			break;
+	}
+
+	if( s.data && s.ownership != Borrowed )
+	{
+		s.data->removeRef();
+	}
+
+	s.data = newData;
+	s.ownership = ownership;
+
+	if( changed )
+	{
+		m_hashValid = false;
+		if( m_changedSignal )
+		{
+			(*m_changedSignal)( this, name );
+		}
+	}
+}
+
 void Context::remove( const IECore::InternedString &name )
 {
 	Map::iterator it = m_map.find( name );
@@ -179,6 +256,11 @@ void Context::remove( const IECore::InternedString &name )
 
 void Context::changed( const IECore::InternedString &name )
 {
+	Map::iterator it = m_map.find( name );
+	if( it != m_map.end() )
+	{
+		it->second.hash = IECore::MurmurHash();
+	}
 	m_hashValid = false;
 	if( m_changedSignal )
 	{
@@ -260,7 +342,14 @@ IECore::MurmurHash Context::hash() const
 			continue;
 		}
 		m_hash.append( (uint64_t)&name );
-		it->second.data->hash( m_hash );
+		if( it->second.hash != IECore::MurmurHash() )
+		{
+			m_hash.append( it->second.hash );
+		}
+		else
+		{
+			hashData( it->second.data, m_hash );
+		}
 	}
 	m_hashValid = true;
 	return m_hash;
@@ -271,7 +271,10 @@ void registerInstanceValue( GraphComponent *instance, IECore::InternedString key
 		// ok to bind raw pointers to instance, because enact() guarantees
 		// the lifetime of the subject.
 		boost::bind( &registerInstanceValueAction, instance, key, value, persistent ),
-		boost::bind( &registerInstanceValueAction, instance, key, currentValue, currentPersistent )
+		boost::bind( &registerInstanceValueAction, instance, key, currentValue, currentPersistent ),
+		// Metadata doesn't affect computation, so there's
+		// no need to interrupt background tasks.
+		/* cancelsBackgroundTasks = */ false
 	);
 }
 
@@ -47,6 +47,7 @@
 #include "Gaffer/ScriptNode.h"
 #include "Gaffer/TypedPlug.h"
 #include "Gaffer/Action.h"
+#include "Gaffer/BackgroundTask.h"
 #include "Gaffer/ApplicationRoot.h"
 #include "Gaffer/Context.h"
 #include "Gaffer/StandardSet.h"
@@ -107,6 +108,7 @@ class ScriptNode::CompoundAction : public Gaffer::Action
 		{
 			for( std::vector<ActionPtr>::const_iterator it = m_actions.begin(), eIt = m_actions.end(); it != eIt; ++it )
 			{
+				BackgroundTask::EditScope editScope( (*it)->subject(), (*it)->cancelsBackgroundTasks() );
 				(*it)->doAction();
 				// we know we're only ever being redone, because the ScriptNode::addAction()
 				// performs the original Do.
@@ -118,6 +120,7 @@ class ScriptNode::CompoundAction : public Gaffer::Action
 		{
 			for( std::vector<ActionPtr>::const_reverse_iterator it = m_actions.rbegin(), eIt = m_actions.rend(); it != eIt; ++it )
 			{
+				BackgroundTask::EditScope editScope( (*it)->subject(), (*it)->cancelsBackgroundTasks() );
 				(*it)->undoAction();
 				m_subject->actionSignal()( m_subject, it->get(), Action::Undo );
 			}
@@ -415,6 +418,11 @@ void ScriptNode::undo()
 		throw IECore::Exception( "Undo not available" );
 	}
 
+	// The individual actions cancel the background tasks they affect
+	// in CompoundAction::undoAction(). This outer scope just ensures
+	// that tasks aren't restarted until the undo is complete.
+	BackgroundTask::EditScope editScope( this, /* cancelTasks = */ false );
+
 	DirtyPropagationScope dirtyPropagationScope;
 
 	m_currentActionStage = Action::Undo;
@@ -455,6 +463,9 @@ void ScriptNode::redo()
 		throw IECore::Exception( "Redo not available" );
 	}
 
+	// See comments in undo().
+	BackgroundTask::EditScope editScope( this, /* cancelTasks = */ false );
+
 	DirtyPropagationScope dirtyPropagationScope;
 
 	m_currentActionStage = Action::Redo;
@@ -35,12 +35,17 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "tbb/enumerable_thread_specific.h"
+#include "tbb/concurrent_hash_map.h"
 
 #include "boost/bind.hpp"
 #include "boost/format.hpp"
 #include "boost/unordered_map.hpp"
 
+#include "IECore/Primitive.h"
+
 #include "Gaffer/Private/IECorePreview/LRUCache.h"
 
 #include "Gaffer/ValuePlug.h"
@@ -77,6 +82,75 @@ inline const ValuePlug *sourcePlug( const ValuePlug *p )
 	return p;
 }
 
+// Primitive variable data is commonly shared between the input and output
+// primitives of a node, so charging each cached primitive for all its data
+// would count the same buffers many times over. Instead we keep a count of
+// the cache entries referencing each buffer, and only charge for a buffer
+// when it is first referenced. Because the cache holds a reference to every
+// registered buffer, a registered address can't be reused until the last
+// entry referencing it has been removed.
+//
+// The accounting is approximate in one respect : the buffer is charged to
+// the first entry only, so if that entry is evicted while others still
+// reference the buffer, the buffer goes uncharged until they are evicted too.
+typedef tbb::concurrent_hash_map<const IECore::Data *, size_t> SharedDataRegistry;
+SharedDataRegistry g_sharedDataRegistry;
+
+// Registers the data referenced by value, returning the cost to be used
+// when storing it in the cache.
+size_t registerCacheEntry( const IECore::Object *value )
+{
+	const IECore::Primitive *primitive = IECore::runTimeCast<const IECore::Primitive>( value );
+	if( !primitive )
+	{
+		return value->memoryUsage();
+	}
+
+	size_t result = primitive->memoryUsage();
+	for( IECore::PrimitiveVariableMap::const_iterator it = primitive->variables.begin(), eIt = primitive->variables.end(); it != eIt; ++it )
+	{
+		const IECore::Data *data = it->second.data.get();
+		if( !data )
+		{
+			continue;
+		}
+
+		SharedDataRegistry::accessor a;
+		if( !g_sharedDataRegistry.insert( a, data ) )
+		{
+			// Already charged to another entry.
+			result -= std::min( result, data->memoryUsage() );
+		}
+		a->second++;
+	}
+
+	return result;
+}
+
+// Must be called exactly once for each call to registerCacheEntry(),
+// when the value is no longer held by the cache.
+void deregisterCacheEntry( const IECore::Object *value )
+{
+	const IECore::Primitive *primitive = IECore::runTimeCast<const IECore::Primitive>( value );
+	if( !primitive )
+	{
+		return;
+	}
+
+	for( IECore::PrimitiveVariableMap::const_iterator it = primitive->variables.begin(), eIt = primitive->variables.end(); it != eIt; ++it )
+	{
+		const IECore::Data *data = it->second.data.get();
+		SharedDataRegistry::accessor a;
+		if( data && g_sharedDataRegistry.find( a, data ) )
+		{
+			if( --a->second == 0 )
+			{
+				g_sharedDataRegistry.erase( a );
+			}
+		}
+	}
+}
+
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -265,6 +339,16 @@ class ValuePlug::ComputeProcess : public Process
 			return g_cache.currentCost();
 		}
 
+		static void pushUncachedScope()
+		{
+			g_uncachedThreadData.local().depth++;
+		}
+
+		static void popUncachedScope()
+		{
+			g_uncachedThreadData.local().depth--;
+		}
+
 		static IECore::ConstObjectPtr value( const ValuePlug *plug, const IECore::MurmurHash *precomputedHash )
 		{
 			const ValuePlug *p = sourcePlug( plug );
@@ -295,6 +379,7 @@ class ValuePlug::ComputeProcess : public Process
 				}
 
 				// Otherwise, use a ComputeProcess instance to do the work.
+				const bool storeResult = !uncached( hash );
 				ComputeProcess process( p, plug );
 				// Store the value in the cache, after first checking that this hasn't
 				// been done already. The check is useful because it's common for an
@@ -307,9 +392,14 @@ class ValuePlug::ComputeProcess : public Process
 				// consists of many small objects for which computing memory usage is slow.
 				/// \todo Accessing the LRUCache multiple times like this does have an
 				/// overhead, and at some point we'll need to address that.
-				if( !g_cache.get( hash ) )
+				if( storeResult && !g_cache.get( hash ) )
 				{
-					g_cache.set( hash, process.m_result, process.m_result->memoryUsage() );
+					if( !g_cache.set( hash, process.m_result, registerCacheEntry( process.m_result.get() ) ) )
+					{
+						// Too costly to be stored, so the removal callback
+						// will never be called for it.
+						deregisterCacheEntry( process.m_result.get() );
+					}
 				}
 				return process.m_result;
 			}
@@ -384,6 +474,41 @@ class ValuePlug::ComputeProcess : public Process
 			return NULL;
 		}
 
+		static void cacheRemovalCallback( const IECore::MurmurHash &h, const IECore::ConstObjectPtr &value )
+		{
+			deregisterCacheEntry( value.get() );
+		}
+
+		// Returns true if the result of a compute with the specified hash should
+		// not be stored in the cache, due to an active UncachedScope. This applies
+		// to computes made directly from within the scope rather than by another
+		// process, and to any upstream computes with the same hash. The latter are
+		// common where nodes pass through their input unchanged, and would
+		// otherwise retain the value in the cache regardless.
+		static bool uncached( const IECore::MurmurHash &hash )
+		{
+			UncachedThreadData &threadData = g_uncachedThreadData.local();
+			if( !threadData.depth )
+			{
+				return false;
+			}
+			if( !Process::current() )
+			{
+				threadData.hash = hash;
+				return true;
+			}
+			return hash == threadData.hash;
+		}
+
+		struct UncachedThreadData
+		{
+			UncachedThreadData() : depth( 0 ) {}
+			int depth;
+			IECore::MurmurHash hash;
+		};
+
+		static tbb::enumerable_thread_specific<UncachedThreadData, tbb::cache_aligned_allocator<UncachedThreadData>, tbb::ets_key_per_instance> g_uncachedThreadData;
+
 		// A cache mapping from ValuePlug::hash() to the result of the previous computation
 		// for that hash. This allows us to cache results for faster repeat evaluation
 		typedef IECorePreview::LRUCache<IECore::MurmurHash, IECore::ConstObjectPtr> Cache;
@@ -394,7 +519,8 @@ class ValuePlug::ComputeProcess : public Process
 };
 
 const IECore::InternedString ValuePlug::ComputeProcess::staticType( "computeNode:compute" );
-ValuePlug::ComputeProcess::Cache ValuePlug::ComputeProcess::g_cache( nullGetter, 1024 * 1024 * 500 );
+ValuePlug::ComputeProcess::Cache ValuePlug::ComputeProcess::g_cache( nullGetter, cacheRemovalCallback, 1024 * 1024 * 500 );
+tbb::enumerable_thread_specific<ValuePlug::ComputeProcess::UncachedThreadData, tbb::cache_aligned_allocator<ValuePlug::ComputeProcess::UncachedThreadData>, tbb::ets_key_per_instance> ValuePlug::ComputeProcess::g_uncachedThreadData;
 
 //////////////////////////////////////////////////////////////////////////
 // SetValueAction implementation
@@ -794,3 +920,13 @@ size_t ValuePlug::cacheMemoryUsage()
 {
 	return ComputeProcess::cacheMemoryUsage();
 }
+
+ValuePlug::UncachedScope::UncachedScope()
+{
+	ComputeProcess::pushUncachedScope();
+}
+
+ValuePlug::UncachedScope::~UncachedScope()
+{
+	ComputeProcess::popUncachedScope();
+}
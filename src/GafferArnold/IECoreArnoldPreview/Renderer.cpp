@@ -36,6 +36,7 @@
 
 #include "tbb/compat/thread"
 #include "tbb/concurrent_vector.h"
+#include "tbb/spin_mutex.h"
 
 #include "boost/make_shared.hpp"
 #include "boost/format.hpp"
@@ -549,6 +550,82 @@ class Instance
 
 };
 
+// Prototype holding objects to be instanced, along with their hash
+// so that it needn't be recomputed for every instance. Once the
+// objects have been converted into a node which is suitable for use
+// with any attributes, the samples are released and the node is
+// held instead.
+class ArnoldPrototype : public IECoreScenePreview::Renderer::PrototypeInterface
+{
+
+	public :
+
+		ArnoldPrototype( const std::vector<const IECore::Object *> &samples, const std::vector<float> &times )
+			:	m_samples( samples.begin(), samples.end() ), m_times( times )
+		{
+			for( std::vector<const IECore::Object *>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
+			{
+				(*it)->hash( m_hash );
+			}
+			for( std::vector<float>::const_iterator it = times.begin(), eIt = times.end(); it != eIt; ++it )
+			{
+				m_hash.append( *it );
+			}
+		}
+
+		// Fills `node` if the samples have already been converted,
+		// and `samples` otherwise. Samples are returned by copying
+		// the references, so they remain valid even if they are
+		// released concurrently.
+		void get( std::vector<IECore::ConstObjectPtr> &samples, boost::shared_ptr<AtNode> &node ) const
+		{
+			tbb::spin_mutex::scoped_lock lock( m_mutex );
+			if( m_node )
+			{
+				node = m_node;
+			}
+			else
+			{
+				samples = m_samples;
+			}
+		}
+
+		// Stores a node converted from the samples, which must be
+		// suitable for instancing regardless of attributes, and
+		// releases the samples.
+		void converted( const boost::shared_ptr<AtNode> &node ) const
+		{
+			tbb::spin_mutex::scoped_lock lock( m_mutex );
+			if( !m_node )
+			{
+				m_node = node;
+				std::vector<IECore::ConstObjectPtr>().swap( m_samples );
+			}
+		}
+
+		const std::vector<float> &times() const
+		{
+			return m_times;
+		}
+
+		const IECore::MurmurHash &hash() const
+		{
+			return m_hash;
+		}
+
+	private :
+
+		// Mutable because the renderer only receives const
+		// prototypes, and conversion doesn't change the
+		// logical contents of the prototype.
+		mutable tbb::spin_mutex m_mutex;
+		mutable std::vector<IECore::ConstObjectPtr> m_samples;
+		mutable boost::shared_ptr<AtNode> m_node;
+		std::vector<float> m_times;
+		IECore::MurmurHash m_hash;
+
+};
+
 class InstanceCache : public IECore::RefCounted
 {
 
@@ -564,22 +641,57 @@ class InstanceCache : public IECore::RefCounted
 				return Instance( convert( object, arnoldAttributes ), /* instanced = */ false );
 			}
 
-			IECore::MurmurHash h = object->hash();
-			hashAttributes( object, arnoldAttributes, h );
+			return Instance( getInstanced( object, object->hash(), arnoldAttributes ), /* instanced = */ true );
+		}
 
-			Cache::accessor a;
-			m_cache.insert( a, h );
-			if( !a->second )
+		Instance get( const ArnoldPrototype *prototype, const IECoreScenePreview::Renderer::AttributesInterface *attributes )
+		{
+			std::vector<IECore::ConstObjectPtr> prototypeSamples;
+			boost::shared_ptr<AtNode> node;
+			prototype->get( prototypeSamples, node );
+			if( node )
 			{
-				a->second = convert( object, arnoldAttributes );
-				if( a->second )
+				return Instance( node, /* instanced = */ true );
+			}
+
+			const ArnoldAttributes *arnoldAttributes = static_cast<const ArnoldAttributes *>( attributes );
+			const IECore::Object *object = prototypeSamples.front().get();
+
+			std::vector<const IECore::Object *> samples; samples.reserve( prototypeSamples.size() );
+			for( std::vector<IECore::ConstObjectPtr>::const_iterator it = prototypeSamples.begin(), eIt = prototypeSamples.end(); it != eIt; ++it )
+			{
+				samples.push_back( it->get() );
+			}
+
+			if( !canInstance( object, arnoldAttributes ) )
+			{
+				if( prototype->times().empty() )
 				{
-					std::string name = "instance:" + h.toString();
-					AiNodeSetStr( a->second.get(), "name", name.c_str() );
+					return Instance( convert( object, arnoldAttributes ), /* instanced = */ false );
 				}
+				return Instance( convert( samples, prototype->times(), arnoldAttributes ), /* instanced = */ false );
 			}
 
-			return Instance( a->second, /* instanced = */ true );
+			// The prototype hash matches the hash computed by the other
+			// `get()` methods.
+			if( prototype->times().empty() )
+			{
+				node = getInstanced( object, prototype->hash(), arnoldAttributes );
+			}
+			else
+			{
+				node = getInstanced( samples, prototype->times(), prototype->hash(), arnoldAttributes );
+			}
+
+			if( node && !attributesDependent( object ) )
+			{
+				// The node can be reused for all future instances, so
+				// there is no need for the prototype to keep the samples
+				// alive.
+				prototype->converted( node );
+			}
+
+			return Instance( node, /* instanced = */ true );
 		}
 
 		Instance get( const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECoreScenePreview::Renderer::AttributesInterface *attributes )
@@ -591,30 +703,17 @@ class InstanceCache : public IECore::RefCounted
 				return Instance( convert( samples, times, arnoldAttributes ), /* instanced = */ false );
 			}
 
-			IECore::MurmurHash h;
+			IECore::MurmurHash samplesHash;
 			for( std::vector<const IECore::Object *>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
 			{
-				(*it)->hash( h );
+				(*it)->hash( samplesHash );
 			}
 			for( std::vector<float>::const_iterator it = times.begin(), eIt = times.end(); it != eIt; ++it )
 			{
-				h.append( *it );
-			}
-			hashAttributes( samples.front(), arnoldAttributes, h );
-
-			Cache::accessor a;
-			m_cache.insert( a, h );
-			if( !a->second )
-			{
-				a->second = convert( samples, times, arnoldAttributes );
-				if( a->second )
-				{
-					std::string name = "instance:" + h.toString();
-					AiNodeSetStr( a->second.get(), "name", name.c_str() );
-				}
+				samplesHash.append( *it );
 			}
 
-			return Instance( a->second, /* instanced = */ true );
+			return Instance( getInstanced( samples, times, samplesHash, arnoldAttributes ), /* instanced = */ true );
 		}
 
 		// Must not be called concurrently with anything.
@@ -639,6 +738,49 @@ class InstanceCache : public IECore::RefCounted
 
 	private :
 
+		// Gets the node for an object which is known to be instanceable,
+		// given the precomputed hash of the object.
+		boost::shared_ptr<AtNode> getInstanced( const IECore::Object *object, const IECore::MurmurHash &objectHash, const ArnoldAttributes *arnoldAttributes )
+		{
+			IECore::MurmurHash h = objectHash;
+			hashAttributes( object, arnoldAttributes, h );
+
+			Cache::accessor a;
+			m_cache.insert( a, h );
+			if( !a->second )
+			{
+				a->second = convert( object, arnoldAttributes );
+				if( a->second )
+				{
+					std::string name = "instance:" + h.toString();
+					AiNodeSetStr( a->second.get(), "name", name.c_str() );
+				}
+			}
+
+			return a->second;
+		}
+
+		// As above, but for deforming objects.
+		boost::shared_ptr<AtNode> getInstanced( const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &samplesHash, const ArnoldAttributes *arnoldAttributes )
+		{
+			IECore::MurmurHash h = samplesHash;
+			hashAttributes( samples.front(), arnoldAttributes, h );
+
+			Cache::accessor a;
+			m_cache.insert( a, h );
+			if( !a->second )
+			{
+				a->second = convert( samples, times, arnoldAttributes );
+				if( a->second )
+				{
+					std::string name = "instance:" + h.toString();
+					AiNodeSetStr( a->second.get(), "name", name.c_str() );
+				}
+			}
+
+			return a->second;
+		}
+
 		bool canInstance( const IECore::Object *object, const ArnoldAttributes *attributes )
 		{
 			if( !IECore::runTimeCast<const IECore::VisibleRenderable>( object ) )
@@ -663,6 +805,23 @@ class InstanceCache : public IECore::RefCounted
 			return true;
 		}
 
+		// Returns true if `canInstance()` or `hashAttributes()` depend
+		// on the attributes for this object.
+		bool attributesDependent( const IECore::Object *object )
+		{
+			if( !IECore::runTimeCast<const IECore::VisibleRenderable>( object ) )
+			{
+				return true;
+			}
+
+			if( const IECore::MeshPrimitive *mesh = IECore::runTimeCast<const IECore::MeshPrimitive>( object ) )
+			{
+				return mesh->interpolation() != "linear";
+			}
+
+			return false;
+		}
+
 		void hashAttributes( const IECore::Object *object, const ArnoldAttributes *attributes, IECore::MurmurHash &h )
 		{
 			if( const IECore::MeshPrimitive *mesh = IECore::runTimeCast<const IECore::MeshPrimitive>( object ) )
@@ -1089,6 +1248,29 @@ class ArnoldRenderer : public IECoreScenePreview::Renderer
 			return result;
 		}
 
+		virtual PrototypeInterfacePtr prototype( const IECore::Object *object )
+		{
+			return new ArnoldPrototype( std::vector<const IECore::Object *>( 1, object ), std::vector<float>() );
+		}
+
+		virtual PrototypeInterfacePtr prototype( const std::vector<const IECore::Object *> &samples, const std::vector<float> &times )
+		{
+			return new ArnoldPrototype( samples, times );
+		}
+
+		virtual ObjectInterfacePtr instance( const std::string &name, const PrototypeInterface *prototype, const AttributesInterface *attributes )
+		{
+			Instance instance = m_instanceCache->get( static_cast<const ArnoldPrototype *>( prototype ), attributes );
+			if( AtNode *node = instance.node() )
+			{
+				AiNodeSetStr( node, "name", name.c_str() );
+			}
+
+			ObjectInterfacePtr result = store( new ArnoldObject( instance ) );
+			result->attributes( attributes );
+			return result;
+		}
+
 		virtual void render()
 		{
 			updateCamera();
@@ -36,6 +36,7 @@
 
 #include "boost/python.hpp"
 
+#include "GafferBindings/ComputeNodeBinding.h"
 #include "GafferBindings/DependencyNodeBinding.h"
 #include "GafferDispatchBindings/TaskNodeBinding.h"
 
@@ -53,7 +54,8 @@ using namespace GafferArnold;
 BOOST_PYTHON_MODULE( _GafferArnold )
 {
 
-	GafferBindings::DependencyNodeClass<ArnoldShader>()
+	typedef GafferBindings::ComputeNodeWrapper<ArnoldShader> ArnoldShaderWrapper;
+	GafferBindings::DependencyNodeClass<ArnoldShader, ArnoldShaderWrapper>()
 		.def( "loadShader", (void (ArnoldShader::*)( const std::string & ) )&ArnoldShader::loadShader )
 	;
 
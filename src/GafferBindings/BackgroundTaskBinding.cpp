@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "boost/python.hpp"
+
+#include "IECorePython/ScopedGILLock.h"
+#include "IECorePython/ScopedGILRelease.h"
+
+#include "Gaffer/BackgroundTask.h"
+#include "Gaffer/GraphComponent.h"
+
+#include "GafferBindings/BackgroundTaskBinding.h"
+#include "GafferBindings/ExceptionAlgo.h"
+
+using namespace boost::python;
+using namespace Gaffer;
+using namespace GafferBindings;
+
+namespace
+{
+
+bool gilHeld()
+{
+#if PY_VERSION_HEX >= 0x03040000
+	return PyGILState_Check();
+#else
+	PyThreadState *threadState = PyGILState_GetThisThreadState();
+	return threadState && threadState == _PyThreadState_Current;
+#endif
+}
+
+// Installed as the BackgroundTask::WaitWrapper, so that edits and
+// task destruction initiated from Python don't deadlock waiting for
+// a task which needs the GIL itself (to evaluate a Python Expression
+// for instance).
+void waitWithGILReleased( const boost::function<void ()> &wait )
+{
+	if( Py_IsInitialized() && gilHeld() )
+	{
+		IECorePython::ScopedGILRelease gilRelease;
+		wait();
+	}
+	else
+	{
+		wait();
+	}
+}
+
+void deleteObject( object *o )
+{
+	IECorePython::ScopedGILLock gilLock;
+	delete o;
+}
+
+// Adaptor for calling a Python callable as the BackgroundTask::Function.
+// The callable is held via a shared_ptr so that copies of the adaptor
+// can be made and destroyed without holding the GIL.
+class PythonFunction
+{
+
+	public :
+
+		PythonFunction( object function )
+			:	m_function( new object( function ), deleteObject )
+		{
+		}
+
+		void operator()( const BackgroundTask::Canceller &canceller ) const
+		{
+			IECorePython::ScopedGILLock gilLock;
+			try
+			{
+				(*m_function)( ptr( const_cast<BackgroundTask::Canceller *>( &canceller ) ) );
+			}
+			catch( const error_already_set & )
+			{
+				translatePythonException();
+			}
+		}
+
+	private :
+
+		boost::shared_ptr<object> m_function;
+
+};
+
+BackgroundTask *construct( GraphComponentPtr subject, object function )
+{
+	return new BackgroundTask( subject.get(), PythonFunction( function ) );
+}
+
+} // namespace
+
+void GafferBindings::bindBackgroundTask()
+{
+
+	BackgroundTask::setWaitWrapper( waitWithGILReleased );
+
+	scope s = class_<BackgroundTask, boost::noncopyable>( "BackgroundTask", no_init )
+		.def( "__init__", make_constructor( construct ) )
+		.def( "cancel", &BackgroundTask::cancel )
+		// No need to release the GIL here, since
+		// `waitWithGILReleased()` takes care of it.
+		.def( "wait", &BackgroundTask::wait )
+		.def( "cancelAndWait", &BackgroundTask::cancelAndWait )
+		.def( "done", &BackgroundTask::done )
+	;
+
+	class_<BackgroundTask::Canceller, boost::noncopyable>( "Canceller", no_init )
+		.def( "cancelled", &BackgroundTask::Canceller::cancelled )
+	;
+
+}
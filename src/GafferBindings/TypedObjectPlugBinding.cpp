@@ -53,4 +53,5 @@ void GafferBindings::bindTypedObjectPlug()
 	GafferBindings::TypedObjectPlugClass<Gaffer::Color3fVectorDataPlug>();
 	GafferBindings::TypedObjectPlugClass<Gaffer::ObjectVectorPlug>();
 	GafferBindings::TypedObjectPlugClass<Gaffer::CompoundObjectPlug>();
+	GafferBindings::TypedObjectPlugClass<Gaffer::AtomicCompoundDataPlug>();
 }
@@ -37,6 +37,7 @@
 
 #include "boost/python.hpp"
 #include "boost/format.hpp"
+#include "boost/scoped_ptr.hpp"
 
 #include "Gaffer/ValuePlug.h"
 #include "Gaffer/Node.h"
@@ -72,6 +73,33 @@ static std::string repr( const ValuePlug *plug )
 	return ValuePlugSerialiser::repr( plug );
 }
 
+namespace
+{
+
+// Allows UncachedScope to be used via Python's `with` statement.
+class UncachedScopeWrapper : boost::noncopyable
+{
+
+	public :
+
+		void enter()
+		{
+			m_scope.reset( new ValuePlug::UncachedScope );
+		}
+
+		void exit( object type, object value, object traceBack )
+		{
+			m_scope.reset();
+		}
+
+	private :
+
+		boost::scoped_ptr<ValuePlug::UncachedScope> m_scope;
+
+};
+
+} // namespace
+
 std::string ValuePlugSerialiser::repr( const Gaffer::ValuePlug *plug, unsigned flagsMask, const std::string &extraArguments, const Serialisation *serialisation )
 {
 	std::string result = Serialisation::classPath( plug ) + "( \"" + plug->getName().string() + "\", ";
@@ -269,7 +297,7 @@ bool ValuePlugSerialiser::valueNeedsSerialisation( const Gaffer::ValuePlug *plug
 
 void GafferBindings::bindValuePlug()
 {
-	PlugClass<ValuePlug, PlugWrapper<ValuePlug> >()
+	scope s = PlugClass<ValuePlug, PlugWrapper<ValuePlug> >()
 		.def( boost::python::init<const std::string &, Plug::Direction, unsigned>(
 				(
 					boost::python::arg_( "name" ) = GraphComponent::defaultName<ValuePlug>(),
@@ -293,5 +321,10 @@ void GafferBindings::bindValuePlug()
 		.def( "__repr__", &repr )
 	;
 
+	class_<UncachedScopeWrapper, boost::noncopyable>( "UncachedScope" )
+		.def( "__enter__", &UncachedScopeWrapper::enter, return_self<>() )
+		.def( "__exit__", &UncachedScopeWrapper::exit )
+	;
+
 	Serialisation::registerSerialiser( Gaffer::ValuePlug::staticTypeId(), new ValuePlugSerialiser );
 }
@@ -40,6 +40,7 @@
 
 #include "Gaffer/StringPlug.h"
 
+#include "GafferBindings/ComputeNodeBinding.h"
 #include "GafferBindings/DependencyNodeBinding.h"
 #include "GafferBindings/DataBinding.h"
 
@@ -109,7 +110,8 @@ int oslLibraryVersionCode()
 BOOST_PYTHON_MODULE( _GafferOSL )
 {
 
-	GafferBindings::DependencyNodeClass<OSLShader>()
+	typedef GafferBindings::ComputeNodeWrapper<OSLShader> OSLShaderWrapper;
+	GafferBindings::DependencyNodeClass<OSLShader, OSLShaderWrapper>()
 		.def( "loadShader", &OSLShader::loadShader, ( arg_( "shaderName" ), arg_( "keepExistingValues" ) = false ) )
 		.def( "shaderMetadata", &shaderMetadata, ( boost::python::arg_( "_copy" ) = true ) )
 		.def( "parameterMetadata", &parameterMetadata, ( boost::python::arg_( "plug" ), boost::python::arg_( "_copy" ) = true ) )
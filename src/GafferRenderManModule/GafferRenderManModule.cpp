@@ -40,6 +40,7 @@
 
 #include "Gaffer/StringPlug.h"
 
+#include "GafferBindings/ComputeNodeBinding.h"
 #include "GafferBindings/DependencyNodeBinding.h"
 #include "GafferBindings/NodeBinding.h"
 
@@ -93,7 +94,8 @@ void loadLightShader( RenderManLight &light, const std::string &shaderName )
 BOOST_PYTHON_MODULE( _GafferRenderMan )
 {
 
-	GafferBindings::DependencyNodeClass<RenderManShader>()
+	typedef GafferBindings::ComputeNodeWrapper<RenderManShader> RenderManShaderWrapper;
+	GafferBindings::DependencyNodeClass<RenderManShader, RenderManShaderWrapper>()
 		.def( "loadShader", &loadShader, ( arg_( "shaderName" ), arg_( "keepExistingValues" ) = false ) )
 		.def( "shaderLoader", &RenderManShader::shaderLoader, return_value_policy<reference_existing_object>() )
 		.staticmethod( "shaderLoader" )
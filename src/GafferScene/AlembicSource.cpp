@@ -35,7 +35,12 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/concurrent_queue.h"
+#include "tbb/task_scheduler_init.h"
+
 #include "boost/bind.hpp"
+#include "boost/functional/hash.hpp"
+#include "boost/unordered_map.hpp"
 
 #include "IECore/LRUCache.h"
 #include "IECore/Renderable.h"
@@ -54,7 +59,12 @@ using namespace GafferScene;
 IE_CORE_DEFINERUNTIMETYPED( AlembicSource );
 
 //////////////////////////////////////////////////////////////////////////
-// Implementation of an LRUCache of FileIndexedIOs.
+// Implementation of an LRUCache of ArchivePools.
+//
+// Alembic serialises concurrent reads from a single archive, so to
+// allow parallel reads from the same file, we keep a pool of independent
+// archives for each file. Each compute leases an archive from the pool
+// for its exclusive use, and returns it to the pool when it is done.
 //////////////////////////////////////////////////////////////////////////
 
 namespace GafferScene
@@ -63,20 +73,163 @@ namespace GafferScene
 namespace Detail
 {
 
-AlembicInputPtr alembicInputGetter( const std::string &fileName, size_t &cost )
+struct ScenePathHash
+{
+	size_t operator()( const ScenePlug::ScenePath &path ) const
+	{
+		size_t result = 0;
+		for( ScenePlug::ScenePath::const_iterator it = path.begin(), eIt = path.end(); it != eIt; ++it )
+		{
+			// InternedStrings are unique, so we can just
+			// hash the address of the string.
+			boost::hash_combine( result, it->c_str() );
+		}
+		return result;
+	}
+};
+
+// A single archive, along with a cache of the AlembicInputs
+// for the locations within it. Because each archive is only
+// used by one thread at a time, the cache needs no locking.
+class Archive : public IECore::RefCounted
+{
+
+	public :
+
+		Archive( const std::string &fileName )
+			:	m_root( new AlembicInput( fileName ) )
+		{
+		}
+
+		AlembicInputPtr input( const ScenePlug::ScenePath &path )
+		{
+			if( path.empty() )
+			{
+				return m_root;
+			}
+
+			InputCache::const_iterator it = m_inputCache.find( path );
+			if( it != m_inputCache.end() )
+			{
+				return it->second;
+			}
+
+			if( m_inputCache.size() >= g_maxInputCacheSize )
+			{
+				m_inputCache.clear();
+			}
+
+			// Resolve from the parent, which is likely to be cached
+			// already, rather than from the root.
+			const ScenePlug::ScenePath parentPath( path.begin(), path.end() - 1 );
+			AlembicInputPtr result = input( parentPath )->child( path.back().value() );
+			m_inputCache[path] = result;
+			return result;
+		}
+
+	private :
+
+		static const size_t g_maxInputCacheSize = 10000;
+
+		AlembicInputPtr m_root;
+		typedef boost::unordered_map<ScenePlug::ScenePath, AlembicInputPtr, ScenePathHash> InputCache;
+		InputCache m_inputCache;
+
+};
+
+IE_CORE_DECLAREPTR( Archive )
+
+class ArchivePool : public IECore::RefCounted
+{
+
+	public :
+
+		ArchivePool( const std::string &fileName )
+			:	m_fileName( fileName )
+		{
+		}
+
+		ArchivePtr acquire()
+		{
+			ArchivePtr result;
+			if( !m_available.try_pop( result ) )
+			{
+				result = new Archive( m_fileName );
+			}
+			return result;
+		}
+
+		void release( ArchivePtr archive )
+		{
+			// Keep no more archives than there are threads to use them.
+			static const size_t maxSize = tbb::task_scheduler_init::default_num_threads();
+			if( m_available.unsafe_size() < maxSize )
+			{
+				m_available.push( archive );
+			}
+		}
+
+	private :
+
+		const std::string m_fileName;
+		tbb::concurrent_queue<ArchivePtr> m_available;
+
+};
+
+IE_CORE_DECLAREPTR( ArchivePool )
+
+ArchivePoolPtr archivePoolGetter( const std::string &fileName, size_t &cost )
 {
 	cost = 1;
-	return new AlembicInput( fileName );
+	return new ArchivePool( fileName );
 }
 
-typedef LRUCache<std::string, AlembicInputPtr> AlembicInputCache;
+typedef LRUCache<std::string, ArchivePoolPtr> ArchivePoolCache;
 
-AlembicInputCache *alembicInputCache()
+ArchivePoolCache *archivePoolCache()
 {
-	static AlembicInputCache *c = new AlembicInputCache( alembicInputGetter, 200 );
+	static ArchivePoolCache *c = new ArchivePoolCache( archivePoolGetter, 200 );
 	return c;
 }
 
+// Leases an Archive from the pool for the lifetime
+// of the lease.
+class ArchiveLease : boost::noncopyable
+{
+
+	public :
+
+		ArchiveLease( const std::string &fileName )
+		{
+			if( fileName.size() )
+			{
+				m_pool = archivePoolCache()->get( fileName );
+				m_archive = m_pool->acquire();
+			}
+		}
+
+		~ArchiveLease()
+		{
+			if( m_archive )
+			{
+				m_pool->release( m_archive );
+			}
+		}
+
+		// Returns the input for the specified path, or
+		// NULL if no file has been specified.
+		AlembicInputPtr input( const ScenePlug::ScenePath &path )
+		{
+			return m_archive ? m_archive->input( path ) : AlembicInputPtr();
+		}
+
+	private :
+
+		ArchivePoolPtr m_pool;
+		ArchivePtr m_archive;
+
+};
+
 } // namespace Detail
 
 } // namespace GafferScene
@@ -139,7 +292,7 @@ void AlembicSource::plugSet( Gaffer::Plug *plug )
 {
 	if( plug == refreshCountPlug() )
 	{
-		alembicInputCache()->clear();
+		archivePoolCache()->clear();
 	}
 }
 
@@ -156,19 +309,24 @@ void AlembicSource::hashBound( const ScenePath &path, const Gaffer::Context *con
 
 Imath::Box3f AlembicSource::computeBound( const ScenePath &path, const Gaffer::Context *context, const ScenePlug *parent ) const
 {
-	if( AlembicInputPtr i = inputForPath( path ) )
 	{
+		ArchiveLease lease( fileNamePlug()->getValue() );
+		AlembicInputPtr i = lease.input( path );
+		if( !i )
+		{
+			return Box3f();
+		}
 		if( i->hasStoredBound() )
 		{
 			Box3d b = i->boundAtTime( context->getTime() );
 			return Box3f( b.min, b.max );
 		}
-		else
-		{
-			return unionOfTransformedChildBounds( path, parent );
-		}
 	}
-	return Box3f();
+
+	// Computing the child bounds requires further computes, so
+	// we do this outside the scope of the lease, to leave the
+	// archive available for them.
+	return unionOfTransformedChildBounds( path, parent );
 }
 
 void AlembicSource::hashTransform( const ScenePath &path, const Gaffer::Context *context, const ScenePlug *parent, IECore::MurmurHash &h ) const
@@ -185,7 +343,8 @@ void AlembicSource::hashTransform( const ScenePath &path, const Gaffer::Context
 Imath::M44f AlembicSource::computeTransform( const ScenePath &path, const Gaffer::Context *context, const ScenePlug *parent ) const
 {
 	M44f result;
-	if( AlembicInputPtr i = inputForPath( path ) )
+	ArchiveLease lease( fileNamePlug()->getValue() );
+	if( AlembicInputPtr i = lease.input( path ) )
 	{
 		M44d t = i->transformAtTime( context->getTime() );
 		/// \todo Maybe we should be using doubles for bounds and transforms anyway?
@@ -224,7 +383,8 @@ void AlembicSource::hashObject( const ScenePath &path, const Gaffer::Context *co
 IECore::ConstObjectPtr AlembicSource::computeObject( const ScenePath &path, const Gaffer::Context *context, const ScenePlug *parent ) const
 {
 	ConstObjectPtr result = parent->objectPlug()->defaultValue();
-	if( AlembicInputPtr i = inputForPath( path ) )
+	ArchiveLease lease( fileNamePlug()->getValue() );
+	if( AlembicInputPtr i = lease.input( path ) )
 	{
 		/// \todo Maybe template objectAtTime and then we don't need the cast.
 		ConstRenderablePtr renderable = runTimeCast<Renderable>( i->objectAtTime( context->getTime(), IECore::RenderableTypeId ) );
@@ -248,7 +408,8 @@ void AlembicSource::hashChildNames( const ScenePath &path, const Gaffer::Context
 
 IECore::ConstInternedStringVectorDataPtr AlembicSource::computeChildNames( const ScenePath &path, const Gaffer::Context *context, const ScenePlug *parent ) const
 {
-	if( AlembicInputPtr i = inputForPath( path ) )
+	ArchiveLease lease( fileNamePlug()->getValue() );
+	if( AlembicInputPtr i = lease.input( path ) )
 	{
 		ConstStringVectorDataPtr c = i->childNames();
 		InternedStringVectorDataPtr result = new InternedStringVectorData;
@@ -291,20 +452,3 @@ GafferScene::ConstPathMatcherDataPtr AlembicSource::computeSet( const IECore::In
 	/// \todo Support conversion from Alembic collections.
 	return parent->setPlug()->defaultValue();
 }
-
-IECoreAlembic::AlembicInputPtr AlembicSource::inputForPath( const ScenePath &path ) const
-{
-	const std::string fileName = fileNamePlug()->getValue();
-	if( !fileName.size() )
-	{
-		return NULL;
-	}
-
-	AlembicInputPtr result = Detail::alembicInputCache()->get( fileName );
-	for( ScenePath::const_iterator it = path.begin(), eIt = path.end(); it != eIt; it++ )
-	{
-		result = result->child( it->value() );
-	}
-
-	return result;
-}
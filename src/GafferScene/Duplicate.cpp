@@ -34,12 +34,17 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "IECore/VisibleRenderable.h"
+
+#include "Gaffer/Context.h"
 #include "Gaffer/StringAlgo.h"
 #include "Gaffer/StringPlug.h"
 
 #include "GafferScene/Duplicate.h"
+#include "GafferScene/EncapsulatedInstances.h"
 
 using namespace std;
+using namespace Imath;
 using namespace IECore;
 using namespace Gaffer;
 using namespace GafferScene;
@@ -58,6 +63,7 @@ Duplicate::Duplicate( const std::string &name )
 	addChild( new IntPlug( "copies", Plug::In, 1, 0 ) );
 	addChild( new StringPlug( "name" ) );
 	addChild( new TransformPlug( "transform" ) );
+	addChild( new BoolPlug( "encapsulateCopies" ) );
 	addChild( new StringPlug( "__outParent", Plug::Out ) );
 	addChild( new InternedStringVectorDataPlug( "__outChildNames", Plug::Out, inPlug()->childNamesPlug()->defaultValue() ) );
 
@@ -115,30 +121,57 @@ const Gaffer::TransformPlug *Duplicate::transformPlug() const
 	return getChild<TransformPlug>( g_firstPlugIndex + 3 );
 }
 
+Gaffer::BoolPlug *Duplicate::encapsulateCopiesPlug()
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 4 );
+}
+
+const Gaffer::BoolPlug *Duplicate::encapsulateCopiesPlug() const
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 4 );
+}
+
 Gaffer::StringPlug *Duplicate::outParentPlug()
 {
-	return getChild<StringPlug>( g_firstPlugIndex + 4 );
+	return getChild<StringPlug>( g_firstPlugIndex + 5 );
 }
 
 const Gaffer::StringPlug *Duplicate::outParentPlug() const
 {
-	return getChild<StringPlug>( g_firstPlugIndex + 4 );
+	return getChild<StringPlug>( g_firstPlugIndex + 5 );
 }
 
 Gaffer::InternedStringVectorDataPlug *Duplicate::childNamesPlug()
 {
-	return getChild<InternedStringVectorDataPlug>( g_firstPlugIndex + 5 );
+	return getChild<InternedStringVectorDataPlug>( g_firstPlugIndex + 6 );
 }
 
 const Gaffer::InternedStringVectorDataPlug *Duplicate::childNamesPlug() const
 {
-	return getChild<InternedStringVectorDataPlug>( g_firstPlugIndex + 5 );
+	return getChild<InternedStringVectorDataPlug>( g_firstPlugIndex + 6 );
 }
 
 void Duplicate::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	BranchCreator::affects( input, outputs );
 
+	if(
+		input == inPlug()->transformPlug() ||
+		input == inPlug()->childNamesPlug()
+	)
+	{
+		// Encapsulated copies contain the
+		// whole target hierarchy.
+		outputs.push_back( outPlug()->objectPlug() );
+	}
+
+	if( input == inPlug()->transformPlug() )
+	{
+		// The bound of the encapsulated copies
+		// depends on the target transform.
+		outputs.push_back( outPlug()->boundPlug() );
+	}
+
 	if( input == targetPlug() )
 	{
 		outputs.push_back( outParentPlug() );
@@ -155,10 +188,22 @@ void Duplicate::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outp
 	else if( input == childNamesPlug() )
 	{
 		outputs.push_back( outPlug()->childNamesPlug() );
+		outputs.push_back( outPlug()->boundPlug() );
+		outputs.push_back( outPlug()->objectPlug() );
 	}
 	else if( transformPlug()->isAncestorOf( input ) )
 	{
 		outputs.push_back( outPlug()->transformPlug() );
+		outputs.push_back( outPlug()->boundPlug() );
+		outputs.push_back( outPlug()->objectPlug() );
+	}
+	else if( input == encapsulateCopiesPlug() )
+	{
+		outputs.push_back( outPlug()->boundPlug() );
+		outputs.push_back( outPlug()->transformPlug() );
+		outputs.push_back( outPlug()->objectPlug() );
+		outputs.push_back( outPlug()->childNamesPlug() );
+		outputs.push_back( outPlug()->setPlug() );
 	}
 }
 
@@ -265,18 +310,52 @@ void Duplicate::hashBranchBound( const ScenePath &parentPath, const ScenePath &b
 {
 	ScenePath source;
 	sourcePath( branchPath, source );
-	h = inPlug()->boundHash( source );
+	if( encapsulateCopiesPlug()->getValue() )
+	{
+		// Bound of all the encapsulated copies
+		BranchCreator::hashBranchBound( parentPath, branchPath, context, h );
+		h.append( inPlug()->boundHash( source ) );
+		h.append( inPlug()->transformHash( source ) );
+		transformPlug()->hash( h );
+		childNamesPlug()->hash( h );
+	}
+	else
+	{
+		h = inPlug()->boundHash( source );
+	}
 }
 
 Imath::Box3f Duplicate::computeBranchBound( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context ) const
 {
 	ScenePath source;
 	sourcePath( branchPath, source );
+	if( encapsulateCopiesPlug()->getValue() )
+	{
+		const Box3f targetBound = inPlug()->bound( source );
+		vector<M44f> transforms;
+		copyTransforms( source, transforms );
+
+		Box3f result;
+		for( vector<M44f>::const_iterator it = transforms.begin(), eIt = transforms.end(); it != eIt; ++it )
+		{
+			result.extendBy( Imath::transform( targetBound, *it ) );
+		}
+		return result;
+	}
 	return inPlug()->bound( source );
 }
 
 void Duplicate::hashBranchTransform( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
+	if( encapsulateCopiesPlug()->getValue() )
+	{
+		// The copy transforms are held in the encapsulated
+		// object, so the location itself has an identity
+		// transform.
+		BranchCreator::hashBranchTransform( parentPath, branchPath, context, h );
+		return;
+	}
+
 	ScenePath source;
 	sourcePath( branchPath, source );
 	if( branchPath.size() == 1 )
@@ -295,6 +374,11 @@ void Duplicate::hashBranchTransform( const ScenePath &parentPath, const ScenePat
 
 Imath::M44f Duplicate::computeBranchTransform( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context ) const
 {
+	if( encapsulateCopiesPlug()->getValue() )
+	{
+		return M44f();
+	}
+
 	ScenePath source;
 	sourcePath( branchPath, source );
 	Imath::M44f result = inPlug()->transform( source );
@@ -331,13 +415,49 @@ void Duplicate::hashBranchObject( const ScenePath &parentPath, const ScenePath &
 {
 	ScenePath source;
 	sourcePath( branchPath, source );
-	h = inPlug()->objectHash( source );
+	if( encapsulateCopiesPlug()->getValue() )
+	{
+		BranchCreator::hashBranchObject( parentPath, branchPath, context, h );
+		h.append( inPlug()->transformHash( source ) );
+		transformPlug()->hash( h );
+		childNamesPlug()->hash( h );
+		// The encapsulated copies contain the whole
+		// target hierarchy.
+		h.append( inPlug()->hierarchyHash( source ) );
+	}
+	else
+	{
+		h = inPlug()->objectHash( source );
+	}
 }
 
 IECore::ConstObjectPtr Duplicate::computeBranchObject( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context ) const
 {
 	ScenePath source;
 	sourcePath( branchPath, source );
+	if( encapsulateCopiesPlug()->getValue() )
+	{
+		M44fVectorDataPtr instanceTransformsData = new M44fVectorData;
+		copyTransforms( source, instanceTransformsData->writable() );
+
+		IntVectorDataPtr instanceIdsData = new IntVectorData;
+		vector<int> &instanceIds = instanceIdsData->writable();
+		instanceIds.resize( instanceTransformsData->readable().size() );
+		for( size_t i = 0; i < instanceIds.size(); ++i )
+		{
+			instanceIds[i] = i;
+		}
+
+		ObjectVectorPtr prototypes = new ObjectVector;
+		StringVectorDataPtr prototypeNames = new StringVectorData;
+		M44fVectorDataPtr prototypeTransforms = new M44fVectorData;
+
+		ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+		Context::Scope scopedContext( tmpContext.get() );
+		prototypesWalk( tmpContext.get(), source, source.size(), M44f(), prototypes.get(), prototypeNames->writable(), prototypeTransforms->writable() );
+
+		return new EncapsulatedInstances( prototypes, prototypeNames, prototypeTransforms, instanceTransformsData, instanceIdsData );
+	}
 	return inPlug()->object( source );
 }
 
@@ -346,6 +466,16 @@ void Duplicate::hashBranchChildNames( const ScenePath &parentPath, const ScenePa
 	if( branchPath.size() == 0 )
 	{
 		h = childNamesPlug()->hash();
+		if( encapsulateCopiesPlug()->getValue() )
+		{
+			// Differentiate from the full list
+			// of child names.
+			h.append( true );
+		}
+	}
+	else if( encapsulateCopiesPlug()->getValue() )
+	{
+		h = outPlug()->childNamesPlug()->defaultValue()->Object::hash();
 	}
 	else
 	{
@@ -359,7 +489,20 @@ IECore::ConstInternedStringVectorDataPtr Duplicate::computeBranchChildNames( con
 {
 	if( branchPath.size() == 0 )
 	{
-		return childNamesPlug()->getValue();
+		ConstInternedStringVectorDataPtr childNamesData = childNamesPlug()->getValue();
+		if( encapsulateCopiesPlug()->getValue() && childNamesData->readable().size() > 1 )
+		{
+			// All the copies are held at the location
+			// which would otherwise hold the first.
+			InternedStringVectorDataPtr result = new InternedStringVectorData;
+			result->writable().push_back( childNamesData->readable().front() );
+			return result;
+		}
+		return childNamesData;
+	}
+	else if( encapsulateCopiesPlug()->getValue() )
+	{
+		return outPlug()->childNamesPlug()->defaultValue();
 	}
 	else
 	{
@@ -374,6 +517,7 @@ void Duplicate::hashBranchSet( const ScenePath &parentPath, const IECore::Intern
 	h.append( inPlug()->setHash( setName ) );
 	targetPlug()->hash( h );
 	childNamesPlug()->hash( h );
+	encapsulateCopiesPlug()->hash( h );
 }
 
 GafferScene::ConstPathMatcherDataPtr Duplicate::computeBranchSet( const ScenePath &parentPath, const IECore::InternedString &setName, const Gaffer::Context *context ) const
@@ -396,6 +540,19 @@ GafferScene::ConstPathMatcherDataPtr Duplicate::computeBranchSet( const ScenePat
 
 	PathMatcherDataPtr resultData = new PathMatcherData;
 	PathMatcher &result = resultData->writable();
+
+	if( encapsulateCopiesPlug()->getValue() )
+	{
+		// Locations within the target don't exist in the
+		// output, so only membership of the target itself
+		// can be transferred to the encapsulated copies.
+		if( childNames.size() && ( subTree.match( ScenePath() ) & Filter::ExactMatch ) )
+		{
+			result.addPath( ScenePath( 1, childNames.front() ) );
+		}
+		return resultData;
+	}
+
 	ScenePath prefix( 1 );
 	for( vector<InternedString>::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; ++it )
 	{
@@ -412,3 +569,50 @@ void Duplicate::sourcePath( const ScenePath &branchPath, ScenePath &source ) con
 	ScenePlug::stringToPath( targetPlug()->getValue(), source );
 	copy( ++branchPath.begin(), branchPath.end(), back_inserter( source ) );
 }
+
+void Duplicate::copyTransforms( const ScenePath &target, std::vector<Imath::M44f> &transforms ) const
+{
+	const M44f matrix = transformPlug()->matrix();
+	ConstInternedStringVectorDataPtr childNamesData = childNamesPlug()->getValue();
+
+	transforms.resize( childNamesData->readable().size() );
+	M44f transform = inPlug()->transform( target );
+	for( vector<M44f>::iterator it = transforms.begin(), eIt = transforms.end(); it != eIt; ++it )
+	{
+		transform = transform * matrix;
+		*it = transform;
+	}
+}
+
+void Duplicate::prototypesWalk( Gaffer::Context *context, ScenePath &path, size_t rootSize, const Imath::M44f &parentTransform, IECore::ObjectVector *prototypes, std::vector<std::string> &names, std::vector<Imath::M44f> &transforms ) const
+{
+	context->set( ScenePlug::scenePathContextName, path );
+
+	M44f transform = parentTransform;
+	if( path.size() > rootSize )
+	{
+		transform = inPlug()->transformPlug()->getValue() * parentTransform;
+	}
+
+	ConstObjectPtr object = inPlug()->objectPlug()->getValue();
+	if( runTimeCast<const VisibleRenderable>( object.get() ) )
+	{
+		// The const_pointer_cast is ok because the prototypes
+		// are never modified once they have been placed in the
+		// EncapsulatedInstances object.
+		prototypes->members().push_back( boost::const_pointer_cast<Object>( object ) );
+		std::string name;
+		ScenePlug::pathToString( ScenePath( path.begin() + rootSize, path.end() ), name );
+		names.push_back( name );
+		transforms.push_back( transform );
+	}
+
+	ConstInternedStringVectorDataPtr childNamesData = inPlug()->childNamesPlug()->getValue();
+	const vector<InternedString> &childNames = childNamesData->readable();
+	for( vector<InternedString>::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; ++it )
+	{
+		path.push_back( *it );
+		prototypesWalk( context, path, rootSize, transform, prototypes, names, transforms );
+		path.pop_back();
+	}
+}
@@ -0,0 +1,255 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "OpenEXR/ImathBoxAlgo.h"
+
+#include "IECore/Renderer.h"
+
+#include "GafferScene/EncapsulatedInstances.h"
+
+using namespace std;
+using namespace Imath;
+using namespace IECore;
+using namespace GafferScene;
+
+namespace
+{
+
+IndexedIO::EntryID g_prototypesEntry( "prototypes" );
+IndexedIO::EntryID g_prototypeNamesEntry( "prototypeNames" );
+IndexedIO::EntryID g_prototypeTransformsEntry( "prototypeTransforms" );
+IndexedIO::EntryID g_instanceTransformsEntry( "instanceTransforms" );
+IndexedIO::EntryID g_instanceIdsEntry( "instanceIds" );
+
+} // namespace
+
+IE_CORE_DEFINEOBJECTTYPEDESCRIPTION( EncapsulatedInstances );
+
+const unsigned int EncapsulatedInstances::m_ioVersion = 0;
+
+EncapsulatedInstances::EncapsulatedInstances()
+	:	m_prototypes( new ObjectVector ),
+		m_prototypeNames( new StringVectorData ),
+		m_prototypeTransforms( new M44fVectorData ),
+		m_instanceTransforms( new M44fVectorData ),
+		m_instanceIds( new IntVectorData )
+{
+}
+
+EncapsulatedInstances::EncapsulatedInstances(
+	IECore::ConstObjectVectorPtr prototypes,
+	IECore::ConstStringVectorDataPtr prototypeNames,
+	IECore::ConstM44fVectorDataPtr prototypeTransforms,
+	IECore::ConstM44fVectorDataPtr instanceTransforms,
+	IECore::ConstIntVectorDataPtr instanceIds
+)
+	:	m_prototypes( prototypes ),
+		m_prototypeNames( prototypeNames ),
+		m_prototypeTransforms( prototypeTransforms ),
+		m_instanceTransforms( instanceTransforms ),
+		m_instanceIds( instanceIds )
+{
+	const size_t numPrototypes = m_prototypes->members().size();
+	if( m_prototypeNames->readable().size() != numPrototypes || m_prototypeTransforms->readable().size() != numPrototypes )
+	{
+		throw IECore::InvalidArgumentException( "EncapsulatedInstances : Prototype names and transforms must match the number of prototypes" );
+	}
+
+	for( ObjectVector::MemberContainer::const_iterator it = m_prototypes->members().begin(), eIt = m_prototypes->members().end(); it != eIt; ++it )
+	{
+		if( !runTimeCast<const VisibleRenderable>( it->get() ) )
+		{
+			throw IECore::InvalidArgumentException( "EncapsulatedInstances : Prototypes must be VisibleRenderables" );
+		}
+	}
+
+	if( m_instanceIds->readable().size() != m_instanceTransforms->readable().size() )
+	{
+		throw IECore::InvalidArgumentException( "EncapsulatedInstances : Instance ids must match the number of instance transforms" );
+	}
+}
+
+const IECore::ObjectVector *EncapsulatedInstances::prototypes() const
+{
+	return m_prototypes.get();
+}
+
+const IECore::StringVectorData *EncapsulatedInstances::prototypeNames() const
+{
+	return m_prototypeNames.get();
+}
+
+const IECore::M44fVectorData *EncapsulatedInstances::prototypeTransforms() const
+{
+	return m_prototypeTransforms.get();
+}
+
+const IECore::M44fVectorData *EncapsulatedInstances::instanceTransforms() const
+{
+	return m_instanceTransforms.get();
+}
+
+const IECore::IntVectorData *EncapsulatedInstances::instanceIds() const
+{
+	return m_instanceIds.get();
+}
+
+size_t EncapsulatedInstances::numInstances() const
+{
+	return m_instanceTransforms->readable().size();
+}
+
+void EncapsulatedInstances::render( IECore::Renderer *renderer ) const
+{
+	const vector<M44f> &instanceTransforms = m_instanceTransforms->readable();
+	const vector<M44f> &prototypeTransforms = m_prototypeTransforms->readable();
+	const ObjectVector::MemberContainer &prototypes = m_prototypes->members();
+
+	for( vector<M44f>::const_iterator it = instanceTransforms.begin(), eIt = instanceTransforms.end(); it != eIt; ++it )
+	{
+		renderer->attributeBegin();
+		renderer->concatTransform( *it );
+		for( size_t i = 0, e = prototypes.size(); i < e; ++i )
+		{
+			renderer->attributeBegin();
+			renderer->concatTransform( prototypeTransforms[i] );
+			static_cast<const VisibleRenderable *>( prototypes[i].get() )->render( renderer );
+			renderer->attributeEnd();
+		}
+		renderer->attributeEnd();
+	}
+}
+
+Imath::Box3f EncapsulatedInstances::bound() const
+{
+	const Box3f b = prototypeBound();
+	if( b.isEmpty() )
+	{
+		return b;
+	}
+
+	Box3f result;
+	const vector<M44f> &instanceTransforms = m_instanceTransforms->readable();
+	for( vector<M44f>::const_iterator it = instanceTransforms.begin(), eIt = instanceTransforms.end(); it != eIt; ++it )
+	{
+		result.extendBy( transform( b, *it ) );
+	}
+	return result;
+}
+
+Imath::Box3f EncapsulatedInstances::prototypeBound() const
+{
+	Box3f result;
+	const vector<M44f> &prototypeTransforms = m_prototypeTransforms->readable();
+	const ObjectVector::MemberContainer &prototypes = m_prototypes->members();
+	for( size_t i = 0, e = prototypes.size(); i < e; ++i )
+	{
+		const Box3f b = static_cast<const VisibleRenderable *>( prototypes[i].get() )->bound();
+		result.extendBy( transform( b, prototypeTransforms[i] ) );
+	}
+	return result;
+}
+
+void EncapsulatedInstances::copyFrom( const IECore::Object *other, IECore::Object::CopyContext *context )
+{
+	VisibleRenderable::copyFrom( other, context );
+	const EncapsulatedInstances *tOther = static_cast<const EncapsulatedInstances *>( other );
+	m_prototypes = context->copy<ObjectVector>( tOther->m_prototypes.get() );
+	m_prototypeNames = context->copy<StringVectorData>( tOther->m_prototypeNames.get() );
+	m_prototypeTransforms = context->copy<M44fVectorData>( tOther->m_prototypeTransforms.get() );
+	m_instanceTransforms = context->copy<M44fVectorData>( tOther->m_instanceTransforms.get() );
+	m_instanceIds = context->copy<IntVectorData>( tOther->m_instanceIds.get() );
+}
+
+void EncapsulatedInstances::save( IECore::Object::SaveContext *context ) const
+{
+	VisibleRenderable::save( context );
+	IndexedIOPtr container = context->container( staticTypeName(), m_ioVersion );
+	context->save( m_prototypes.get(), container.get(), g_prototypesEntry );
+	context->save( m_prototypeNames.get(), container.get(), g_prototypeNamesEntry );
+	context->save( m_prototypeTransforms.get(), container.get(), g_prototypeTransformsEntry );
+	context->save( m_instanceTransforms.get(), container.get(), g_instanceTransformsEntry );
+	context->save( m_instanceIds.get(), container.get(), g_instanceIdsEntry );
+}
+
+void EncapsulatedInstances::load( IECore::Object::LoadContextPtr context )
+{
+	VisibleRenderable::load( context );
+	unsigned int v = m_ioVersion;
+	ConstIndexedIOPtr container = context->container( staticTypeName(), v );
+	m_prototypes = context->load<ObjectVector>( container.get(), g_prototypesEntry );
+	m_prototypeNames = context->load<StringVectorData>( container.get(), g_prototypeNamesEntry );
+	m_prototypeTransforms = context->load<M44fVectorData>( container.get(), g_prototypeTransformsEntry );
+	m_instanceTransforms = context->load<M44fVectorData>( container.get(), g_instanceTransformsEntry );
+	m_instanceIds = context->load<IntVectorData>( container.get(), g_instanceIdsEntry );
+}
+
+bool EncapsulatedInstances::isEqualTo( const IECore::Object *other ) const
+{
+	if( !VisibleRenderable::isEqualTo( other ) )
+	{
+		return false;
+	}
+
+	const EncapsulatedInstances *tOther = static_cast<const EncapsulatedInstances *>( other );
+	return
+		*m_prototypes == *tOther->m_prototypes &&
+		*m_prototypeNames == *tOther->m_prototypeNames &&
+		*m_prototypeTransforms == *tOther->m_prototypeTransforms &&
+		*m_instanceTransforms == *tOther->m_instanceTransforms &&
+		*m_instanceIds == *tOther->m_instanceIds
+	;
+}
+
+void EncapsulatedInstances::memoryUsage( IECore::Object::MemoryAccumulator &a ) const
+{
+	VisibleRenderable::memoryUsage( a );
+	a.accumulate( m_prototypes.get() );
+	a.accumulate( m_prototypeNames.get() );
+	a.accumulate( m_prototypeTransforms.get() );
+	a.accumulate( m_instanceTransforms.get() );
+	a.accumulate( m_instanceIds.get() );
+}
+
+void EncapsulatedInstances::hash( IECore::MurmurHash &h ) const
+{
+	VisibleRenderable::hash( h );
+	m_prototypes->hash( h );
+	m_prototypeNames->hash( h );
+	m_prototypeTransforms->hash( h );
+	m_instanceTransforms->hash( h );
+	m_instanceIds->hash( h );
+}
@@ -95,7 +95,9 @@ IECore::MurmurHash ExecutableRender::hash( const Gaffer::Context *context ) cons
 
 	Context::Scope scope( context );
 	IECore::MurmurHash h = TaskNode::hash( context );
-	/// \todo hash the actual scene when we have a hierarchyHash
+	/// \todo Consider hashing the actual scene using ScenePlug::hierarchyHash().
+	/// That doesn't account for the globals or sets, which a render also
+	/// depends on, so for now we just hash the identity of the scene plug.
 	h.append( (uint64_t)scenePlug );
 	h.append( context->hash() );
 
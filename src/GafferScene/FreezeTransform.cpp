@@ -41,6 +41,7 @@
 #include "Gaffer/Context.h"
 
 #include "GafferScene/FreezeTransform.h"
+#include "GafferScene/Private/IECoreScenePreview/PrimitiveAlgo.h"
 
 using namespace std;
 using namespace Imath;
@@ -234,7 +235,10 @@ IECore::ConstObjectPtr FreezeTransform::computeObject( const ScenePath &path, co
 			return inputObject;
 		}
 
-		PrimitivePtr outputPrimitive = inputPrimitive->copy();
+		// Share the input data rather than holding copies of it. The
+		// variables we transform are given their own copies below.
+		PrimitivePtr outputPrimitive = IECoreScenePreview::PrimitiveAlgo::copyTopology( inputPrimitive );
+		outputPrimitive->variables = inputPrimitive->variables;
 
 		/// \todo This is a pain - we need functionality in Cortex to just automatically apply
 		/// the transform to all appropriate primitive variables, without having to manually
@@ -246,6 +250,7 @@ IECore::ConstObjectPtr FreezeTransform::computeObject( const ScenePath &path, co
 			if( despatchTraitsTest<TypeTraits::IsFloatVec3VectorTypedData>( it->second.data.get() ) )
 			{
 				primVarNames.push_back( it->first );
+				outputPrimitive->variables[it->first].data = it->second.data->copy();
 			}
 		}
 
@@ -35,8 +35,12 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/parallel_for.h"
+
 #include "boost/lexical_cast.hpp"
 #include "boost/regex.hpp"
+#include "boost/unordered_set.hpp"
+#include "boost/unordered_map.hpp"
 
 #include "OpenEXR/ImathBoxAlgo.h"
 
@@ -57,6 +61,125 @@ using namespace IECore;
 using namespace Gaffer;
 using namespace GafferScene;
 
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// InternedStrings are unique, so we can hash
+// them cheaply using the address of the string.
+struct InternedStringHash
+{
+
+	size_t operator()( const InternedString &s ) const
+	{
+		return boost::hash<const void *>()( s.c_str() );
+	}
+
+};
+
+typedef boost::unordered_set<InternedString, InternedStringHash> NameSet;
+
+// Fetches the child names at the root of each input.
+struct InputChildNames
+{
+
+	InputChildNames( const ArrayPlug *inPlugs, const Context *context, vector<ConstInternedStringVectorDataPtr> &childNames )
+		:	m_inPlugs( inPlugs ), m_context( context ), m_childNames( childNames )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		ContextPtr tmpContext = new Context( *m_context, Context::Borrowed );
+		tmpContext->set( ScenePlug::scenePathContextName, ScenePlug::ScenePath() );
+		Context::Scope scopedContext( tmpContext.get() );
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			m_childNames[i] = m_inPlugs->getChild<ScenePlug>( i )->childNamesPlug()->getValue();
+		}
+	}
+
+	private :
+
+		const ArrayPlug *m_inPlugs;
+		const Context *m_context;
+		vector<ConstInternedStringVectorDataPtr> &m_childNames;
+
+};
+
+// Fetches the set from each input and renames the children of the root
+// according to the forward mapping. Subtrees are shared with the input
+// sets rather than copied, and inputs without any renamed children are
+// shared in their entirety.
+struct InputSets
+{
+
+	InputSets( const ArrayPlug *inPlugs, const ObjectVector *forwardMappings, const Context *context, vector<PathMatcher> &sets )
+		:	m_inPlugs( inPlugs ), m_forwardMappings( forwardMappings ), m_context( context ), m_sets( sets )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		Context::Scope scopedContext( m_context );
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			ConstPathMatcherDataPtr inputSetData = m_inPlugs->getChild<ScenePlug>( i )->setPlug()->getValue();
+			const PathMatcher &inputSet = inputSetData->readable();
+			const CompoundDataMap &forwardMapping = static_cast<const CompoundData *>( m_forwardMappings->members()[i].get() )->readable();
+
+			if( forwardMapping.empty() && !( inputSet.match( ScenePlug::ScenePath() ) & Filter::ExactMatch ) )
+			{
+				m_sets[i] = inputSet;
+				continue;
+			}
+
+			PathMatcher &set = m_sets[i];
+			vector<InternedString> outputPath( 1 );
+			for( PathMatcher::RawIterator pIt = inputSet.begin(), peIt = inputSet.end(); pIt != peIt; ++pIt )
+			{
+				const vector<InternedString> &inputPath = *pIt;
+				if( !inputPath.size() )
+				{
+					// Skip root.
+					continue;
+				}
+				assert( inputPath.size() == 1 );
+
+				CompoundDataMap::const_iterator mIt = forwardMapping.find( inputPath[0] );
+				if( mIt != forwardMapping.end() )
+				{
+					outputPath[0] = static_cast<const InternedStringData *>( mIt->second.get() )->readable();
+				}
+				else
+				{
+					outputPath[0] = inputPath[0];
+				}
+				set.addPaths( inputSet.subTree( inputPath ), outputPath );
+
+				pIt.prune(); // We only want to visit the first level
+			}
+		}
+	}
+
+	private :
+
+		const ArrayPlug *m_inPlugs;
+		const ObjectVector *m_forwardMappings;
+		const Context *m_context;
+		vector<PathMatcher> &m_sets;
+
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Group
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( Group );
 
 size_t Group::g_firstPlugIndex = 0;
@@ -431,39 +554,19 @@ GafferScene::ConstPathMatcherDataPtr Group::computeSet( const IECore::InternedSt
 	ConstCompoundObjectPtr mapping = boost::static_pointer_cast<const CompoundObject>( mappingPlug()->getValue() );
 	const ObjectVector *forwardMappings = mapping->member<ObjectVector>( "__GroupForwardMappings", true /* throw if missing */ );
 
+	// Fetch and rename the input sets in parallel.
+	vector<PathMatcher> inputSets( inPlugs()->children().size() );
+	InputSets inputSetsFunctor( inPlugs(), forwardMappings, context, inputSets );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, inputSets.size() ), inputSetsFunctor );
+
+	// Then merge them into the result. This adds references
+	// to the input subtrees rather than copying them.
 	PathMatcherDataPtr resultData = new PathMatcherData;
 	PathMatcher &result = resultData->writable();
-	for( size_t i = 0, e = inPlugs()->children().size(); i < e; i++ )
+	const vector<InternedString> prefix( 1, groupName );
+	for( vector<PathMatcher>::const_iterator it = inputSets.begin(), eIt = inputSets.end(); it != eIt; ++it )
 	{
-		ConstPathMatcherDataPtr inputSetData = inPlugs()->getChild<ScenePlug>( i )->setPlug()->getValue();
-		const PathMatcher &inputSet = inputSetData->readable();
-
-		const CompoundData *forwardMapping = static_cast<const IECore::CompoundData *>( forwardMappings->members()[i].get() );
-
-		// We want our outputSet to reference the data within inputSet rather
-		// than do an expensive copy. This is complicated slightly by the fact
-		// that we may need to rename the children of the root according to the
-		// forwardMapping object. Here we do that by taking subtrees of the input
-		// and adding them to our output under a renamed prefix.
-		for( PathMatcher::RawIterator pIt = inputSet.begin(), peIt = inputSet.end(); pIt != peIt; ++pIt )
-		{
-			const vector<InternedString> &inputPath = *pIt;
-			if( !inputPath.size() )
-			{
-				// Skip root.
-				continue;
-			}
-			assert( inputPath.size() == 1 );
-
-			const InternedStringData *outputName = forwardMapping->member<InternedStringData>( inputPath[0], /* throwExceptions = */ true );
-
-			vector<InternedString> prefix;
-			prefix.push_back( groupName );
-			prefix.push_back( outputName->readable() );
-			result.addPaths( inputSet.subTree( inputPath ), prefix );
-
-			pIt.prune(); // We only want to visit the first level
-		}
+		result.addPaths( *it, prefix );
 	}
 
 	return resultData;
@@ -485,14 +588,30 @@ IECore::ObjectPtr Group::computeMapping( const Gaffer::Context *context ) const
 	boost::regex namePrefixSuffixRegex( "^(.*[^0-9]+)([0-9]+)$" );
 	boost::format namePrefixSuffixFormatter( "%s%d" );
 
-	set<InternedString> allNames;
-	for( ScenePlugIterator it( inPlugs() ); !it.done(); ++it )
-	{
-		ConstInternedStringVectorDataPtr inChildNamesData = (*it)->childNames( ScenePath() );
+	// Fetch the input child names in parallel.
+	vector<ConstInternedStringVectorDataPtr> inputChildNames( inPlugs()->children().size() );
+	InputChildNames inputChildNamesFunctor( inPlugs(), context, inputChildNames );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, inputChildNames.size() ), inputChildNamesFunctor );
+
+	// Names are never removed from allNames, so once we have found a
+	// suffix to be in use for a particular prefix it will remain so. We
+	// record a range of used suffixes per prefix so that we can skip over
+	// them, rather than searching from the start every time we uniqueify
+	// a name. Otherwise many inputs with the same names would have
+	// quadratic cost.
+	NameSet allNames;
+	typedef boost::unordered_map<string, pair<int, int> > UsedSuffixes;
+	UsedSuffixes usedSuffixes;
+
+	for( size_t i = 0, e = inputChildNames.size(); i < e; ++i )
+	{
+		// The forward mapping only contains entries for names which
+		// have been changed, so that computeSet() can pass through
+		// input sets untouched when there are no changes.
 		CompoundDataPtr forwardMapping = new CompoundData;
 		forwardMappings->members().push_back( forwardMapping );
 
-		const vector<InternedString> &inChildNames = inChildNamesData->readable();
+		const vector<InternedString> &inChildNames = inputChildNames[i]->readable();
 		for( vector<InternedString>::const_iterator cIt = inChildNames.begin(), ceIt = inChildNames.end(); cIt!=ceIt; cIt++ )
 		{
 			InternedString name = *cIt;
@@ -512,20 +631,37 @@ IECore::ObjectPtr Group::computeMapping( const Gaffer::Context *context ) const
 					suffix = boost::lexical_cast<int>( match[2] );
 				}
 
+				const int firstSuffix = suffix;
+				UsedSuffixes::iterator uIt = usedSuffixes.find( prefix );
+				if( uIt != usedSuffixes.end() && suffix >= uIt->second.first && suffix < uIt->second.second )
+				{
+					suffix = uIt->second.second;
+				}
+
 				do
 				{
 					name = boost::str( namePrefixSuffixFormatter % prefix % suffix );
 					suffix++;
 				} while( allNames.find( name ) != allNames.end() );
+
+				if( uIt != usedSuffixes.end() && firstSuffix >= uIt->second.first && firstSuffix <= uIt->second.second )
+				{
+					uIt->second.second = suffix;
+				}
+				else
+				{
+					usedSuffixes[prefix] = make_pair( firstSuffix, suffix );
+				}
+
+				forwardMapping->writable()[*cIt] = new InternedStringData( name );
 			}
 
 			allNames.insert( name );
 			childNames.push_back( name );
-			forwardMapping->writable()[*cIt] = new InternedStringData( name );
 
 			CompoundObjectPtr entry = new CompoundObject;
 			entry->members()["n"] = new InternedStringData( *cIt );
-			entry->members()["i"] = new IntData( it.base() - inPlugs()->children().begin() );
+			entry->members()["i"] = new IntData( i );
 			result->members()[name] = entry;
 		}
 	}
@@ -0,0 +1,317 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "GafferScene/Private/IECoreScenePreview/CapturingRenderer.h"
+
+using namespace std;
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScenePreview;
+
+//////////////////////////////////////////////////////////////////////////
+// ObjectHandle
+//////////////////////////////////////////////////////////////////////////
+
+class CapturingRenderer::ObjectHandle : public ObjectInterface
+{
+
+	public :
+
+		ObjectHandle( CapturingRenderer *renderer, CapturedObject *object )
+			:	m_renderer( renderer ), m_object( object )
+		{
+		}
+
+		virtual ~ObjectHandle()
+		{
+			m_renderer->release( m_object.get() );
+		}
+
+		virtual void transform( const Imath::M44f &transform )
+		{
+			m_object->transform( vector<M44f>( 1, transform ), vector<float>() );
+		}
+
+		virtual void transform( const std::vector<Imath::M44f> &samples, const std::vector<float> &times )
+		{
+			m_object->transform( samples, times );
+		}
+
+		virtual void attributes( const AttributesInterface *attributes )
+		{
+			if( m_renderer->m_renderType != Interactive )
+			{
+				throw IECore::Exception( "Attributes may only be edited in Interactive mode" );
+			}
+			m_object->attributes( attributes );
+		}
+
+	private :
+
+		CapturingRenderer *m_renderer;
+		CapturedObjectPtr m_object;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// CapturingRenderer
+//////////////////////////////////////////////////////////////////////////
+
+Renderer::TypeDescription<CapturingRenderer> CapturingRenderer::g_typeDescription( "Capturing" );
+
+CapturingRenderer::CapturingRenderer( RenderType renderType, const std::string &fileName )
+	:	m_renderType( renderType )
+{
+	m_numAttributesCalls = 0;
+}
+
+CapturingRenderer::~CapturingRenderer()
+{
+	// Release batch objects while the object
+	// map still exists for them to remove
+	// themselves from.
+	m_batchObjects.clear();
+}
+
+const IECore::Data *CapturingRenderer::capturedOption( const IECore::InternedString &name ) const
+{
+	OptionMap::const_iterator it = m_options.find( name );
+	return it != m_options.end() ? it->second.get() : NULL;
+}
+
+const Renderer::Output *CapturingRenderer::capturedOutput( const IECore::InternedString &name ) const
+{
+	OutputMap::const_iterator it = m_outputs.find( name );
+	return it != m_outputs.end() ? it->second.get() : NULL;
+}
+
+CapturingRenderer::CapturedObjectPtr CapturingRenderer::capturedObject( const std::string &name ) const
+{
+	ObjectMap::const_accessor a;
+	if( m_capturedObjects.find( a, name ) )
+	{
+		return a->second;
+	}
+	return NULL;
+}
+
+size_t CapturingRenderer::numCapturedObjects() const
+{
+	return m_capturedObjects.size();
+}
+
+size_t CapturingRenderer::numAttributesCalls() const
+{
+	return m_numAttributesCalls;
+}
+
+void CapturingRenderer::option( const IECore::InternedString &name, const IECore::Data *value )
+{
+	if( value )
+	{
+		m_options[name] = value->copy();
+	}
+	else
+	{
+		m_options.erase( name );
+	}
+}
+
+void CapturingRenderer::output( const IECore::InternedString &name, const Output *output )
+{
+	if( output )
+	{
+		m_outputs[name] = output->copy();
+	}
+	else
+	{
+		m_outputs.erase( name );
+	}
+}
+
+Renderer::AttributesInterfacePtr CapturingRenderer::attributes( const IECore::CompoundObject *attributes )
+{
+	++m_numAttributesCalls;
+	return new CapturedAttributes( attributes );
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::camera( const std::string &name, const IECore::Camera *camera, const AttributesInterface *attributes )
+{
+	return capture( name, vector<const Object *>( 1, camera ), vector<float>(), attributes );
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::light( const std::string &name, const IECore::Object *object, const AttributesInterface *attributes )
+{
+	return capture( name, vector<const Object *>( 1, object ), vector<float>(), attributes );
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::object( const std::string &name, const IECore::Object *object, const AttributesInterface *attributes )
+{
+	return capture( name, vector<const Object *>( 1, object ), vector<float>(), attributes );
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::object( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const AttributesInterface *attributes )
+{
+	return capture( name, samples, times, attributes );
+}
+
+void CapturingRenderer::render()
+{
+}
+
+void CapturingRenderer::pause()
+{
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::capture( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const AttributesInterface *attributes )
+{
+	CapturedObjectPtr capturedObject = new CapturedObject( name, samples, times, attributes );
+	{
+		// If an object with the same name already exists,
+		// the new object replaces it in the map.
+		ObjectMap::accessor a;
+		m_capturedObjects.insert( a, name );
+		a->second = capturedObject;
+	}
+
+	ObjectInterfacePtr result = new ObjectHandle( this, capturedObject.get() );
+
+	if( m_renderType != Interactive )
+	{
+		m_batchObjects.push_back( result );
+	}
+
+	return result;
+}
+
+void CapturingRenderer::release( const CapturedObject *object )
+{
+	ObjectMap::accessor a;
+	if( m_capturedObjects.find( a, object->name() ) && a->second == object )
+	{
+		m_capturedObjects.erase( a );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// CapturedAttributes
+//////////////////////////////////////////////////////////////////////////
+
+CapturingRenderer::CapturedAttributes::CapturedAttributes( const IECore::CompoundObject *attributes )
+	:	m_attributes( attributes )
+{
+}
+
+CapturingRenderer::CapturedAttributes::~CapturedAttributes()
+{
+}
+
+const IECore::CompoundObject *CapturingRenderer::CapturedAttributes::attributes() const
+{
+	return m_attributes.get();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// CapturedObject
+//////////////////////////////////////////////////////////////////////////
+
+CapturingRenderer::CapturedObject::CapturedObject( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const AttributesInterface *attributes )
+	:	m_name( name ), m_capturedSamples( samples.begin(), samples.end() ), m_capturedSampleTimes( times ),
+		m_capturedAttributes( static_cast<const CapturedAttributes *>( attributes ) ), m_numTransformEdits( 0 ), m_numAttributeEdits( 0 )
+{
+}
+
+CapturingRenderer::CapturedObject::~CapturedObject()
+{
+}
+
+const std::string &CapturingRenderer::CapturedObject::name() const
+{
+	return m_name;
+}
+
+const std::vector<IECore::ConstObjectPtr> &CapturingRenderer::CapturedObject::capturedSamples() const
+{
+	return m_capturedSamples;
+}
+
+const std::vector<float> &CapturingRenderer::CapturedObject::capturedSampleTimes() const
+{
+	return m_capturedSampleTimes;
+}
+
+std::vector<Imath::M44f> CapturingRenderer::CapturedObject::capturedTransforms() const
+{
+	Mutex::scoped_lock lock( m_mutex );
+	return m_capturedTransforms;
+}
+
+std::vector<float> CapturingRenderer::CapturedObject::capturedTransformTimes() const
+{
+	Mutex::scoped_lock lock( m_mutex );
+	return m_capturedTransformTimes;
+}
+
+CapturingRenderer::ConstCapturedAttributesPtr CapturingRenderer::CapturedObject::capturedAttributes() const
+{
+	Mutex::scoped_lock lock( m_mutex );
+	return m_capturedAttributes;
+}
+
+int CapturingRenderer::CapturedObject::numTransformEdits() const
+{
+	return m_numTransformEdits;
+}
+
+int CapturingRenderer::CapturedObject::numAttributeEdits() const
+{
+	return m_numAttributeEdits;
+}
+
+void CapturingRenderer::CapturedObject::transform( const std::vector<Imath::M44f> &samples, const std::vector<float> &times )
+{
+	Mutex::scoped_lock lock( m_mutex );
+	m_capturedTransforms = samples;
+	m_capturedTransformTimes = times;
+	++m_numTransformEdits;
+}
+
+void CapturingRenderer::CapturedObject::attributes( const AttributesInterface *attributes )
+{
+	Mutex::scoped_lock lock( m_mutex );
+	m_capturedAttributes = static_cast<const CapturedAttributes *>( attributes );
+	++m_numAttributeEdits;
+}
@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "GafferScene/Private/IECoreScenePreview/Renderer.h"
+
+using namespace IECoreScenePreview;
+
+//////////////////////////////////////////////////////////////////////////
+// NullRenderer
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/// A renderer which discards everything it is given. This is useful
+/// for benchmarking the output of scenes in isolation from the cost of
+/// any actual renderer.
+class NullRenderer : public Renderer
+{
+
+	public :
+
+		NullRenderer( RenderType renderType, const std::string &fileName )
+		{
+		}
+
+		virtual void option( const IECore::InternedString &name, const IECore::Data *value )
+		{
+		}
+
+		virtual void output( const IECore::InternedString &name, const Output *output )
+		{
+		}
+
+		virtual AttributesInterfacePtr attributes( const IECore::CompoundObject *attributes )
+		{
+			return new NullAttributes;
+		}
+
+		virtual ObjectInterfacePtr camera( const std::string &name, const IECore::Camera *camera, const AttributesInterface *attributes )
+		{
+			return new NullObject;
+		}
+
+		virtual ObjectInterfacePtr light( const std::string &name, const IECore::Object *object, const AttributesInterface *attributes )
+		{
+			return new NullObject;
+		}
+
+		virtual ObjectInterfacePtr object( const std::string &name, const IECore::Object *object, const AttributesInterface *attributes )
+		{
+			return new NullObject;
+		}
+
+		virtual ObjectInterfacePtr object( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const AttributesInterface *attributes )
+		{
+			return new NullObject;
+		}
+
+		virtual void render()
+		{
+		}
+
+		virtual void pause()
+		{
+		}
+
+	private :
+
+		class NullAttributes : public AttributesInterface
+		{
+		};
+
+		class NullObject : public ObjectInterface
+		{
+
+			public :
+
+				virtual void transform( const Imath::M44f &transform )
+				{
+				}
+
+				virtual void transform( const std::vector<Imath::M44f> &samples, const std::vector<float> &times )
+				{
+				}
+
+				virtual void attributes( const AttributesInterface *attributes )
+				{
+				}
+
+		};
+
+		static Renderer::TypeDescription<NullRenderer> g_typeDescription;
+
+};
+
+Renderer::TypeDescription<NullRenderer> NullRenderer::g_typeDescription( "Null" );
+
+} // namespace
@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECore/MeshPrimitive.h"
+#include "IECore/PointsPrimitive.h"
+#include "IECore/CurvesPrimitive.h"
+
+#include "GafferScene/Private/IECoreScenePreview/PrimitiveAlgo.h"
+
+using namespace IECore;
+using namespace IECoreScenePreview;
+
+PrimitivePtr PrimitiveAlgo::copyTopology( const Primitive *primitive )
+{
+	PrimitivePtr result;
+	if( const MeshPrimitive *mesh = runTimeCast<const MeshPrimitive>( primitive ) )
+	{
+		result = new MeshPrimitive( mesh->verticesPerFace(), mesh->vertexIds(), mesh->interpolation() );
+	}
+	else if( const PointsPrimitive *points = runTimeCast<const PointsPrimitive>( primitive ) )
+	{
+		result = new PointsPrimitive( points->getNumPoints() );
+	}
+	else if( const CurvesPrimitive *curves = runTimeCast<const CurvesPrimitive>( primitive ) )
+	{
+		result = new CurvesPrimitive( curves->verticesPerCurve(), curves->basis(), curves->periodic() );
+	}
+	else
+	{
+		// We don't know how to construct this type directly, so
+		// fall back to a full copy. The variables will be replaced
+		// by the caller anyway.
+		result = primitive->copy();
+		result->variables.clear();
+		return result;
+	}
+
+	result->blindData()->writable() = primitive->blindData()->readable();
+	return result;
+}
@@ -34,6 +34,8 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "IECore/Exception.h"
+
 #include "GafferScene/Private/IECoreScenePreview/Renderer.h"
 
 using namespace std;
@@ -61,6 +63,41 @@ CreatorMap &creators()
 	return g_creators;
 }
 
+// Used by the default implementations of prototype() and
+// instance(), which just pass the object to object() again
+// for every instance.
+class DuplicatingPrototype : public Renderer::PrototypeInterface
+{
+
+	public :
+
+		DuplicatingPrototype( const std::vector<const IECore::Object *> &samples, const std::vector<float> &times )
+			:	m_samples( samples.begin(), samples.end() ), m_times( times )
+		{
+		}
+
+		Renderer::ObjectInterfacePtr instance( Renderer *renderer, const std::string &name, const Renderer::AttributesInterface *attributes ) const
+		{
+			if( m_times.empty() )
+			{
+				return renderer->object( name, m_samples.front().get(), attributes );
+			}
+
+			vector<const IECore::Object *> samples; samples.reserve( m_samples.size() );
+			for( vector<IECore::ConstObjectPtr>::const_iterator it = m_samples.begin(), eIt = m_samples.end(); it != eIt; ++it )
+			{
+				samples.push_back( it->get() );
+			}
+			return renderer->object( name, samples, m_times, attributes );
+		}
+
+	private :
+
+		vector<IECore::ConstObjectPtr> m_samples;
+		vector<float> m_times;
+
+};
+
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -87,6 +124,31 @@ Renderer::ObjectInterface::~ObjectInterface()
 
 }
 
+Renderer::PrototypeInterface::~PrototypeInterface()
+{
+
+}
+
+Renderer::PrototypeInterfacePtr Renderer::prototype( const IECore::Object *object )
+{
+	return new DuplicatingPrototype( vector<const IECore::Object *>( 1, object ), vector<float>() );
+}
+
+Renderer::PrototypeInterfacePtr Renderer::prototype( const std::vector<const IECore::Object *> &samples, const std::vector<float> &times )
+{
+	return new DuplicatingPrototype( samples, times );
+}
+
+Renderer::ObjectInterfacePtr Renderer::instance( const std::string &name, const PrototypeInterface *prototype, const AttributesInterface *attributes )
+{
+	const DuplicatingPrototype *duplicatingPrototype = dynamic_cast<const DuplicatingPrototype *>( prototype );
+	if( !duplicatingPrototype )
+	{
+		throw IECore::Exception( "Prototype was not created by Renderer::prototype()" );
+	}
+	return duplicatingPrototype->instance( this, name, attributes );
+}
+
 const std::vector<IECore::InternedString> &Renderer::types()
 {
 	return ::types();
@@ -36,17 +36,21 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "tbb/parallel_reduce.h"
+#include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 
 #include "boost/lexical_cast.hpp"
+#include "boost/format.hpp"
 
 #include "IECore/VectorTypedData.h"
 #include "IECore/Primitive.h"
+#include "IECore/VisibleRenderable.h"
 
 #include "Gaffer/Context.h"
 #include "Gaffer/StringPlug.h"
 
 #include "GafferScene/Instancer.h"
+#include "GafferScene/EncapsulatedInstances.h"
 
 using namespace std;
 using namespace tbb;
@@ -65,6 +69,11 @@ Instancer::Instancer( const std::string &name )
 	storeIndexOfNextChild( g_firstPlugIndex );
 	addChild( new StringPlug( "name", Plug::In, "instances" ) );
 	addChild( new ScenePlug( "instance" ) );
+	addChild( new BoolPlug( "encapsulateInstances" ) );
+	addChild( new StringPlug( "orientation" ) );
+	addChild( new StringPlug( "scale" ) );
+	addChild( new StringPlug( "pivot" ) );
+	addChild( new ObjectPlug( "__instanceTransforms", Plug::Out, new M44fVectorData() ) );
 }
 
 Instancer::~Instancer()
@@ -91,6 +100,56 @@ const ScenePlug *Instancer::instancePlug() const
 	return getChild<ScenePlug>( g_firstPlugIndex + 1 );
 }
 
+Gaffer::BoolPlug *Instancer::encapsulateInstancesPlug()
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 2 );
+}
+
+const Gaffer::BoolPlug *Instancer::encapsulateInstancesPlug() const
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 2 );
+}
+
+Gaffer::StringPlug *Instancer::orientationPlug()
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 3 );
+}
+
+const Gaffer::StringPlug *Instancer::orientationPlug() const
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 3 );
+}
+
+Gaffer::StringPlug *Instancer::scalePlug()
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 4 );
+}
+
+const Gaffer::StringPlug *Instancer::scalePlug() const
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 4 );
+}
+
+Gaffer::StringPlug *Instancer::pivotPlug()
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 5 );
+}
+
+const Gaffer::StringPlug *Instancer::pivotPlug() const
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 5 );
+}
+
+Gaffer::ObjectPlug *Instancer::instanceTransformsPlug()
+{
+	return getChild<ObjectPlug>( g_firstPlugIndex + 6 );
+}
+
+const Gaffer::ObjectPlug *Instancer::instanceTransformsPlug() const
+{
+	return getChild<ObjectPlug>( g_firstPlugIndex + 6 );
+}
+
 void Instancer::affects( const Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	BranchCreator::affects( input, outputs );
@@ -98,6 +157,21 @@ void Instancer::affects( const Plug *input, AffectedPlugsContainer &outputs ) co
 	if( input->parent<ScenePlug>() == instancePlug() )
 	{
 		outputs.push_back( outPlug()->getChild<ValuePlug>( input->getName() ) );
+		if(
+			input == instancePlug()->transformPlug() ||
+			input == instancePlug()->childNamesPlug()
+		)
+		{
+			// Encapsulated instances contain the
+			// whole prototype hierarchy.
+			outputs.push_back( outPlug()->objectPlug() );
+		}
+	}
+	else if( input == encapsulateInstancesPlug() )
+	{
+		outputs.push_back( outPlug()->boundPlug() );
+		outputs.push_back( outPlug()->objectPlug() );
+		outputs.push_back( outPlug()->childNamesPlug() );
 	}
 	else if( input == namePlug() )
 	{
@@ -105,12 +179,230 @@ void Instancer::affects( const Plug *input, AffectedPlugsContainer &outputs ) co
 	}
 	else if( input == inPlug()->objectPlug() )
 	{
+		outputs.push_back( instanceTransformsPlug() );
 		outputs.push_back( outPlug()->childNamesPlug() );
 		outputs.push_back( outPlug()->boundPlug() );
 		outputs.push_back( outPlug()->transformPlug() );
 	}
+	else if(
+		input == orientationPlug() ||
+		input == scalePlug() ||
+		input == pivotPlug()
+	)
+	{
+		outputs.push_back( instanceTransformsPlug() );
+	}
+	else if( input == instanceTransformsPlug() )
+	{
+		outputs.push_back( outPlug()->boundPlug() );
+		outputs.push_back( outPlug()->transformPlug() );
+		outputs.push_back( outPlug()->objectPlug() );
+	}
+}
+
+void Instancer::hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	BranchCreator::hash( output, context, h );
+
+	if( output == instanceTransformsPlug() )
+	{
+		inPlug()->objectPlug()->hash( h );
+		orientationPlug()->hash( h );
+		scalePlug()->hash( h );
+		pivotPlug()->hash( h );
+	}
+}
+
+void Instancer::compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const
+{
+	if( output == instanceTransformsPlug() )
+	{
+		static_cast<ObjectPlug *>( output )->setValue( computeInstanceTransforms() );
+		return;
+	}
+
+	BranchCreator::compute( output, context );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Instance transform construction
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+template<typename T>
+const T *instancePrimitiveVariable( const Primitive *primitive, const std::string &name, size_t size )
+{
+	if( name.empty() )
+	{
+		return NULL;
+	}
+
+	PrimitiveVariableMap::const_iterator it = primitive->variables.find( name );
+	if( it == primitive->variables.end() )
+	{
+		throw IECore::Exception( "Primitive variable \"" + name + "\" not found" );
+	}
+
+	const T *result = runTimeCast<const T>( it->second.data.get() );
+	if( !result )
+	{
+		return NULL;
+	}
+
+	if( result->readable().size() != size )
+	{
+		throw IECore::Exception( "Primitive variable \"" + name + "\" has wrong size" );
+	}
+
+	return result;
+}
+
+// Builds the transforms for a range of instances. The loop body
+// is a straight-line function of the per-point arrays, so it can be
+// run in parallel over arbitrary ranges, and the compiler is free to
+// vectorise it.
+struct InstanceTransformsBuilder
+{
+
+	InstanceTransformsBuilder( const V3f *p, const Quatf *orientation, const V3f *scale, const float *uniformScale, const V3f *pivot, M44f *result )
+		:	m_p( p ), m_orientation( orientation ), m_scale( scale ), m_uniformScale( uniformScale ), m_pivot( pivot ), m_result( result )
+	{
+	}
+
+	void operator() ( const blocked_range<size_t> &r ) const
+	{
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			M44f &m = m_result[i];
+			m = m_orientation ? m_orientation[i].normalized().toMatrix44() : M44f();
+
+			V3f s( 1 );
+			if( m_scale )
+			{
+				s = m_scale[i];
+			}
+			else if( m_uniformScale )
+			{
+				s = V3f( m_uniformScale[i] );
+			}
+
+			for( int c = 0; c < 3; ++c )
+			{
+				m[0][c] *= s.x;
+				m[1][c] *= s.y;
+				m[2][c] *= s.z;
+			}
+
+			// Equivalent to translating by -pivot, applying
+			// the rotation and scale above, and then
+			// translating to the point position.
+			V3f t = m_p[i];
+			if( m_pivot )
+			{
+				V3f pivotOffset;
+				m.multDirMatrix( -m_pivot[i], pivotOffset );
+				t += pivotOffset;
+			}
+
+			m[3][0] = t.x;
+			m[3][1] = t.y;
+			m[3][2] = t.z;
+		}
+	}
+
+	private :
+
+		const V3f *m_p;
+		const Quatf *m_orientation;
+		const V3f *m_scale;
+		const float *m_uniformScale;
+		const V3f *m_pivot;
+		M44f *m_result;
+
+};
+
+} // namespace
+
+IECore::ConstM44fVectorDataPtr Instancer::computeInstanceTransforms() const
+{
+	M44fVectorDataPtr resultData = new M44fVectorData;
+
+	ConstPrimitivePtr primitive = runTimeCast<const Primitive>( inPlug()->objectPlug()->getValue() );
+	if( !primitive )
+	{
+		return resultData;
+	}
+
+	const V3fVectorData *p = primitive->variableData<V3fVectorData>( "P" );
+	if( !p )
+	{
+		return resultData;
+	}
+
+	const size_t size = p->readable().size();
+
+	const QuatfVectorData *orientation = instancePrimitiveVariable<QuatfVectorData>( primitive.get(), orientationPlug()->getValue(), size );
+	const std::string scaleName = scalePlug()->getValue();
+	const V3fVectorData *scale = instancePrimitiveVariable<V3fVectorData>( primitive.get(), scaleName, size );
+	const FloatVectorData *uniformScale = scale ? NULL : instancePrimitiveVariable<FloatVectorData>( primitive.get(), scaleName, size );
+	const V3fVectorData *pivot = instancePrimitiveVariable<V3fVectorData>( primitive.get(), pivotPlug()->getValue(), size );
+
+	if( !orientationPlug()->getValue().empty() && !orientation )
+	{
+		throw IECore::Exception( "Orientation primitive variable \"" + orientationPlug()->getValue() + "\" must be of type QuatfVectorData" );
+	}
+	if( !scaleName.empty() && !scale && !uniformScale )
+	{
+		throw IECore::Exception( "Scale primitive variable \"" + scaleName + "\" must be of type V3fVectorData or FloatVectorData" );
+	}
+	if( !pivotPlug()->getValue().empty() && !pivot )
+	{
+		throw IECore::Exception( "Pivot primitive variable \"" + pivotPlug()->getValue() + "\" must be of type V3fVectorData" );
+	}
+
+	vector<M44f> &result = resultData->writable();
+	result.resize( size );
+	if( !size )
+	{
+		return resultData;
+	}
+
+	InstanceTransformsBuilder builder(
+		&p->readable()[0],
+		orientation ? &orientation->readable()[0] : NULL,
+		scale ? &scale->readable()[0] : NULL,
+		uniformScale ? &uniformScale->readable()[0] : NULL,
+		pivot ? &pivot->readable()[0] : NULL,
+		&result[0]
+	);
+
+	parallel_for( blocked_range<size_t>( 0, size, 1000 ), builder );
+
+	return resultData;
 }
 
+IECore::ConstM44fVectorDataPtr Instancer::instanceTransforms( const ScenePath &parentPath ) const
+{
+	ContextPtr c = new Context( *Context::current(), Context::Borrowed );
+	c->set( ScenePlug::scenePathContextName, parentPath );
+	Context::Scope scopedContext( c.get() );
+	return boost::static_pointer_cast<const M44fVectorData>( instanceTransformsPlug()->getValue() );
+}
+
+IECore::MurmurHash Instancer::instanceTransformsHash( const ScenePath &parentPath ) const
+{
+	ContextPtr c = new Context( *Context::current(), Context::Borrowed );
+	c->set( ScenePlug::scenePathContextName, parentPath );
+	Context::Scope scopedContext( c.get() );
+	return instanceTransformsPlug()->hash();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Branch evaluation
+//////////////////////////////////////////////////////////////////////////
+
 struct Instancer::BoundHash
 {
 
@@ -168,11 +460,12 @@ void Instancer::hashBranchBound( const ScenePath &parentPath, const ScenePath &b
 		// "/" or "/name"
 
 		BranchCreator::hashBranchBound( parentPath, branchPath, context, h );
+		encapsulateInstancesPlug()->hash( h );
 
 		ConstV3fVectorDataPtr p = sourcePoints( parentPath );
 		if( p )
 		{
-			p->hash( h );
+			h.append( instanceTransformsHash( parentPath ) );
 
 			ScenePath branchChildPath( branchPath );
 			if( branchChildPath.size() == 0 )
@@ -180,13 +473,24 @@ void Instancer::hashBranchBound( const ScenePath &parentPath, const ScenePath &b
 				branchChildPath.push_back( namePlug()->getValue() );
 			}
 
-			BoundHash hasher( this, branchChildPath, context );
-			parallel_deterministic_reduce(
-				blocked_range<size_t>( 0, p->readable().size(), 100 ),
-				hasher
-			);
+			MurmurHash prototypeHash;
+			if( !p->readable().empty() && !prototypeBoundVaries( context, prototypeHash ) )
+			{
+				// The bound of every instance is the same, so the
+				// point positions and that single bound hash tell
+				// us everything we need.
+				h.append( prototypeHash );
+			}
+			else
+			{
+				BoundHash hasher( this, branchChildPath, context );
+				parallel_deterministic_reduce(
+					blocked_range<size_t>( 0, p->readable().size(), 100 ),
+					hasher
+				);
 
-			h.append( hasher.result() );
+				h.append( hasher.result() );
+			}
 		}
 	}
 	else
@@ -200,13 +504,13 @@ void Instancer::hashBranchBound( const ScenePath &parentPath, const ScenePath &b
 struct Instancer::BoundUnion
 {
 
-	BoundUnion( const Instancer *instancer, const ScenePath &branchPath, const Context *c, const V3fVectorData *p )
-		:	m_instancer( instancer ), m_branchPath( branchPath ), m_context( c ), m_p( p ), m_union()
+	BoundUnion( const Instancer *instancer, const ScenePath &branchPath, const Context *c, const vector<M44f> &transforms )
+		:	m_instancer( instancer ), m_branchPath( branchPath ), m_context( c ), m_transforms( transforms ), m_union()
 	{
 	}
 
 	BoundUnion( const BoundUnion &rhs, split )
-		:	m_instancer( rhs.m_instancer ), m_branchPath( rhs.m_branchPath ), m_context( rhs.m_context ), m_p( rhs.m_p ), m_union()
+		:	m_instancer( rhs.m_instancer ), m_branchPath( rhs.m_branchPath ), m_context( rhs.m_context ), m_transforms( rhs.m_transforms ), m_union()
 	{
 	}
 
@@ -224,7 +528,7 @@ struct Instancer::BoundUnion
 			m_instancer->fillInstanceContext( ic.get(), branchChildPath, i );
 
 			Box3f branchChildBound = m_instancer->instancePlug()->boundPlug()->getValue();
-			branchChildBound = transform( branchChildBound, m_instancer->instanceTransform( m_p, i ) );
+			branchChildBound = transform( branchChildBound, m_transforms[i] );
 			m_union.extendBy( branchChildBound );
 		}
 	}
@@ -244,19 +548,113 @@ struct Instancer::BoundUnion
 		const Instancer *m_instancer;
 		const ScenePath &m_branchPath;
 		const Context *m_context;
-		const V3fVectorData *m_p;
+		const vector<M44f> &m_transforms;
+		Box3f m_union;
+
+};
+
+struct Instancer::TransformedBoundUnion
+{
+
+	TransformedBoundUnion( const Box3f &bound, const vector<M44f> &transforms )
+		:	m_bound( bound ), m_transforms( transforms ), m_union()
+	{
+	}
+
+	TransformedBoundUnion( const TransformedBoundUnion &rhs, split )
+		:	m_bound( rhs.m_bound ), m_transforms( rhs.m_transforms ), m_union()
+	{
+	}
+
+	void operator() ( const blocked_range<size_t> &r )
+	{
+		if( m_bound.isEmpty() )
+		{
+			return;
+		}
+
+		for( size_t i=r.begin(); i!=r.end(); ++i )
+		{
+			m_union.extendBy( transform( m_bound, m_transforms[i] ) );
+		}
+	}
+
+	void join( const TransformedBoundUnion &rhs )
+	{
+		m_union.extendBy( rhs.m_union );
+	}
+
+	const Box3f &result()
+	{
+		return m_union;
+	}
+
+	private :
+
+		const Box3f m_bound;
+		const vector<M44f> &m_transforms;
 		Box3f m_union;
 
 };
 
+Gaffer::ContextPtr Instancer::prototypeContext( const Gaffer::Context *parentContext ) const
+{
+	ContextPtr result = new Context( *parentContext, Context::Borrowed );
+	result->set( ScenePlug::scenePathContextName, ScenePath() );
+	result->remove( "instancer:id" );
+	return result;
+}
+
+bool Instancer::prototypeBoundVaries( const Gaffer::Context *context, IECore::MurmurHash &prototypeHash ) const
+{
+	ContextPtr ic = prototypeContext( context );
+	Context::Scope scopedContext( ic.get() );
+
+	if( encapsulateInstancesPlug()->getValue() )
+	{
+		// Encapsulated instances never vary, by definition.
+		prototypeHash = instancePlug()->boundPlug()->hash();
+		return false;
+	}
+
+	// The only thing that differs between the contexts for
+	// each instance root is the "instancer:id" variable. We
+	// first hash the bound without it, which will fail if
+	// the prototype requires it. Otherwise, if the bound
+	// depends on the variable its hash must too, so we compare
+	// against the hashes for two different ids.
+	try
+	{
+		prototypeHash = instancePlug()->boundPlug()->hash();
+	}
+	catch( ... )
+	{
+		// Evaluation requires the id, so we must
+		// assume the bound varies per instance. If
+		// there is a genuine error, the per-instance
+		// evaluation will report it.
+		return true;
+	}
+
+	ic->set( "instancer:id", 0 );
+	if( instancePlug()->boundPlug()->hash() != prototypeHash )
+	{
+		return true;
+	}
+
+	ic->set( "instancer:id", 1 );
+	return instancePlug()->boundPlug()->hash() != prototypeHash;
+}
+
 Imath::Box3f Instancer::computeBranchBound( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context ) const
 {
 	if( branchPath.size() <= 1 )
 	{
 		// "/" or "/name"
 		Box3f result;
-		ConstV3fVectorDataPtr p = sourcePoints( parentPath );
-		if( p )
+		ConstM44fVectorDataPtr transformsData = instanceTransforms( parentPath );
+		const vector<M44f> &transforms = transformsData->readable();
+		if( !transforms.empty() )
 		{
 			ScenePath branchChildPath( branchPath );
 			if( branchChildPath.size() == 0 )
@@ -264,13 +662,34 @@ Imath::Box3f Instancer::computeBranchBound( const ScenePath &parentPath, const S
 				branchChildPath.push_back( namePlug()->getValue() );
 			}
 
-			BoundUnion unioner( this, branchChildPath, context, p.get() );
-			parallel_reduce(
-				blocked_range<size_t>( 0, p->readable().size() ),
-				unioner
-			);
+			MurmurHash prototypeHash;
+			if( !prototypeBoundVaries( context, prototypeHash ) )
+			{
+				// Evaluate the prototype bound once, and transform
+				// it by each of the instance transforms without
+				// needing to evaluate the graph per instance.
+				ContextPtr ic = prototypeContext( context );
+				Context::Scope scopedContext( ic.get() );
+				const Box3f prototypeBound = instancePlug()->boundPlug()->getValue();
+
+				TransformedBoundUnion unioner( prototypeBound, transforms );
+				parallel_reduce(
+					blocked_range<size_t>( 0, transforms.size(), 1000 ),
+					unioner
+				);
+
+				result = unioner.result();
+			}
+			else
+			{
+				BoundUnion unioner( this, branchChildPath, context, transforms );
+				parallel_reduce(
+					blocked_range<size_t>( 0, transforms.size() ),
+					unioner
+				);
 
-			result = unioner.result();
+				result = unioner.result();
+			}
 		}
 
 		return result;
@@ -294,7 +713,7 @@ void Instancer::hashBranchTransform( const ScenePath &parentPath, const ScenePat
 	{
 		// "/name/instanceNumber"
 		BranchCreator::hashBranchTransform( parentPath, branchPath, context, h );
-		h.append( inPlug()->objectHash( parentPath ) );
+		h.append( instanceTransformsHash( parentPath ) );
 		h.append( instanceIndex( branchPath ) );
 	}
 	else
@@ -315,9 +734,13 @@ Imath::M44f Instancer::computeBranchTransform( const ScenePath &parentPath, cons
 	else if( branchPath.size() == 2 )
 	{
 		// "/name/instanceNumber"
-		int index = instanceIndex( branchPath );
-		ConstV3fVectorDataPtr p = sourcePoints( parentPath );
-		return instanceTransform( p.get(), index );
+		const int index = instanceIndex( branchPath );
+		ConstM44fVectorDataPtr transforms = instanceTransforms( parentPath );
+		if( index < 0 || index >= (int)transforms->readable().size() )
+		{
+			throw IECore::Exception( boost::str( boost::format( "Instance index %d is out of range (%d instances)" ) % index % transforms->readable().size() ) );
+		}
+		return transforms->readable()[index];
 	}
 	else
 	{
@@ -359,7 +782,17 @@ IECore::ConstCompoundObjectPtr Instancer::computeBranchAttributes( const ScenePa
 
 void Instancer::hashBranchObject( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
-	if( branchPath.size() <= 1 )
+	if( branchPath.size() == 1 && encapsulateInstancesPlug()->getValue() )
+	{
+		// "/name", holding encapsulated instances
+		BranchCreator::hashBranchObject( parentPath, branchPath, context, h );
+		h.append( instanceTransformsHash( parentPath ) );
+
+		ContextPtr pc = prototypeContext( context );
+		Context::Scope scopedContext( pc.get() );
+		h.append( instancePlug()->hierarchyHash( ScenePath() ) );
+	}
+	else if( branchPath.size() <= 1 )
 	{
 		// "/" or "/name"
 		h = outPlug()->objectPlug()->defaultValue()->Object::hash();
@@ -374,7 +807,32 @@ void Instancer::hashBranchObject( const ScenePath &parentPath, const ScenePath &
 
 IECore::ConstObjectPtr Instancer::computeBranchObject( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context ) const
 {
-	if( branchPath.size() <= 1 )
+	if( branchPath.size() == 1 && encapsulateInstancesPlug()->getValue() )
+	{
+		// "/name", holding encapsulated instances. The instance
+		// transforms are shared directly with our internal cache.
+		ConstM44fVectorDataPtr transforms = instanceTransforms( parentPath );
+
+		IntVectorDataPtr instanceIdsData = new IntVectorData;
+		vector<int> &instanceIds = instanceIdsData->writable();
+		instanceIds.resize( transforms->readable().size() );
+		for( size_t i = 0, e = instanceIds.size(); i < e; ++i )
+		{
+			instanceIds[i] = i;
+		}
+
+		ObjectVectorPtr prototypes = new ObjectVector;
+		StringVectorDataPtr prototypeNames = new StringVectorData;
+		M44fVectorDataPtr prototypeTransforms = new M44fVectorData;
+
+		ContextPtr pc = prototypeContext( context );
+		Context::Scope scopedContext( pc.get() );
+		ScenePath prototypePath;
+		prototypesWalk( pc.get(), prototypePath, M44f(), prototypes.get(), prototypeNames->writable(), prototypeTransforms->writable() );
+
+		return new EncapsulatedInstances( prototypes, prototypeNames, prototypeTransforms, transforms, instanceIdsData );
+	}
+	else if( branchPath.size() <= 1 )
 	{
 		// "/" or "/name"
 		return outPlug()->objectPlug()->defaultValue();
@@ -399,6 +857,7 @@ void Instancer::hashBranchChildNames( const ScenePath &parentPath, const ScenePa
 	{
 		// "/name"
 		BranchCreator::hashBranchChildNames( parentPath, branchPath, context, h );
+		encapsulateInstancesPlug()->hash( h );
 		h.append( inPlug()->objectHash( parentPath ) );
 	}
 	else
@@ -426,6 +885,11 @@ IECore::ConstInternedStringVectorDataPtr Instancer::computeBranchChildNames( con
 	}
 	else if( branchPath.size() == 1 )
 	{
+		if( encapsulateInstancesPlug()->getValue() )
+		{
+			return outPlug()->childNamesPlug()->defaultValue();
+		}
+
 		ConstV3fVectorDataPtr p = sourcePoints( parentPath );
 		if( !p || !p->readable().size() )
 		{
@@ -496,9 +960,31 @@ void Instancer::fillInstanceContext( Gaffer::Context *instanceContext, const Sce
 	instanceContext->set( "instancer:id", instanceId );
 }
 
-Imath::M44f Instancer::instanceTransform( const IECore::V3fVectorData *p, int instanceId ) const
+void Instancer::prototypesWalk( Gaffer::Context *context, ScenePath &path, const Imath::M44f &parentTransform, IECore::ObjectVector *prototypes, std::vector<std::string> &names, std::vector<Imath::M44f> &transforms ) const
 {
-	M44f result;
-	result.translate( p->readable()[instanceId] );
-	return result;
+	context->set( ScenePlug::scenePathContextName, path );
+
+	const M44f transform = instancePlug()->transformPlug()->getValue() * parentTransform;
+
+	ConstObjectPtr object = instancePlug()->objectPlug()->getValue();
+	if( runTimeCast<const VisibleRenderable>( object.get() ) )
+	{
+		// The const_pointer_cast is ok because the prototypes
+		// are never modified once they have been placed in the
+		// EncapsulatedInstances object.
+		prototypes->members().push_back( boost::const_pointer_cast<Object>( object ) );
+		std::string name;
+		ScenePlug::pathToString( path, name );
+		names.push_back( name );
+		transforms.push_back( transform );
+	}
+
+	ConstInternedStringVectorDataPtr childNamesData = instancePlug()->childNamesPlug()->getValue();
+	const vector<InternedString> &childNames = childNamesData->readable();
+	for( vector<InternedString>::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; ++it )
+	{
+		path.push_back( *it );
+		prototypesWalk( context, path, transform, prototypes, names, transforms );
+		path.pop_back();
+	}
 }
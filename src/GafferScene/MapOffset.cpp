@@ -39,6 +39,7 @@
 #include "Gaffer/StringPlug.h"
 
 #include "GafferScene/MapOffset.h"
+#include "GafferScene/Private/IECoreScenePreview/PrimitiveAlgo.h"
 
 using namespace std;
 using namespace Imath;
@@ -158,7 +159,10 @@ IECore::ConstObjectPtr MapOffset::computeProcessedObject( const ScenePath &path,
 
 	// do the work
 
-	PrimitivePtr result = inputPrimitive->copy();
+	// Share the input data rather than holding copies of it. Only
+	// the data we modify below is copied.
+	PrimitivePtr result = IECoreScenePreview::PrimitiveAlgo::copyTopology( inputPrimitive );
+	result->variables = inputPrimitive->variables;
 
 	V2f offset = offsetPlug()->getValue();
 
@@ -166,16 +170,20 @@ IECore::ConstObjectPtr MapOffset::computeProcessedObject( const ScenePath &path,
 	offset.x += (udim - 1001) % 10;
 	offset.y += (udim - 1001) / 10;
 
-	if( FloatVectorDataPtr sData = result->variableData<FloatVectorData>( sName ) )
+	if( const FloatVectorData *inputSData = inputPrimitive->variableData<FloatVectorData>( sName ) )
 	{
+		FloatVectorDataPtr sData = inputSData->copy();
+		result->variables[sName].data = sData;
 		for( vector<float>::iterator it = sData->writable().begin(), eIt = sData->writable().end(); it != eIt; ++it )
 		{
 			*it += offset.x;
 		}
 	}
 
-	if( FloatVectorDataPtr tData = result->variableData<FloatVectorData>( tName ) )
+	if( const FloatVectorData *inputTData = inputPrimitive->variableData<FloatVectorData>( tName ) )
 	{
+		FloatVectorDataPtr tData = inputTData->copy();
+		result->variables[tName].data = tData;
 		for( vector<float>::iterator it = tData->writable().begin(), eIt = tData->writable().end(); it != eIt; ++it )
 		{
 			*it += offset.y;
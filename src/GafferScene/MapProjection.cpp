@@ -43,6 +43,7 @@
 #include "Gaffer/StringPlug.h"
 
 #include "GafferScene/MapProjection.h"
+#include "GafferScene/Private/IECoreScenePreview/PrimitiveAlgo.h"
 
 using namespace std;
 using namespace Imath;
@@ -188,7 +189,9 @@ IECore::ConstObjectPtr MapProjection::computeProcessedObject( const ScenePath &p
 
 	// do the work
 
-	PrimitivePtr result = inputPrimitive->copy();
+	// Share the input data rather than holding copies of it.
+	PrimitivePtr result = IECoreScenePreview::PrimitiveAlgo::copyTopology( inputPrimitive );
+	result->variables = inputPrimitive->variables;
 
 	FloatVectorDataPtr sData = new FloatVectorData();
 	FloatVectorDataPtr tData = new FloatVectorData();
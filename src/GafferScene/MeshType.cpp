@@ -40,6 +40,7 @@
 #include "Gaffer/StringPlug.h"
 
 #include "GafferScene/MeshType.h"
+#include "GafferScene/Private/IECoreScenePreview/PrimitiveAlgo.h"
 
 using namespace IECore;
 using namespace Gaffer;
@@ -148,7 +149,12 @@ IECore::ConstObjectPtr MeshType::computeProcessedObject( const ScenePath &path,
 		return inputObject;
 	}
 
-	IECore::MeshPrimitivePtr result = inputGeometry->copy();
+	// Share the input data rather than holding copies of it. This is
+	// safe because the normals op only adds new data.
+	IECore::MeshPrimitivePtr result = boost::static_pointer_cast<IECore::MeshPrimitive>(
+		IECoreScenePreview::PrimitiveAlgo::copyTopology( inputGeometry )
+	);
+	result->variables = inputGeometry->variables;
 	result->setInterpolation( meshType );
 	if( meshType != "linear" )
 	{
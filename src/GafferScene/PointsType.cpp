@@ -39,6 +39,7 @@
 #include "Gaffer/StringPlug.h"
 
 #include "GafferScene/PointsType.h"
+#include "GafferScene/Private/IECoreScenePreview/PrimitiveAlgo.h"
 
 using namespace IECore;
 using namespace Gaffer;
@@ -135,7 +136,11 @@ IECore::ConstObjectPtr PointsType::computeProcessedObject( const ScenePath &path
 		}
 	}
 
-	PointsPrimitivePtr result = inputPoints->copy();
+	// Share the input data rather than holding copies of it.
+	PointsPrimitivePtr result = boost::static_pointer_cast<PointsPrimitive>(
+		IECoreScenePreview::PrimitiveAlgo::copyTopology( inputPoints )
+	);
+	result->variables = inputPoints->variables;
 	result->variables["type"] = PrimitiveVariable( PrimitiveVariable::Constant, new StringData( type ) );
 
 	return result;
@@ -43,6 +43,7 @@
 #include "IECore/VisibleRenderable.h"
 #include "IECore/NullObject.h"
 
+#include "Gaffer/BackgroundTask.h"
 #include "Gaffer/Context.h"
 #include "Gaffer/ScriptNode.h"
 #include "Gaffer/StringPlug.h"
@@ -52,6 +53,7 @@
 #include "GafferScene/SceneAlgo.h"
 #include "GafferScene/PathMatcherData.h"
 #include "GafferScene/SceneNode.h"
+#include "GafferScene/SharedScenePath.h"
 
 using namespace std;
 using namespace Imath;
@@ -91,7 +93,9 @@ bool visible( const CompoundObject *attributes )
 // maintains the original hierarchy, providing the means of flattening
 // attribute and transform state for passing to the renderer. Calls
 // to update() are made from a threaded scene traversal performed by
-// SceneGraphUpdateTask.
+// SceneGraphUpdateTask, which may be cancelled part way through. We
+// therefore track the changes which have not yet been passed on to
+// our children, so that they can be applied by the next update.
 class InteractiveRender::SceneGraph
 {
 
@@ -146,7 +150,7 @@ class InteractiveRender::SceneGraph
 
 		// Called by SceneGraphUpdateTask to update this location. Returns a bitmask
 		// of the components which were changed.
-		unsigned update( const ScenePlug *scene, unsigned dirtyComponents, unsigned changedParentComponents, Type type, IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals )
+		unsigned update( const ScenePlug *scene, unsigned dirtyComponents, unsigned changedParentComponents, Type type, IECoreScenePreview::Renderer *renderer, AttributesCache *attributesCache, const IECore::CompoundObject *globals )
 		{
 			unsigned changedComponents = 0;
 
@@ -191,7 +195,7 @@ class InteractiveRender::SceneGraph
 
 			// Object
 
-			if( ( dirtyComponents & ObjectComponent ) && updateObject( scene->objectPlug(), type, renderer, globals ) )
+			if( ( dirtyComponents & ObjectComponent ) && updateObject( scene->objectPlug(), type, renderer, attributesCache, globals ) )
 			{
 				changedComponents |= ObjectComponent;
 			}
@@ -211,7 +215,7 @@ class InteractiveRender::SceneGraph
 					// if they have changed.
 					if( changedComponents & AttributesComponent )
 					{
-						m_objectInterface->attributes( attributesInterface( renderer ) );
+						m_objectInterface->attributes( attributesInterface( attributesCache ) );
 					}
 					if( changedComponents & TransformComponent )
 					{
@@ -229,7 +233,17 @@ class InteractiveRender::SceneGraph
 
 			m_cleared = false;
 
-			return changedComponents;
+			// Changes remain pending until childrenUpdated() is called,
+			// and are reported again if we are updated before then.
+			m_pendingChildComponents |= changedComponents;
+			return m_pendingChildComponents;
+		}
+
+		// Must be called once all children have been updated successfully
+		// following a call to update().
+		void childrenUpdated()
+		{
+			m_pendingChildComponents = NoComponent;
 		}
 
 		const std::vector<SceneGraph *> &children()
@@ -237,6 +251,11 @@ class InteractiveRender::SceneGraph
 			return m_children;
 		}
 
+		bool hasObject() const
+		{
+			return static_cast<bool>( m_objectInterface );
+		}
+
 		// Invalidates this location, removing any resources it
 		// holds in the renderer, and clearing all children. This is
 		// used to "remove" a location without having to delete it
@@ -249,6 +268,7 @@ class InteractiveRender::SceneGraph
 			clearChildren();
 			clearObject();
 			m_attributesHash = m_transformHash = m_childNamesHash = IECore::MurmurHash();
+			m_pendingChildComponents = NoComponent;
 			m_cleared = true;
 		}
 
@@ -310,11 +330,11 @@ class InteractiveRender::SceneGraph
 			return true;
 		}
 
-		IECoreScenePreview::Renderer::AttributesInterface *attributesInterface( IECoreScenePreview::Renderer *renderer )
+		IECoreScenePreview::Renderer::AttributesInterface *attributesInterface( AttributesCache *attributesCache )
 		{
 			if( !m_attributesInterface )
 			{
-				m_attributesInterface = renderer->attributes( m_fullAttributes.get() );
+				m_attributesInterface = attributesCache->get( m_fullAttributes.get() );
 			}
 			return m_attributesInterface.get();
 		}
@@ -343,7 +363,7 @@ class InteractiveRender::SceneGraph
 		}
 
 		// Returns true if the object changed.
-		bool updateObject( const ObjectPlug *objectPlug, Type type, IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals )
+		bool updateObject( const ObjectPlug *objectPlug, Type type, IECoreScenePreview::Renderer *renderer, AttributesCache *attributesCache, const IECore::CompoundObject *globals )
 		{
 			const bool hadObjectInterface = static_cast<bool>( m_objectInterface );
 			if( type == NoType )
@@ -377,16 +397,16 @@ class InteractiveRender::SceneGraph
 				{
 					IECore::CameraPtr cameraCopy = camera->copy();
 					applyCameraGlobals( cameraCopy.get(), globals );
-					m_objectInterface = renderer->camera( name, cameraCopy.get(), attributesInterface( renderer ) );
+					m_objectInterface = renderer->camera( name, cameraCopy.get(), attributesInterface( attributesCache ) );
 				}
 			}
 			else if( type == LightType )
 			{
-				m_objectInterface = renderer->light( name, nullObject ? NULL : object.get(), attributesInterface( renderer ) );
+				m_objectInterface = renderer->light( name, nullObject ? NULL : object.get(), attributesInterface( attributesCache ) );
 			}
 			else
 			{
-				m_objectInterface = renderer->object( name, object.get(), attributesInterface( renderer ) );
+				m_objectInterface = outputObject( name, object.get(), attributesInterface( attributesCache ), renderer );
 			}
 
 			return true;
@@ -464,11 +484,106 @@ class InteractiveRender::SceneGraph
 
 		IECore::MurmurHash m_childNamesHash;
 		std::vector<SceneGraph *> m_children;
+		unsigned m_pendingChildComponents;
 
 		bool m_cleared;
 
 };
 
+// TBB task used to compute the scene in advance of a SceneGraphUpdateTask.
+// This makes no edits to the renderer, so can run while the renderer is
+// still rendering, leaving the SceneGraphUpdateTask to retrieve the results
+// from the compute cache while the renderer is paused. Since it can only
+// visit locations which already exist in the SceneGraph, it is most effective
+// for edits to existing locations, which are the common case when working
+// interactively.
+class InteractiveRender::SceneGraphPrefetchTask : public tbb::task
+{
+
+	public :
+
+		SceneGraphPrefetchTask(
+			const ScenePlug *scene,
+			const Context *context,
+			const BackgroundTask::Canceller &canceller,
+			SceneGraph *sceneGraph,
+			unsigned dirtyComponents,
+			const SharedScenePath *scenePath
+		)
+			:	m_scene( scene ),
+				m_context( context ),
+				m_canceller( canceller ),
+				m_sceneGraph( sceneGraph ),
+				m_dirtyComponents( dirtyComponents ),
+				m_scenePath( scenePath )
+		{
+		}
+
+		virtual task *execute()
+		{
+			if( m_canceller.cancelled() || m_sceneGraph->cleared() )
+			{
+				return NULL;
+			}
+
+			ContextPtr context = new Context( *m_context, Context::Borrowed );
+			context->set( ScenePlug::scenePathContextName, m_scenePath->data(), Context::Shared, m_scenePath->hash() );
+			Context::Scope scopedContext( context.get() );
+
+			try
+			{
+				if( m_dirtyComponents & SceneGraph::TransformComponent )
+				{
+					m_scene->transformPlug()->getValue();
+				}
+				if( ( m_dirtyComponents & SceneGraph::AttributesComponent ) && m_scenePath->size() )
+				{
+					m_scene->attributesPlug()->getValue();
+				}
+				if( ( m_dirtyComponents & SceneGraph::ObjectComponent ) && m_sceneGraph->hasObject() )
+				{
+					m_scene->objectPlug()->getValue();
+				}
+				if( m_dirtyComponents & SceneGraph::ChildNamesComponent )
+				{
+					m_scene->childNamesPlug()->getValue();
+				}
+			}
+			catch( ... )
+			{
+				// Errors will be reported by the
+				// SceneGraphUpdateTask instead.
+			}
+
+			const std::vector<SceneGraph *> &children = m_sceneGraph->children();
+			if( children.size() )
+			{
+				set_ref_count( 1 + children.size() );
+
+				for( std::vector<SceneGraph *>::const_iterator it = children.begin(), eIt = children.end(); it != eIt; ++it )
+				{
+					ConstSharedScenePathPtr childPath = new SharedScenePath( m_scenePath.get(), (*it)->name() );
+					SceneGraphPrefetchTask *t = new( allocate_child() ) SceneGraphPrefetchTask( m_scene, m_context, m_canceller, *it, m_dirtyComponents, childPath.get() );
+					spawn( *t );
+				}
+
+				wait_for_all();
+			}
+
+			return NULL;
+		}
+
+	private :
+
+		const ScenePlug *m_scene;
+		const Context *m_context;
+		const BackgroundTask::Canceller &m_canceller;
+		SceneGraph *m_sceneGraph;
+		unsigned m_dirtyComponents;
+		ConstSharedScenePathPtr m_scenePath;
+
+};
+
 // TBB task used to perform multithreaded updates on our SceneGraph.
 class InteractiveRender::SceneGraphUpdateTask : public tbb::task
 {
@@ -477,13 +592,17 @@ class InteractiveRender::SceneGraphUpdateTask : public tbb::task
 
 		SceneGraphUpdateTask(
 			const InteractiveRender *interactiveRender,
+			const Context *context,
+			const BackgroundTask::Canceller &canceller,
 			SceneGraph *sceneGraph,
 			SceneGraph::Type sceneGraphType,
 			unsigned dirtyComponents,
 			unsigned changedParentComponents,
-			const ScenePlug::ScenePath &scenePath
+			const SharedScenePath *scenePath
 		)
 			:	m_interactiveRender( interactiveRender ),
+				m_context( context ),
+				m_canceller( canceller ),
 				m_sceneGraph( sceneGraph ),
 				m_sceneGraphType( sceneGraphType ),
 				m_dirtyComponents( dirtyComponents ),
@@ -495,6 +614,15 @@ class InteractiveRender::SceneGraphUpdateTask : public tbb::task
 		virtual task *execute()
 		{
 
+			// Cancellation is checked once per location. Any
+			// locations we don't reach will be updated by the
+			// next update instead.
+
+			if( m_canceller.cancelled() )
+			{
+				return NULL;
+			}
+
 			// Figure out if this location belongs in the type
 			// of scene graph we're constructing. If it doesn't
 			// belong, and neither do any of its descendants,
@@ -518,8 +646,8 @@ class InteractiveRender::SceneGraphUpdateTask : public tbb::task
 			// Set up a context to compute the scene at the right
 			// location.
 
-			ContextPtr context = new Context( *m_interactiveRender->m_effectiveContext, Context::Borrowed );
-			context->set( ScenePlug::scenePathContextName, m_scenePath );
+			ContextPtr context = new Context( *m_context, Context::Borrowed );
+			context->set( ScenePlug::scenePathContextName, m_scenePath->data(), Context::Shared, m_scenePath->hash() );
 			Context::Scope scopedContext( context.get() );
 
 			// Update the scene graph at this location.
@@ -530,6 +658,7 @@ class InteractiveRender::SceneGraphUpdateTask : public tbb::task
 				m_changedParentComponents,
 				sceneGraphMatch & Filter::ExactMatch ? m_sceneGraphType : SceneGraph::NoType,
 				m_interactiveRender->m_renderer.get(),
+				m_interactiveRender->m_attributesCache.get(),
 				m_interactiveRender->m_globals.get()
 			);
 
@@ -540,18 +669,21 @@ class InteractiveRender::SceneGraphUpdateTask : public tbb::task
 			{
 				set_ref_count( 1 + children.size() );
 
-				ScenePlug::ScenePath childPath = m_scenePath;
-				childPath.push_back( IECore::InternedString() ); // space for the child name
 				for( std::vector<SceneGraph *>::const_iterator it = children.begin(), eIt = children.end(); it != eIt; ++it )
 				{
-					childPath.back() = (*it)->name();
-					SceneGraphUpdateTask *t = new( allocate_child() ) SceneGraphUpdateTask( m_interactiveRender, *it, m_sceneGraphType, m_dirtyComponents, changedComponents, childPath );
+					ConstSharedScenePathPtr childPath = new SharedScenePath( m_scenePath.get(), (*it)->name() );
+					SceneGraphUpdateTask *t = new( allocate_child() ) SceneGraphUpdateTask( m_interactiveRender, m_context, m_canceller, *it, m_sceneGraphType, m_dirtyComponents, changedComponents, childPath.get() );
 					spawn( *t );
 				}
 
 				wait_for_all();
 			}
 
+			if( !m_canceller.cancelled() )
+			{
+				m_sceneGraph->childrenUpdated();
+			}
+
 			return NULL;
 		}
 
@@ -568,13 +700,13 @@ class InteractiveRender::SceneGraphUpdateTask : public tbb::task
 			switch( m_sceneGraphType )
 			{
 				case SceneGraph::CameraType :
-					return m_interactiveRender->m_cameraSet.match( m_scenePath );
+					return m_interactiveRender->m_cameraSet.match( m_scenePath->names() );
 				case SceneGraph::LightType :
-					return m_interactiveRender->m_lightSet.match( m_scenePath );
+					return m_interactiveRender->m_lightSet.match( m_scenePath->names() );
 				case SceneGraph::ObjectType :
 				{
-					unsigned m = m_interactiveRender->m_lightSet.match( m_scenePath ) |
-					             m_interactiveRender->m_cameraSet.match( m_scenePath );
+					unsigned m = m_interactiveRender->m_lightSet.match( m_scenePath->names() ) |
+					             m_interactiveRender->m_cameraSet.match( m_scenePath->names() );
 					if( m & Filter::ExactMatch )
 					{
 						return Filter::AncestorMatch | Filter::DescendantMatch;
@@ -590,11 +722,13 @@ class InteractiveRender::SceneGraphUpdateTask : public tbb::task
 		}
 
 		const InteractiveRender *m_interactiveRender;
+		const Context *m_context;
+		const BackgroundTask::Canceller &m_canceller;
 		SceneGraph *m_sceneGraph;
 		SceneGraph::Type m_sceneGraphType;
 		unsigned m_dirtyComponents;
 		unsigned m_changedParentComponents;
-		ScenePlug::ScenePath m_scenePath;
+		ConstSharedScenePathPtr m_scenePath;
 
 };
 
@@ -694,6 +828,7 @@ void InteractiveRender::setContext( Gaffer::ContextPtr context )
 		return;
 	}
 
+	cancelUpdate();
 	m_context = context;
 	m_dirtyComponents = SceneGraph::AllComponents;
 	update();
@@ -702,33 +837,34 @@ void InteractiveRender::setContext( Gaffer::ContextPtr context )
 void InteractiveRender::plugDirtied( const Gaffer::Plug *plug )
 {
 
+	unsigned dirtyComponents = SceneGraph::NoComponent;
 	if( plug == inPlug()->boundPlug() )
 	{
-		m_dirtyComponents |= SceneGraph::BoundComponent;
+		dirtyComponents = SceneGraph::BoundComponent;
 	}
 	else if( plug == inPlug()->transformPlug() )
 	{
-		m_dirtyComponents |= SceneGraph::TransformComponent;
+		dirtyComponents = SceneGraph::TransformComponent;
 	}
 	else if( plug == inPlug()->attributesPlug() )
 	{
-		m_dirtyComponents |= SceneGraph::AttributesComponent;
+		dirtyComponents = SceneGraph::AttributesComponent;
 	}
 	else if( plug == inPlug()->objectPlug() )
 	{
-		m_dirtyComponents |= SceneGraph::ObjectComponent;
+		dirtyComponents = SceneGraph::ObjectComponent;
 	}
 	else if( plug == inPlug()->childNamesPlug() )
 	{
-		m_dirtyComponents |= SceneGraph::ChildNamesComponent;
+		dirtyComponents = SceneGraph::ChildNamesComponent;
 	}
 	else if( plug == inPlug()->globalsPlug() )
 	{
-		m_dirtyComponents |= SceneGraph::GlobalsComponent;
+		dirtyComponents = SceneGraph::GlobalsComponent;
 	}
 	else if( plug == inPlug()->setPlug() )
 	{
-		m_dirtyComponents |= SceneGraph::SetsComponent;
+		dirtyComponents = SceneGraph::SetsComponent;
 	}
 	else if( plug == rendererPlug() )
 	{
@@ -736,6 +872,15 @@ void InteractiveRender::plugDirtied( const Gaffer::Plug *plug )
 		m_dirtyComponents = SceneGraph::AllComponents;
 	}
 
+	if( dirtyComponents )
+	{
+		// Components accumulate until an update completes, so
+		// that an update which is superseded before completion
+		// is coalesced into the update that supersedes it.
+		cancelUpdate();
+		m_dirtyComponents |= dirtyComponents;
+	}
+
 	if( plug == inPlug() ||
 	    plug == statePlug()
 	)
@@ -757,12 +902,16 @@ void InteractiveRender::contextChanged( const IECore::InternedString &name )
 	{
 		return;
 	}
+	cancelUpdate();
 	m_dirtyComponents = SceneGraph::AllComponents;
 	update();
 }
 
 void InteractiveRender::update()
 {
+	// Any update in progress is superseded by this one.
+	cancelUpdate();
+
 	updateEffectiveContext();
 	Context::Scope scopedContext( m_effectiveContext.get() );
 
@@ -786,60 +935,148 @@ void InteractiveRender::update()
 			rendererPlug()->getValue(),
 			IECoreScenePreview::Renderer::Interactive
 		);
+		m_attributesCache = new AttributesCache( m_renderer.get() );
 	}
 
-	// We need to pause to make edits, even if we want to
-	// be running in the end.
-	m_renderer->pause();
 	if( requiredState == Paused )
 	{
+		m_renderer->pause();
 		m_state = requiredState;
 		return;
 	}
 
-	// We want to be running, so update the globals
-	// and the scene graph, and kick off a render.
+	// We want to be running, so update the globals and the
+	// scene graph in the background, keeping the UI responsive
+	// while we compute. We give the update its own copy of the
+	// context, so that the original may be edited freely in
+	// the meantime.
 	assert( requiredState == Running );
 
-	if( m_dirtyComponents & SceneGraph::GlobalsComponent )
-	{
-		ConstCompoundObjectPtr globals = inPlug()->globalsPlug()->getValue();
-		outputOptions( globals.get(), m_globals.get(), m_renderer.get() );
-		outputOutputs( globals.get(), m_globals.get(), m_renderer.get() );
-		m_globals = globals;
-	}
+	m_updateTask.reset(
+		new BackgroundTask(
+			this,
+			boost::bind( &InteractiveRender::updateInBackground, this, ::_1, ConstContextPtr( new Context( *m_effectiveContext ) ) )
+		)
+	);
+}
 
-	if( m_dirtyComponents & SceneGraph::SetsComponent )
+void InteractiveRender::updateInBackground( const Gaffer::BackgroundTask::Canceller &canceller, Gaffer::ConstContextPtr context )
+{
+	const unsigned dirtyComponents = m_dirtyComponents;
+	if( !dirtyComponents && m_state == Running )
 	{
-		m_lightSet = inPlug()->set( "__lights" )->readable();
-		m_cameraSet = inPlug()->set( "__cameras" )->readable();
+		// Nothing to do, and we don't want to
+		// disturb the renderer unnecessarily.
+		return;
 	}
 
-	for( int i = SceneGraph::FirstType; i <= SceneGraph::LastType; ++i )
+	try
 	{
-		SceneGraph *sceneGraph = m_sceneGraphs[i].get();
-		if( i == SceneGraph::CameraType && ( m_dirtyComponents & SceneGraph::GlobalsComponent ) )
-		{
-			// Because the globals are applied to camera objects, we must update the object whenever
-			// the globals have changed, so we clear the scene graph and start again. We don't expect
-			// this to be a big overhead because typically there aren't many cameras in a scene. If it
-			// does cause a problem, we could examine the exact changes to the globals and avoid clearing
-			// if we know they won't affect the camera.
-			sceneGraph->clear();
-		}
-		SceneGraphUpdateTask *task = new( tbb::task::allocate_root() ) SceneGraphUpdateTask( this, sceneGraph, (SceneGraph::Type)i, m_dirtyComponents, SceneGraph::NoComponent, ScenePlug::ScenePath() );
-		tbb::task::spawn_root_and_wait( *task );
-	}
+		Context::Scope scopedContext( context.get() );
+
+		// Compute everything we can while the renderer is still
+		// rendering the previous state of the scene.
+
+		ConstCompoundObjectPtr globals = m_globals;
+		if( dirtyComponents & SceneGraph::GlobalsComponent )
+		{
+			globals = inPlug()->globalsPlug()->getValue();
+		}
+
+		PathMatcher lightSet = m_lightSet;
+		PathMatcher cameraSet = m_cameraSet;
+		if( dirtyComponents & SceneGraph::SetsComponent )
+		{
+			lightSet = inPlug()->set( "__lights" )->readable();
+			cameraSet = inPlug()->set( "__cameras" )->readable();
+		}
+
+		ConstSharedScenePathPtr rootPath = new SharedScenePath;
+		for( int i = SceneGraph::FirstType; i <= SceneGraph::LastType; ++i )
+		{
+			if( canceller.cancelled() )
+			{
+				return;
+			}
+			SceneGraphPrefetchTask *task = new( tbb::task::allocate_root() ) SceneGraphPrefetchTask( inPlug(), context.get(), canceller, m_sceneGraphs[i].get(), dirtyComponents, rootPath.get() );
+			tbb::task::spawn_root_and_wait( *task );
+		}
+
+		if( canceller.cancelled() )
+		{
+			return;
+		}
+
+		// Pause the renderer and apply our changes. If we're
+		// cancelled part way through, we leave the renderer paused,
+		// because we'll be superseded by another update which will
+		// complete the job.
+
+		m_renderer->pause();
+
+		if( dirtyComponents & SceneGraph::GlobalsComponent )
+		{
+			outputOptions( globals.get(), m_globals.get(), m_renderer.get() );
+			outputOutputs( globals.get(), m_globals.get(), m_renderer.get() );
+			m_globals = globals;
+		}
+
+		if( dirtyComponents & SceneGraph::SetsComponent )
+		{
+			m_lightSet = lightSet;
+			m_cameraSet = cameraSet;
+		}
+
+		for( int i = SceneGraph::FirstType; i <= SceneGraph::LastType; ++i )
+		{
+			if( canceller.cancelled() )
+			{
+				return;
+			}
+			SceneGraph *sceneGraph = m_sceneGraphs[i].get();
+			if( i == SceneGraph::CameraType && ( dirtyComponents & SceneGraph::GlobalsComponent ) )
+			{
+				// Because the globals are applied to camera objects, we must update the object whenever
+				// the globals have changed, so we clear the scene graph and start again. We don't expect
+				// this to be a big overhead because typically there aren't many cameras in a scene. If it
+				// does cause a problem, we could examine the exact changes to the globals and avoid clearing
+				// if we know they won't affect the camera.
+				sceneGraph->clear();
+			}
+			SceneGraphUpdateTask *task = new( tbb::task::allocate_root() ) SceneGraphUpdateTask( this, context.get(), canceller, sceneGraph, (SceneGraph::Type)i, dirtyComponents, SceneGraph::NoComponent, rootPath.get() );
+			tbb::task::spawn_root_and_wait( *task );
+		}
+
+		if( canceller.cancelled() )
+		{
+			return;
+		}
+
+		if( dirtyComponents & SceneGraph::GlobalsComponent )
+		{
+			updateDefaultCamera();
+		}
+
+		// Release any attributes which are no longer
+		// in use by the scene graph.
+		m_attributesCache->clearUnused();
 
-	if( m_dirtyComponents & SceneGraph::GlobalsComponent )
+		m_dirtyComponents = SceneGraph::NoComponent;
+		m_state = Running;
+
+		m_renderer->render();
+	}
+	catch( const std::exception &e )
 	{
-		updateDefaultCamera();
+		IECore::msg( IECore::Msg::Error, "InteractiveRender::update", e.what() );
 	}
+}
 
-	m_dirtyComponents = SceneGraph::NoComponent;
-	m_state = requiredState;
-
-	m_renderer->render();
+void InteractiveRender::cancelUpdate()
+{
+	// Destroying the task cancels it and
+	// waits for it to complete.
+	m_updateTask.reset();
 }
 
 void InteractiveRender::updateEffectiveContext()
@@ -888,12 +1125,15 @@ void InteractiveRender::updateDefaultCamera()
 
 void InteractiveRender::stop()
 {
+	cancelUpdate();
+
 	m_sceneGraphs.clear();
 	for( int i = SceneGraph::FirstType; i <= SceneGraph::LastType; ++i )
 	{
 		m_sceneGraphs.push_back( boost::make_shared<SceneGraph>() );
 	}
 	m_defaultCamera = NULL;
+	m_attributesCache = NULL;
 	m_renderer = NULL;
 
 	m_globals = inPlug()->globalsPlug()->defaultValue();
@@ -208,9 +208,10 @@ void Render::execute() const
 
 	outputOptions( globals.get(), renderer.get() );
 	outputOutputs( globals.get(), renderer.get() );
-	outputCameras( inPlug(), globals.get(), renderer.get() );
-	outputLights( inPlug(), globals.get(), renderer.get() );
-	outputObjects( inPlug(), globals.get(), renderer.get() );
+	AttributesCachePtr attributesCache = new AttributesCache( renderer.get() );
+	outputCameras( inPlug(), globals.get(), renderer.get(), attributesCache.get() );
+	outputLights( inPlug(), globals.get(), renderer.get(), attributesCache.get() );
+	outputObjects( inPlug(), globals.get(), renderer.get(), attributesCache.get() );
 
 	renderer->render();
 }
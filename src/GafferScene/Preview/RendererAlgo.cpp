@@ -35,9 +35,14 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
-#include "tbb/task.h"
-
 #include "boost/algorithm/string/predicate.hpp"
+#include "boost/lexical_cast.hpp"
+#include "boost/shared_ptr.hpp"
+
+#include "tbb/concurrent_hash_map.h"
+#include "tbb/parallel_for.h"
+#include "tbb/pipeline.h"
+#include "tbb/task_scheduler_init.h"
 
 #include "IECore/Interpolator.h"
 #include "IECore/NullObject.h"
@@ -48,6 +53,7 @@
 #include "GafferScene/ScenePlug.h"
 #include "GafferScene/SceneAlgo.h"
 #include "GafferScene/RendererAlgo.h"
+#include "GafferScene/EncapsulatedInstances.h"
 
 using namespace std;
 using namespace Imath;
@@ -55,152 +61,155 @@ using namespace IECore;
 using namespace GafferScene;
 
 //////////////////////////////////////////////////////////////////////////
-// Potential replacement for SceneAlgo::parallelTraverse().
-// The original is pretty limited in that the processing at each
-// location is done in isolation, with no access to parent or child
-// results. This version copy constructs the functor for each location
-// from its parent, allowing state to be maintained through the traversal.
-//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+///////////////////////////////////////////////////////////////////////////
 
 namespace
 {
 
-template<typename Functor>
-class LocationTask : public tbb::task
+const std::string g_optionPrefix( "option:" );
+
+const IECore::InternedString g_cameraOptionLegacyName( "option:render:camera" );
+const InternedString g_transformBlurOptionName( "option:render:transformBlur" );
+const InternedString g_deformationBlurOptionName( "option:render:deformationBlur" );
+const InternedString g_shutterOptionName( "option:render:shutter" );
+
+static InternedString g_visibleAttributeName( "scene:visible" );
+static InternedString g_transformBlurAttributeName( "gaffer:transformBlur" );
+static InternedString g_transformBlurSegmentsAttributeName( "gaffer:transformBlurSegments" );
+static InternedString g_deformationBlurAttributeName( "gaffer:deformationBlur" );
+static InternedString g_deformationBlurSegmentsAttributeName( "gaffer:deformationBlurSegments" );
+
+IECore::InternedString optionName( const IECore::InternedString &globalsName )
+{
+	if( globalsName == g_cameraOptionLegacyName )
+	{
+		/// \todo Just rename the options themselves in StandardOptions and remove this?
+		return globalsName.string().substr( g_optionPrefix.size() + 7 );
+	}
+
+	return globalsName.string().substr( g_optionPrefix.size() );
+}
+
+// ObjectInterface used to represent all the instances from an
+// EncapsulatedInstances object. A renderer prototype is created once
+// for each prototype object, and then instanced once per instance,
+// allowing renderers with native instancing support to share the
+// geometry. Instances are named "<name>/<id><prototypeName>", where
+// the root prototype is named "/" and therefore contributes nothing
+// to the name. All instances receive the attributes of the location
+// holding the EncapsulatedInstances; attributes and set memberships
+// from within the prototype hierarchy are not represented, as
+// documented in EncapsulatedInstances.h.
+class EncapsulatedInstancesInterface : public IECoreScenePreview::Renderer::ObjectInterface
 {
 
 	public :
 
-		LocationTask(
-			const GafferScene::ScenePlug *scene,
-			const Gaffer::Context *context,
-			const ScenePlug::ScenePath &path,
-			Functor &f
-		)
-			:	m_scene( scene ), m_context( context ), m_path( path ), m_f( f )
+		EncapsulatedInstancesInterface( const std::string &name, const EncapsulatedInstances *instances, const IECoreScenePreview::Renderer::AttributesInterface *attributes, IECoreScenePreview::Renderer *renderer )
 		{
-		}
+			const vector<M44f> &instanceTransforms = instances->instanceTransforms()->readable();
+			const vector<int> &instanceIds = instances->instanceIds()->readable();
+			const vector<M44f> &prototypeTransforms = instances->prototypeTransforms()->readable();
+			const vector<string> &prototypeNames = instances->prototypeNames()->readable();
+			const ObjectVector::MemberContainer &prototypes = instances->prototypes()->members();
+
+			m_prototypes.reserve( prototypes.size() );
+			for( ObjectVector::MemberContainer::const_iterator it = prototypes.begin(), eIt = prototypes.end(); it != eIt; ++it )
+			{
+				m_prototypes.push_back( renderer->prototype( it->get() ) );
+			}
 
-		virtual ~LocationTask()
-		{
+			const size_t numObjects = instanceTransforms.size() * prototypes.size();
+			m_objects.reserve( numObjects );
+			m_transforms.reserve( numObjects );
+
+			for( size_t i = 0, e = instanceTransforms.size(); i < e; ++i )
+			{
+				const std::string instanceName = name + "/" + boost::lexical_cast<std::string>( instanceIds[i] );
+				for( size_t j = 0, pe = prototypes.size(); j < pe; ++j )
+				{
+					m_objects.push_back(
+						renderer->instance(
+							prototypeNames[j] == "/" ? instanceName : instanceName + prototypeNames[j],
+							m_prototypes[j].get(),
+							attributes
+						)
+					);
+					m_transforms.push_back( prototypeTransforms[j] * instanceTransforms[i] );
+				}
+			}
 		}
 
-		virtual task *execute()
+		virtual void transform( const Imath::M44f &transform )
 		{
-			Gaffer::ContextPtr context = new Gaffer::Context( *m_context, Gaffer::Context::Borrowed );
-			context->set( ScenePlug::scenePathContextName, m_path );
-			Gaffer::Context::Scope scopedContext( context.get() );
-
-			if( !m_f( m_scene, m_path ) )
+			for( size_t i = 0, e = m_objects.size(); i < e; ++i )
 			{
-				return NULL;
+				if( m_objects[i] )
+				{
+					m_objects[i]->transform( m_transforms[i] * transform );
+				}
 			}
+		}
 
-			IECore::ConstInternedStringVectorDataPtr childNamesData = m_scene->childNamesPlug()->getValue();
-			const std::vector<IECore::InternedString> &childNames = childNamesData->readable();
-			if( childNames.empty() )
+		virtual void transform( const std::vector<Imath::M44f> &samples, const std::vector<float> &times )
+		{
+			vector<M44f> objectSamples( samples.size() );
+			for( size_t i = 0, e = m_objects.size(); i < e; ++i )
 			{
-				return NULL;
+				if( !m_objects[i] )
+				{
+					continue;
+				}
+				for( size_t s = 0, se = samples.size(); s < se; ++s )
+				{
+					objectSamples[s] = m_transforms[i] * samples[s];
+				}
+				m_objects[i]->transform( objectSamples, times );
 			}
+		}
 
-			std::vector<Functor> childFunctors( childNames.size(), m_f );
-
-			set_ref_count( 1 + childNames.size() );
-
-			ScenePlug::ScenePath childPath = m_path;
-			childPath.push_back( IECore::InternedString() ); // space for the child name
-			for( size_t i = 0, e = childNames.size(); i < e; ++i )
+		virtual void attributes( const IECoreScenePreview::Renderer::AttributesInterface *attributes )
+		{
+			for( vector<IECoreScenePreview::Renderer::ObjectInterfacePtr>::const_iterator it = m_objects.begin(), eIt = m_objects.end(); it != eIt; ++it )
 			{
-				childPath.back() = childNames[i];
-				LocationTask *t = new( allocate_child() ) LocationTask( m_scene, m_context, childPath, childFunctors[i] );
-				spawn( *t );
+				if( *it )
+				{
+					(*it)->attributes( attributes );
+				}
 			}
-			wait_for_all();
-
-			return NULL;
 		}
 
 	private :
 
-		const GafferScene::ScenePlug *m_scene;
-		const Gaffer::Context *m_context;
-		const GafferScene::ScenePlug::ScenePath m_path;
-		Functor &m_f;
+		vector<IECoreScenePreview::Renderer::PrototypeInterfacePtr> m_prototypes;
+		vector<IECoreScenePreview::Renderer::ObjectInterfacePtr> m_objects;
+		vector<M44f> m_transforms;
 
 };
 
-/// Invokes the Functor at every location in the scene,
-/// visiting parent locations before their children, but
-/// otherwise processing locations in parallel as much
-/// as possible.
-///
-/// Functor should be of the following form.
-///
-/// ```
-/// struct Functor
-/// {
-///
-///	    /// Called to construct a new functor to be used at
-///     /// each child location. This allows state to be
-///     /// accumulated as the scene is traversed, with each
-///     /// parent passing its state to its children.
-///     Functor( const Functor &parent );
-///
-///     /// Called to process a specific location. May return
-///     /// false to prune the traversal, or true to continue
-///     /// to the children.
-///     bool operator()( const ScenePlug *scene, const ScenePlug::ScenePath &path );
-///
-/// };
-/// ```
-template <class Functor>
-void parallelProcessLocations( const GafferScene::ScenePlug *scene, Functor &f )
-{
-	Gaffer::ContextPtr c = new Gaffer::Context( *Gaffer::Context::current(), Gaffer::Context::Borrowed );
-	GafferScene::Filter::setInputScene( c.get(), scene );
-	LocationTask<Functor> *task = new( tbb::task::allocate_root() ) LocationTask<Functor>( scene, c.get(), ScenePlug::ScenePath(), f );
-	tbb::task::spawn_root_and_wait( *task );
-}
-
-} // namespace
-
-//////////////////////////////////////////////////////////////////////////
-// Internal utilities
-///////////////////////////////////////////////////////////////////////////
-
-namespace
+void applyTransform( IECoreScenePreview::Renderer::ObjectInterface *objectInterface, const vector<M44f> &samples, const vector<float> &times )
 {
-
-const std::string g_optionPrefix( "option:" );
-
-const IECore::InternedString g_cameraOptionLegacyName( "option:render:camera" );
-const InternedString g_transformBlurOptionName( "option:render:transformBlur" );
-const InternedString g_deformationBlurOptionName( "option:render:deformationBlur" );
-const InternedString g_shutterOptionName( "option:render:shutter" );
-
-static InternedString g_visibleAttributeName( "scene:visible" );
-static InternedString g_transformBlurAttributeName( "gaffer:transformBlur" );
-static InternedString g_transformBlurSegmentsAttributeName( "gaffer:transformBlurSegments" );
-static InternedString g_deformationBlurAttributeName( "gaffer:deformationBlur" );
-static InternedString g_deformationBlurSegmentsAttributeName( "gaffer:deformationBlurSegments" );
-
-IECore::InternedString optionName( const IECore::InternedString &globalsName )
-{
-	if( globalsName == g_cameraOptionLegacyName )
+	if( !samples.size() )
 	{
-		/// \todo Just rename the options themselves in StandardOptions and remove this?
-		return globalsName.string().substr( g_optionPrefix.size() + 7 );
+		return;
+	}
+	else if( !times.size() )
+	{
+		objectInterface->transform( samples[0] );
+	}
+	else
+	{
+		objectInterface->transform( samples, times );
 	}
-
-	return globalsName.string().substr( g_optionPrefix.size() );
 }
 
 // Base class for functors which output objects/lights etc.
 struct LocationOutput
 {
 
-	LocationOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals )
-		:	m_renderer( renderer ), m_attributes( globalAttributes( globals ) )
+	LocationOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals, Preview::AttributesCache *attributesCache )
+		:	m_renderer( renderer ), m_attributes( globalAttributes( globals ) ), m_attributesCache( attributesCache )
 	{
 		const BoolData *transformBlurData = globals->member<BoolData>( g_transformBlurOptionName );
 		m_options.transformBlur = transformBlurData ? transformBlurData->readable() : false;
@@ -249,29 +258,32 @@ struct LocationOutput
 
 		IECoreScenePreview::Renderer::AttributesInterfacePtr attributes()
 		{
-			/// \todo Should we keep a cache of AttributesInterfaces so we can share
-			/// them between multiple objects, or should we rely on the renderers to
-			/// do something similar? Since renderers might cache some attributes
-			/// (e.g. "ai:surface") separately from others, they can do a better job,
-			/// but perhaps there might be some value in caching here at the higher
-			/// level too?
-			return m_renderer->attributes( m_attributes.get() );
+			// Our interface is inherited by copies made for child locations, so
+			// locations without attributes of their own don't even need to
+			// consult the cache.
+			if( !m_attributesInterface )
+			{
+				m_attributesInterface = m_attributesCache->get( m_attributes.get() );
+			}
+			return m_attributesInterface;
 		}
 
 		void applyTransform( IECoreScenePreview::Renderer::ObjectInterface *objectInterface )
 		{
-			if( !m_transformSamples.size() )
-			{
-				return;
-			}
-			else if( !m_transformTimes.size() )
-			{
-				objectInterface->transform( m_transformSamples[0] );
-			}
-			else
-			{
-				objectInterface->transform( m_transformSamples, m_transformTimes );
-			}
+			::applyTransform( objectInterface, m_transformSamples, m_transformTimes );
+		}
+
+		// Flattened transform for the current location, for use by derived
+		// classes which defer output until after the traversal.
+
+		const std::vector<M44f> &transformSamples() const
+		{
+			return m_transformSamples;
+		}
+
+		const std::vector<float> &transformTimes() const
+		{
+			return m_transformTimes;
 		}
 
 	private :
@@ -297,7 +309,8 @@ struct LocationOutput
 
 		void updateAttributes( const ScenePlug *scene )
 		{
-			IECore::ConstCompoundObjectPtr attributes = scene->attributesPlug()->getValue();
+			const IECore::MurmurHash attributesHash = scene->attributesPlug()->hash();
+			IECore::ConstCompoundObjectPtr attributes = scene->attributesPlug()->getValue( &attributesHash );
 			if( attributes->members().empty() )
 			{
 				return;
@@ -312,6 +325,7 @@ struct LocationOutput
 			}
 
 			m_attributes = updatedAttributes;
+			m_attributesInterface = NULL;
 		}
 
 		void updateTransform( const ScenePlug *scene )
@@ -386,6 +400,8 @@ struct LocationOutput
 
 		Options m_options;
 		IECore::ConstCompoundObjectPtr m_attributes;
+		Preview::AttributesCache *m_attributesCache;
+		IECoreScenePreview::Renderer::AttributesInterfacePtr m_attributesInterface;
 
 		std::vector<M44f> m_transformSamples;
 		std::vector<float> m_transformTimes;
@@ -395,8 +411,8 @@ struct LocationOutput
 struct CameraOutput : public LocationOutput
 {
 
-	CameraOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals, const PathMatcher &cameraSet )
-		:	LocationOutput( renderer, globals ), m_globals( globals ), m_cameraSet( cameraSet )
+	CameraOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals, Preview::AttributesCache *attributesCache, const PathMatcher &cameraSet )
+		:	LocationOutput( renderer, globals, attributesCache ), m_globals( globals ), m_cameraSet( cameraSet )
 	{
 	}
 
@@ -442,8 +458,8 @@ struct CameraOutput : public LocationOutput
 struct LightOutput : public LocationOutput
 {
 
-	LightOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals, const PathMatcher &lightSet )
-		:	LocationOutput( renderer, globals ), m_lightSet( lightSet )
+	LightOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals, Preview::AttributesCache *attributesCache, const PathMatcher &lightSet )
+		:	LocationOutput( renderer, globals, attributesCache ), m_lightSet( lightSet )
 	{
 	}
 
@@ -477,74 +493,594 @@ struct LightOutput : public LocationOutput
 
 };
 
-struct ObjectOutput : public LocationOutput
+struct MurmurHashCompare
 {
+	static size_t hash( const IECore::MurmurHash &h )
+	{
+		return hash_value( h );
+	}
 
-	ObjectOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals, const PathMatcher &cameraSet, const PathMatcher &lightSet )
-		:	LocationOutput( renderer, globals ), m_cameraSet( cameraSet ), m_lightSet( lightSet )
+	static bool equal( const IECore::MurmurHash &h1, const IECore::MurmurHash &h2 )
 	{
+		return h1 == h2;
 	}
+};
 
-	bool operator()( const ScenePlug *scene, const ScenePlug::ScenePath &path )
+IECoreScenePreview::Renderer::ObjectInterfacePtr outputObjectSamples( const std::string &name, const vector<ConstVisibleRenderablePtr> &samples, const set<float> &sampleTimes, const IECoreScenePreview::Renderer::AttributesInterface *attributes, IECoreScenePreview::Renderer *renderer )
+{
+	if( !sampleTimes.size() )
 	{
-		if( !LocationOutput::operator()( scene, path ) )
+		return Preview::outputObject( name, samples[0].get(), attributes, renderer );
+	}
+
+	/// \todo Can we rejig things so these conversions aren't necessary?
+	vector<const Object *> objectsVector; objectsVector.reserve( samples.size() );
+	vector<float> timesVector( sampleTimes.begin(), sampleTimes.end() );
+	for( vector<ConstVisibleRenderablePtr>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
+	{
+		objectsVector.push_back( it->get() );
+	}
+	return renderer->object( name, objectsVector, timesVector, attributes );
+}
+
+// Maps from the hash of an object's samples to a prototype created by
+// the renderer, so that identical objects are only evaluated and converted
+// once, and are subsequently output using Renderer::instance(). The uses of
+// each object are counted in advance, so that objects used only once need not
+// be made into prototypes at all, and so that each prototype can be released
+// as soon as its last instance has been output.
+class PrototypeCache : public IECore::RefCounted
+{
+
+	public :
+
+		PrototypeCache( IECoreScenePreview::Renderer *renderer )
+			:	m_renderer( renderer )
 		{
-			return false;
 		}
 
-		if( ( m_cameraSet.match( path ) & Filter::ExactMatch ) || ( m_lightSet.match( path ) & Filter::ExactMatch ) )
+		// Registers a location using the object with the specified hash.
+		// Must be called for all locations prior to any calls to `get()`.
+		// May be called concurrently.
+		void addUse( const IECore::MurmurHash &hash )
 		{
-			return true;
+			Cache::accessor a;
+			m_cache.insert( a, hash );
+			a->second.uses++;
 		}
 
-		vector<ConstVisibleRenderablePtr> samples; set<float> sampleTimes;
-		objectSamples( scene, deformationSegments(), shutter(), samples, sampleTimes );
-		if( !samples.size() )
+		// Returns true if the object is used by more than one location,
+		// in which case it should be output using `get()`.
+		bool shared( const IECore::MurmurHash &hash ) const
 		{
-			return true;
+			Cache::const_accessor a;
+			return m_cache.find( a, hash ) && a->second.uses > 1;
 		}
 
-		std::string name;
-		ScenePlug::pathToString( path, name );
-		IECoreScenePreview::Renderer::ObjectInterfacePtr objectInterface;
-		IECoreScenePreview::Renderer::AttributesInterfacePtr attributesInterface = attributes();
-		if( !sampleTimes.size() )
+		// Returns the prototype for the object at the current location, or NULL
+		// if it cannot be instanced and must be output directly instead. Must be
+		// called exactly once for each use of a shared object. May be called
+		// concurrently.
+		IECoreScenePreview::Renderer::PrototypeInterfacePtr get( const IECore::MurmurHash &hash, const ScenePlug *scene, size_t segments, const V2f &shutter )
 		{
-			objectInterface = renderer()->object( name, samples[0].get(), attributesInterface.get() );
+			bool initialised = false;
+			IECoreScenePreview::Renderer::PrototypeInterfacePtr result;
+			{
+				Cache::const_accessor a;
+				if( !m_cache.find( a, hash ) )
+				{
+					throw IECore::Exception( "Unregistered object" );
+				}
+				initialised = a->second.initialised;
+				result = a->second.prototype;
+			}
+
+			if( !initialised )
+			{
+				// We must not hold an accessor while computing the prototype,
+				// because the computation may spawn nested TBB tasks, and this
+				// thread may steal a task which calls `get()` for the same hash
+				// while it waits. Instead we compute without a lock, and keep
+				// only the first result if several threads compute concurrently.
+				result = prototype( scene, segments, shutter );
+			}
+
+			Cache::accessor a;
+			m_cache.find( a, hash );
+			Entry &entry = a->second;
+			if( !entry.initialised )
+			{
+				entry.prototype = result;
+				entry.initialised = true;
+			}
+			result = entry.prototype;
+
+			if( ++entry.gets == entry.uses )
+			{
+				// Last use - release the prototype and the
+				// object data it holds.
+				m_cache.erase( a );
+			}
+			return result;
 		}
-		else
+
+	private :
+
+		IECoreScenePreview::Renderer::PrototypeInterfacePtr prototype( const ScenePlug *scene, size_t segments, const V2f &shutter )
 		{
-			/// \todo Can we rejig things so these conversions aren't necessary?
+			// The prototype holds the object for all its uses,
+			// so there's no need for the compute cache to hold
+			// it as well.
+			Gaffer::ValuePlug::UncachedScope uncachedScope;
+
+			vector<ConstVisibleRenderablePtr> samples; set<float> sampleTimes;
+			objectSamples( scene, segments, shutter, samples, sampleTimes );
+			if( !samples.size() || runTimeCast<const EncapsulatedInstances>( samples[0].get() ) )
+			{
+				// EncapsulatedInstances are expanded by Preview::outputObject(),
+				// so can't be passed to the renderer as a prototype.
+				return NULL;
+			}
+
+			if( !sampleTimes.size() )
+			{
+				return m_renderer->prototype( samples[0].get() );
+			}
+
 			vector<const Object *> objectsVector; objectsVector.reserve( samples.size() );
 			vector<float> timesVector( sampleTimes.begin(), sampleTimes.end() );
 			for( vector<ConstVisibleRenderablePtr>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
 			{
 				objectsVector.push_back( it->get() );
 			}
-			objectInterface = renderer()->object( name, objectsVector, timesVector, attributesInterface.get() );
+			return m_renderer->prototype( objectsVector, timesVector );
 		}
 
-		applyTransform( objectInterface.get() );
+		struct Entry
+		{
+			Entry() : uses( 0 ), gets( 0 ), initialised( false ) {}
+			size_t uses;
+			size_t gets;
+			bool initialised;
+			IECoreScenePreview::Renderer::PrototypeInterfacePtr prototype;
+		};
+
+		typedef tbb::concurrent_hash_map<IECore::MurmurHash, Entry, MurmurHashCompare> Cache;
+
+		IECoreScenePreview::Renderer *m_renderer;
+		Cache m_cache;
+
+};
+
+IE_CORE_DECLAREPTR( PrototypeCache )
+
+// Objects are output in two passes. The first is a parallel traversal
+// of the scene which counts the uses of each unique object, so that the
+// PrototypeCache knows which objects are shared before any are output.
+// The second streams locations into a pipeline as they are found, where
+// their objects are evaluated and output in parallel, and released as soon
+// as they have been passed to the renderer. Only a bounded number of
+// locations are gathered ahead of output, so peak memory does not grow
+// with the number of locations in the scene.
+
+size_t g_maxObjectsInFlight = tbb::task_scheduler_init::default_num_threads();
+
+struct ObjectLocation
+{
+	ScenePlug::ScenePath path;
+	IECore::MurmurHash objectHash;
+	size_t deformationSegments;
+	IECoreScenePreview::Renderer::AttributesInterfacePtr attributes;
+	std::vector<M44f> transformSamples;
+	std::vector<float> transformTimes;
+};
+
+typedef boost::shared_ptr<ObjectLocation> ObjectLocationPtr;
+
+// Determines which locations have objects to output, for use by
+// both passes.
+struct ObjectGatherer : public LocationOutput
+{
+
+	ObjectGatherer( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals, Preview::AttributesCache *attributesCache, const PathMatcher &cameraSet, const PathMatcher &lightSet, const IECore::MurmurHash &nullObjectHash )
+		:	LocationOutput( renderer, globals, attributesCache ), m_cameraSet( &cameraSet ), m_lightSet( &lightSet ), m_nullObjectHash( &nullObjectHash )
+	{
+	}
+
+	// Returns true if the current location may have an object to output,
+	// filling in the hash of the object and its deformation segments. Must
+	// only be called once `operator()` has returned true for the location.
+	bool objectHash( const ScenePlug *scene, const ScenePlug::ScenePath &path, IECore::MurmurHash &hash, size_t &segments )
+	{
+		if( ( m_cameraSet->match( path ) & Filter::ExactMatch ) || ( m_lightSet->match( path ) & Filter::ExactMatch ) )
+		{
+			return false;
+		}
+
+		segments = deformationSegments();
+		hash = objectSamplesHash( scene, segments, shutter() );
+		// Cheap early out for the many locations
+		// which are known not to have an object.
+		return segments || hash != *m_nullObjectHash;
+	}
+
+	// Returns the ObjectLocation to output for the current location,
+	// or NULL if it has no object.
+	ObjectLocationPtr objectLocation( const ScenePlug *scene, const ScenePlug::ScenePath &path )
+	{
+		IECore::MurmurHash hash; size_t segments = 0;
+		if( !objectHash( scene, path, hash, segments ) )
+		{
+			return ObjectLocationPtr();
+		}
+
+		ObjectLocationPtr location( new ObjectLocation );
+		location->path = path;
+		location->objectHash = hash;
+		location->deformationSegments = segments;
+		// The interface is shared by all locations inheriting the same
+		// attributes, so the attributes are only hashed and converted
+		// once per distinct block, rather than once per location.
+		location->attributes = attributes();
+		location->transformSamples = transformSamples();
+		location->transformTimes = transformTimes();
+		return location;
+	}
+
+	private :
+
+		// Pointers rather than references, so that gatherers
+		// may be stored by the ObjectLocationGenerator.
+		const PathMatcher *m_cameraSet;
+		const PathMatcher *m_lightSet;
+		const IECore::MurmurHash *m_nullObjectHash;
+
+};
+
+// Functor for the first pass, registering each use of an
+// object with the PrototypeCache.
+struct ObjectUseCounter : public ObjectGatherer
+{
+
+	ObjectUseCounter( const ObjectGatherer &gatherer, PrototypeCache *prototypeCache )
+		:	ObjectGatherer( gatherer ), m_prototypeCache( prototypeCache )
+	{
+	}
+
+	bool operator()( const ScenePlug *scene, const ScenePlug::ScenePath &path )
+	{
+		if( !LocationOutput::operator()( scene, path ) )
+		{
+			return false;
+		}
+
+		IECore::MurmurHash hash; size_t segments = 0;
+		if( objectHash( scene, path, hash, segments ) )
+		{
+			m_prototypeCache->addUse( hash );
+		}
 
 		return true;
 	}
 
-	const PathMatcher &m_cameraSet;
-	const PathMatcher &m_lightSet;
+	PrototypeCache *m_prototypeCache;
+
+};
+
+// A location visited during the second pass, along with
+// the state to be inherited by its children.
+struct VisitedLocation
+{
+
+	VisitedLocation( const ObjectGatherer &gatherer )
+		:	gatherer( gatherer )
+	{
+	}
+
+	ScenePlug::ScenePath path;
+	ObjectGatherer gatherer;
+	// NULL if the location has no object.
+	ObjectLocationPtr location;
+	// NULL if the location is invisible, in which
+	// case its children are not visited.
+	IECore::ConstInternedStringVectorDataPtr childNames;
+
+};
+
+// Visits a batch of sibling locations in parallel.
+class VisitLocations
+{
+
+	public :
+
+		VisitLocations( const ScenePlug *scene, const Gaffer::Context *context, std::vector<VisitedLocation> &locations )
+			:	m_scene( scene ), m_context( context ), m_locations( locations )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			Gaffer::ContextPtr context = new Gaffer::Context( *m_context, Gaffer::Context::Borrowed );
+			Gaffer::Context::Scope scopedContext( context.get() );
+
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				VisitedLocation &location = m_locations[i];
+				context->set( ScenePlug::scenePathContextName, location.path );
+				if( !location.gatherer( m_scene, location.path ) )
+				{
+					continue;
+				}
+				location.location = location.gatherer.objectLocation( m_scene, location.path );
+				location.childNames = m_scene->childNamesPlug()->getValue();
+			}
+		}
+
+	private :
+
+		const ScenePlug *m_scene;
+		const Gaffer::Context *m_context;
+		std::vector<VisitedLocation> &m_locations;
+
+};
+
+// Serial pipeline stage which traverses the scene depth first, feeding
+// locations with objects to the ObjectOutput stage as they are found.
+// Siblings are visited in parallel batches, so that the traversal keeps
+// pace with the output, but at most one batch is held for each level of
+// the hierarchy.
+class ObjectLocationGenerator
+{
+
+	public :
+
+		ObjectLocationGenerator( const ScenePlug *scene, const Gaffer::Context *context, const ObjectGatherer &gatherer, size_t batchSize )
+			:	m_scene( scene ), m_context( context ), m_batchSize( batchSize )
+		{
+			// The root is visited in a batch of its own.
+			m_pending.push_back( PendingLocations( gatherer ) );
+			m_pending.back().batch.push_back( VisitedLocation( gatherer ) );
+			VisitLocations visitRoot( m_scene, m_context, m_pending.back().batch );
+			visitRoot( tbb::blocked_range<size_t>( 0, 1 ) );
+		}
+
+		ObjectLocationPtr operator()( tbb::flow_control &fc ) const
+		{
+			while( !m_pending.empty() )
+			{
+				PendingLocations &pending = m_pending.back();
+				if( pending.nextInBatch == pending.batch.size() )
+				{
+					if( !pending.childNames || pending.nextChild == pending.childNames->readable().size() )
+					{
+						m_pending.pop_back();
+						continue;
+					}
+					visitNextBatch( pending );
+				}
+
+				VisitedLocation &visited = pending.batch[pending.nextInBatch++];
+				ObjectLocationPtr result;
+				result.swap( visited.location );
+				if( visited.childNames && !visited.childNames->readable().empty() )
+				{
+					// Descend into the children before visiting the
+					// remaining siblings. Note that this invalidates
+					// `pending` and `visited`.
+					PendingLocations children( visited.gatherer );
+					children.path.swap( visited.path );
+					children.childNames.swap( visited.childNames );
+					m_pending.push_back( children );
+				}
+
+				if( result )
+				{
+					return result;
+				}
+			}
+
+			fc.stop();
+			return ObjectLocationPtr();
+		}
+
+	private :
+
+		// The children of a location, in the process
+		// of being visited.
+		struct PendingLocations
+		{
+
+			PendingLocations( const ObjectGatherer &gatherer )
+				:	gatherer( gatherer ), nextChild( 0 ), nextInBatch( 0 )
+			{
+			}
+
+			ScenePlug::ScenePath path;
+			ObjectGatherer gatherer;
+			IECore::ConstInternedStringVectorDataPtr childNames;
+			size_t nextChild;
+			std::vector<VisitedLocation> batch;
+			size_t nextInBatch;
+
+		};
+
+		void visitNextBatch( PendingLocations &pending ) const
+		{
+			const vector<InternedString> &childNames = pending.childNames->readable();
+			const size_t end = std::min( pending.nextChild + m_batchSize, childNames.size() );
+
+			pending.batch.assign( end - pending.nextChild, VisitedLocation( pending.gatherer ) );
+			for( size_t i = 0, e = pending.batch.size(); i < e; ++i )
+			{
+				ScenePlug::ScenePath &path = pending.batch[i].path;
+				path.reserve( pending.path.size() + 1 );
+				path.insert( path.end(), pending.path.begin(), pending.path.end() );
+				path.push_back( childNames[pending.nextChild + i] );
+			}
+			pending.nextChild = end;
+			pending.nextInBatch = 0;
+
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, pending.batch.size() ),
+				VisitLocations( m_scene, m_context, pending.batch )
+			);
+		}
+
+		const ScenePlug *m_scene;
+		const Gaffer::Context *m_context;
+		size_t m_batchSize;
+		// Mutable because tbb requires the operator to be const,
+		// but each filter is only ever run on one thread at a time.
+		mutable std::vector<PendingLocations> m_pending;
+
+};
+
+// Parallel pipeline stage which evaluates and outputs an object.
+class ObjectOutput
+{
+
+	public :
+
+		ObjectOutput( const ScenePlug *scene, const Gaffer::Context *context, IECoreScenePreview::Renderer *renderer, PrototypeCache *prototypeCache, const V2f &shutter )
+			:	m_scene( scene ), m_context( context ), m_renderer( renderer ), m_prototypeCache( prototypeCache ), m_shutter( shutter )
+		{
+		}
+
+		void operator()( ObjectLocationPtr location ) const
+		{
+			Gaffer::ContextPtr context = new Gaffer::Context( *m_context, Gaffer::Context::Borrowed );
+			context->set( ScenePlug::scenePathContextName, location->path );
+			Gaffer::Context::Scope scopedContext( context.get() );
+
+			std::string name;
+			ScenePlug::pathToString( location->path, name );
+
+			IECoreScenePreview::Renderer::ObjectInterfacePtr objectInterface;
+			if( m_prototypeCache->shared( location->objectHash ) )
+			{
+				// Identical objects are output as instances of a single prototype, so
+				// that we don't evaluate or convert them more than once.
+				IECoreScenePreview::Renderer::PrototypeInterfacePtr prototype = m_prototypeCache->get( location->objectHash, m_scene, location->deformationSegments, m_shutter );
+				if( prototype )
+				{
+					objectInterface = m_renderer->instance( name, prototype.get(), location->attributes.get() );
+				}
+				else
+				{
+					objectInterface = output( name, location );
+				}
+			}
+			else
+			{
+				// Nothing else needs this object, so there's no point in
+				// holding on to it in the compute cache once we're done.
+				Gaffer::ValuePlug::UncachedScope uncachedScope;
+				objectInterface = output( name, location );
+			}
+
+			if( objectInterface )
+			{
+				applyTransform( objectInterface.get(), location->transformSamples, location->transformTimes );
+			}
+		}
+
+	private :
+
+		IECoreScenePreview::Renderer::ObjectInterfacePtr output( const std::string &name, const ObjectLocationPtr &location ) const
+		{
+			vector<ConstVisibleRenderablePtr> samples; set<float> sampleTimes;
+			objectSamples( m_scene, location->deformationSegments, m_shutter, samples, sampleTimes );
+			if( !samples.size() )
+			{
+				return NULL;
+			}
+			return outputObjectSamples( name, samples, sampleTimes, location->attributes.get(), m_renderer );
+		}
+
+		const ScenePlug *m_scene;
+		const Gaffer::Context *m_context;
+		IECoreScenePreview::Renderer *m_renderer;
+		PrototypeCache *m_prototypeCache;
+		V2f m_shutter;
 
 };
 
 } // namespace
 
+namespace GafferScene
+{
+
+namespace Preview
+{
+
 //////////////////////////////////////////////////////////////////////////
-// Public methods for outputting globals.
+// AttributesCache
 //////////////////////////////////////////////////////////////////////////
 
-namespace GafferScene
+AttributesCache::AttributesCache( IECoreScenePreview::Renderer *renderer )
+	:	m_renderer( renderer )
 {
+}
 
-namespace Preview
+AttributesCache::~AttributesCache()
+{
+}
+
+IECoreScenePreview::Renderer::AttributesInterfacePtr AttributesCache::get( const IECore::CompoundObject *attributes )
+{
+	const IECore::MurmurHash hash = attributes->hash();
+	{
+		Map::const_accessor a;
+		if( m_map.find( a, hash ) )
+		{
+			return a->second;
+		}
+	}
+
+	// We create the interface without holding an accessor, so that
+	// other threads are not blocked while the renderer converts the
+	// attributes. If another thread beats us to it, we use its
+	// interface and discard ours, so all locations share a single one.
+	IECoreScenePreview::Renderer::AttributesInterfacePtr attributesInterface = m_renderer->attributes( attributes );
+
+	Map::accessor a;
+	if( m_map.insert( a, hash ) )
+	{
+		a->second = attributesInterface;
+	}
+	return a->second;
+}
+
+void AttributesCache::clearUnused()
+{
+	vector<IECore::MurmurHash> toErase;
+	for( Map::const_iterator it = m_map.begin(), eIt = m_map.end(); it != eIt; ++it )
+	{
+		if( it->second->refCount() == 1 )
+		{
+			toErase.push_back( it->first );
+		}
+	}
+
+	for( vector<IECore::MurmurHash>::const_iterator it = toErase.begin(), eIt = toErase.end(); it != eIt; ++it )
+	{
+		m_map.erase( *it );
+	}
+}
+
+size_t AttributesCache::HashCompare::hash( const IECore::MurmurHash &h )
+{
+	return hash_value( h );
+}
+
+bool AttributesCache::HashCompare::equal( const IECore::MurmurHash &h1, const IECore::MurmurHash &h2 )
 {
+	return h1 == h2;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Public methods for outputting globals.
+//////////////////////////////////////////////////////////////////////////
 
 void outputOptions( const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer )
 {
@@ -668,8 +1204,9 @@ void outputOutputs( const IECore::CompoundObject *globals, const IECore::Compoun
 	}
 }
 
-void outputCameras( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer )
+void outputCameras( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer, AttributesCache *attributesCache )
 {
+	AttributesCachePtr localAttributesCache = attributesCache ? attributesCache : new AttributesCache( renderer );
 	ConstPathMatcherDataPtr cameraSet = scene->set( "__cameras" );
 
 	const StringData *cameraOption = globals->member<StringData>( g_cameraOptionLegacyName );
@@ -686,7 +1223,7 @@ void outputCameras( const ScenePlug *scene, const IECore::CompoundObject *global
 		}
 	}
 
-	CameraOutput output( renderer, globals, cameraSet->readable() );
+	CameraOutput output( renderer, globals, localAttributesCache.get(), cameraSet->readable() );
 	parallelProcessLocations( scene, output );
 
 	if( !cameraOption || cameraOption->readable().empty() )
@@ -703,19 +1240,63 @@ void outputCameras( const ScenePlug *scene, const IECore::CompoundObject *global
 	}
 }
 
-void outputLights( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer )
+void outputLights( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer, AttributesCache *attributesCache )
 {
+	AttributesCachePtr localAttributesCache = attributesCache ? attributesCache : new AttributesCache( renderer );
 	ConstPathMatcherDataPtr lightSet = scene->set( "__lights" );
-	LightOutput output( renderer, globals, lightSet->readable() );
+	LightOutput output( renderer, globals, localAttributesCache.get(), lightSet->readable() );
 	parallelProcessLocations( scene, output );
 }
 
-void outputObjects( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer )
+IECoreScenePreview::Renderer::ObjectInterfacePtr outputObject( const std::string &name, const IECore::Object *object, const IECoreScenePreview::Renderer::AttributesInterface *attributes, IECoreScenePreview::Renderer *renderer )
 {
+	if( const EncapsulatedInstances *instances = runTimeCast<const EncapsulatedInstances>( object ) )
+	{
+		return new EncapsulatedInstancesInterface( name, instances, attributes, renderer );
+	}
+	return renderer->object( name, object, attributes );
+}
+
+void outputObjects( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer, AttributesCache *attributesCache )
+{
+	AttributesCachePtr localAttributesCache = attributesCache ? attributesCache : new AttributesCache( renderer );
 	ConstPathMatcherDataPtr cameraSet = scene->set( "__cameras" );
 	ConstPathMatcherDataPtr lightSet = scene->set( "__lights" );
-	ObjectOutput output( renderer, globals, cameraSet->readable(), lightSet->readable() );
-	parallelProcessLocations( scene, output );
+	PrototypeCachePtr prototypeCache = new PrototypeCache( renderer );
+	const IECore::MurmurHash nullObjectHash = scene->objectPlug()->defaultValue()->hash();
+
+	ObjectGatherer gatherer( renderer, globals, localAttributesCache.get(), cameraSet->readable(), lightSet->readable(), nullObjectHash );
+	ObjectUseCounter useCounter( gatherer, prototypeCache.get() );
+	parallelProcessLocations( scene, useCounter );
+
+	// Bounding the number of objects in flight bounds the memory
+	// used by objects which have not yet been passed to the renderer.
+	// Note that this does not prevent TBB from stealing other pipeline
+	// tasks while a thread waits on a nested parallel compute, which is
+	// why PrototypeCache::get() must never hold a lock while computing
+	// a prototype.
+	const size_t maxObjectsInFlight = g_maxObjectsInFlight;
+	tbb::parallel_pipeline(
+		maxObjectsInFlight,
+		tbb::make_filter<void, ObjectLocationPtr>(
+			tbb::filter::serial_in_order,
+			ObjectLocationGenerator( scene, Gaffer::Context::current(), gatherer, maxObjectsInFlight )
+		) &
+		tbb::make_filter<ObjectLocationPtr, void>(
+			tbb::filter::parallel,
+			ObjectOutput( scene, Gaffer::Context::current(), renderer, prototypeCache.get(), GafferScene::shutter( globals ) )
+		)
+	);
+}
+
+void setMaxObjectsInFlight( size_t maxObjectsInFlight )
+{
+	g_maxObjectsInFlight = std::max( maxObjectsInFlight, (size_t)1 );
+}
+
+size_t getMaxObjectsInFlight()
+{
+	return g_maxObjectsInFlight;
 }
 
 } // namespace Preview
@@ -39,6 +39,7 @@
 #include "Gaffer/StringPlug.h"
 
 #include "GafferScene/PrimitiveVariableProcessor.h"
+#include "GafferScene/Private/IECoreScenePreview/PrimitiveAlgo.h"
 
 using namespace IECore;
 using namespace Gaffer;
@@ -129,7 +130,9 @@ IECore::ConstObjectPtr PrimitiveVariableProcessor::computeProcessedObject( const
 	const std::string names = namesPlug()->getValue();
 
 	bool invert = invertNamesPlug()->getValue();
-	IECore::PrimitivePtr result = inputGeometry->copy();
+	// Share the input data rather than holding copies of it.
+	IECore::PrimitivePtr result = IECoreScenePreview::PrimitiveAlgo::copyTopology( inputGeometry.get() );
+	result->variables = inputGeometry->variables;
 	IECore::PrimitiveVariableMap::iterator next;
 	for( IECore::PrimitiveVariableMap::iterator it = result->variables.begin(); it != result->variables.end(); it = next )
 	{
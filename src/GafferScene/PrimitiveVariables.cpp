@@ -37,6 +37,7 @@
 #include "IECore/Primitive.h"
 
 #include "GafferScene/PrimitiveVariables.h"
+#include "GafferScene/Private/IECoreScenePreview/PrimitiveAlgo.h"
 
 using namespace IECore;
 using namespace Gaffer;
@@ -106,7 +107,9 @@ IECore::ConstObjectPtr PrimitiveVariables::computeProcessedObject( const ScenePa
 		return inputObject;
 	}
 
-	PrimitivePtr result = inputPrimitive->copy();
+	// Share the input data rather than holding copies of it.
+	PrimitivePtr result = IECoreScenePreview::PrimitiveAlgo::copyTopology( inputPrimitive );
+	result->variables = inputPrimitive->variables;
 
 	std::string name;
 	for( CompoundDataPlug::MemberPlugIterator it( p ); !it.done(); ++it )
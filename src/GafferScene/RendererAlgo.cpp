@@ -471,20 +471,24 @@ void transformSamples( const ScenePlug *scene, size_t segments, const Imath::V2f
 
 	motionTimes( segments, shutter, sampleTimes );
 
-	ContextPtr timeContext = new Context( *Context::current(), Context::Borrowed );
-	Context::Scope scopedTimeContext( timeContext.get() );
+	const vector<float> times( sampleTimes.begin(), sampleTimes.end() );
+	const ScenePlug::ScenePath &path = Context::current()->get<ScenePlug::ScenePath>( ScenePlug::scenePathContextName );
+	bool moving = sampleTransform( scene, path, times, samples );
 
-	bool moving = false;
-	samples.reserve( sampleTimes.size() );
-	for( std::set<float>::const_iterator it = sampleTimes.begin(), eIt = sampleTimes.end(); it != eIt; ++it )
+	if( moving )
 	{
-		timeContext->setFrame( *it );
-		const M44f m = scene->transformPlug()->getValue();
-		if( !moving && !samples.empty() && m != samples.front() )
+		// Differing hashes don't guarantee differing values, so
+		// check the matrices themselves before committing to
+		// outputting motion.
+		moving = false;
+		for( vector<M44f>::const_iterator it = samples.begin() + 1, eIt = samples.end(); it != eIt; ++it )
 		{
-			moving = true;
+			if( *it != samples.front() )
+			{
+				moving = true;
+				break;
+			}
 		}
-		samples.push_back( m );
 	}
 
 	if( !moving )
@@ -526,31 +530,20 @@ void objectSamples( const ScenePlug *scene, size_t segments, const Imath::V2f &s
 
 	motionTimes( segments, shutter, sampleTimes );
 
-	ContextPtr timeContext = new Context( *Context::current(), Context::Borrowed );
-	Context::Scope scopedTimeContext( timeContext.get() );
+	const vector<float> times( sampleTimes.begin(), sampleTimes.end() );
+	const ScenePlug::ScenePath &path = Context::current()->get<ScenePlug::ScenePath>( ScenePlug::scenePathContextName );
+	vector<ConstObjectPtr> objects;
+	const bool moving = sampleObject( scene, path, times, objects );
 
-	bool moving = false;
-	MurmurHash lastHash;
-	samples.reserve( sampleTimes.size() );
-	for( std::set<float>::const_iterator it = sampleTimes.begin(), eIt = sampleTimes.end(); it != eIt; ++it )
+	samples.reserve( objects.size() );
+	for( vector<ConstObjectPtr>::const_iterator it = objects.begin(), eIt = objects.end(); it != eIt; ++it )
 	{
-		timeContext->setFrame( *it );
-
-		const MurmurHash objectHash = scene->objectPlug()->hash();
-		ConstObjectPtr object = scene->objectPlug()->getValue( &objectHash );
-
-		if( const Primitive *primitive = runTimeCast<const Primitive>( object.get() ) )
+		if( const Primitive *primitive = runTimeCast<const Primitive>( it->get() ) )
 		{
-			// We can support multiple samples for these, so check to see
-			// if we actually have something moving.
-			if( !moving && !samples.empty() && objectHash != lastHash )
-			{
-				moving = true;
-			}
+			// We can support multiple samples for these.
 			samples.push_back( primitive );
-			lastHash = objectHash;
 		}
-		else if( const VisibleRenderable *renderable = runTimeCast< const VisibleRenderable >( object.get() ) )
+		else if( const VisibleRenderable *renderable = runTimeCast< const VisibleRenderable >( it->get() ) )
 		{
 			// We can't motion blur these chappies, so just take the one
 			// sample.
@@ -565,13 +558,37 @@ void objectSamples( const ScenePlug *scene, size_t segments, const Imath::V2f &s
 		}
 	}
 
-	if( !moving )
+	if( !moving || samples.size() < objects.size() )
 	{
 		samples.resize( std::min<size_t>( samples.size(), 1 ) );
 		sampleTimes.clear();
 	}
 }
 
+IECore::MurmurHash objectSamplesHash( const ScenePlug *scene, size_t segments, const Imath::V2f &shutter )
+{
+	if( !segments )
+	{
+		return scene->objectPlug()->hash();
+	}
+
+	std::set<float> sampleTimes;
+	motionTimes( segments, shutter, sampleTimes );
+
+	ContextPtr timeContext = new Context( *Context::current(), Context::Borrowed );
+	Context::Scope scopedTimeContext( timeContext.get() );
+
+	MurmurHash result;
+	for( std::set<float>::const_iterator it = sampleTimes.begin(), eIt = sampleTimes.end(); it != eIt; ++it )
+	{
+		timeContext->setFrame( *it );
+		scene->objectPlug()->hash( result );
+		result.append( *it );
+	}
+
+	return result;
+}
+
 void outputObject( const ScenePlug *scene, IECore::Renderer *renderer, size_t segments, const Imath::V2f &shutter )
 {
 	vector<ConstVisibleRenderablePtr> samples;
@@ -34,9 +34,13 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <set>
+
 #include "tbb/spin_mutex.h"
 #include "tbb/task.h"
 #include "tbb/parallel_for.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/concurrent_hash_map.h"
 
 #include "boost/algorithm/string/predicate.hpp"
 
@@ -46,6 +50,7 @@
 #include "IECore/ClippingPlane.h"
 #include "IECore/NullObject.h"
 #include "IECore/VisibleRenderable.h"
+#include "IECore/Primitive.h"
 
 #include "Gaffer/Context.h"
 
@@ -186,35 +191,257 @@ Imath::V2f GafferScene::shutter( const IECore::CompoundObject *globals )
 	return shutter;
 }
 
+namespace
+{
+
+InternedString g_transformBlurAttributeName( "gaffer:transformBlur" );
+InternedString g_transformBlurSegmentsAttributeName( "gaffer:transformBlurSegments" );
+
+} // namespace
+
 IECore::TransformPtr GafferScene::transform( const ScenePlug *scene, const ScenePlug::ScenePath &path, const Imath::V2f &shutter, bool motionBlur )
 {
 	int numSamples = 1;
 	if( motionBlur )
 	{
-		ConstCompoundObjectPtr attributes = scene->fullAttributes( path );
-		const IntData *transformBlurSegmentsData = attributes->member<IntData>( "gaffer:transformBlurSegments" );
-		numSamples = transformBlurSegmentsData ? transformBlurSegmentsData->readable() + 1 : 2;
+		// Walk up the hierarchy looking for the blur attributes, stopping as
+		// soon as we've found both. This avoids the cost of computing the full
+		// attributes, which are mostly of no interest to us.
+		ConstIntDataPtr transformBlurSegmentsData;
+		ConstBoolDataPtr transformBlurData;
+
+		ScenePlug::ScenePath p( path );
+		while( p.size() && !( transformBlurSegmentsData && transformBlurData ) )
+		{
+			ConstCompoundObjectPtr attributes = scene->attributes( p );
+			if( !transformBlurSegmentsData )
+			{
+				transformBlurSegmentsData = attributes->member<IntData>( g_transformBlurSegmentsAttributeName );
+			}
+			if( !transformBlurData )
+			{
+				transformBlurData = attributes->member<BoolData>( g_transformBlurAttributeName );
+			}
+			p.pop_back();
+		}
 
-		const BoolData *transformBlurData = attributes->member<BoolData>( "gaffer:transformBlur" );
+		numSamples = transformBlurSegmentsData ? transformBlurSegmentsData->readable() + 1 : 2;
 		if( transformBlurData && !transformBlurData->readable() )
 		{
 			numSamples = 1;
 		}
 	}
 
+	vector<float> sampleTimes;
+	sampleTimes.reserve( numSamples );
+	for( int i = 0; i < numSamples; i++ )
+	{
+		sampleTimes.push_back( lerp( shutter[0], shutter[1], (float)i / std::max( 1, numSamples - 1 ) ) );
+	}
+
+	vector<M44f> samples;
+	sampleFullTransform( scene, path, sampleTimes, samples );
+
 	MatrixMotionTransformPtr result = new MatrixMotionTransform();
-	ContextPtr transformContext = new Context( *Context::current(), Context::Borrowed );
-	Context::Scope scopedContext( transformContext.get() );
 	for( int i = 0; i < numSamples; i++ )
 	{
-		float frame = lerp( shutter[0], shutter[1], (float)i / std::max( 1, numSamples - 1 ) );
-		transformContext->setFrame( frame );
-		result->snapshots()[frame] = scene->fullTransform( path );
+		result->snapshots()[sampleTimes[i]] = samples[i];
 	}
 
 	return result;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Motion sampling
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Samplers provide the hash and value computations for
+// sample(). They are called with the location and time
+// already set in the current context.
+
+struct TransformSampler
+{
+
+	typedef M44f ValueType;
+
+	static MurmurHash hash( const ScenePlug *scene, const ScenePlug::ScenePath &path )
+	{
+		return scene->transformPlug()->hash();
+	}
+
+	static ValueType value( const ScenePlug *scene, const ScenePlug::ScenePath &path, const MurmurHash &hash )
+	{
+		return scene->transformPlug()->getValue( &hash );
+	}
+
+};
+
+struct FullTransformSampler
+{
+
+	typedef M44f ValueType;
+
+	static MurmurHash hash( const ScenePlug *scene, const ScenePlug::ScenePath &path )
+	{
+		return scene->fullTransformHash( path );
+	}
+
+	static ValueType value( const ScenePlug *scene, const ScenePlug::ScenePath &path, const MurmurHash &hash )
+	{
+		return scene->fullTransform( path );
+	}
+
+};
+
+struct ObjectSampler
+{
+
+	typedef ConstObjectPtr ValueType;
+
+	static MurmurHash hash( const ScenePlug *scene, const ScenePlug::ScenePath &path )
+	{
+		return scene->objectPlug()->hash();
+	}
+
+	static ValueType value( const ScenePlug *scene, const ScenePlug::ScenePath &path, const MurmurHash &hash )
+	{
+		return scene->objectPlug()->getValue( &hash );
+	}
+
+};
+
+// Computes either hashes or values for a subset of the samples,
+// using one context per range to avoid allocating a context per
+// sample.
+template<typename Sampler>
+struct SampleTask
+{
+
+	SampleTask( const Context *context, const ScenePlug *scene, const ScenePlug::ScenePath &path, const vector<float> &sampleTimes, const vector<size_t> &indices, vector<MurmurHash> &hashes, vector<typename Sampler::ValueType> *values )
+		:	m_context( context ), m_scene( scene ), m_path( path ), m_sampleTimes( sampleTimes ), m_indices( indices ), m_hashes( hashes ), m_values( values )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		ContextPtr sampleContext = new Context( *m_context, Context::Borrowed );
+		sampleContext->set( ScenePlug::scenePathContextName, m_path );
+		Context::Scope scopedContext( sampleContext.get() );
+
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			const size_t sampleIndex = m_indices[i];
+			sampleContext->setFrame( m_sampleTimes[sampleIndex] );
+			if( m_values )
+			{
+				(*m_values)[sampleIndex] = Sampler::value( m_scene, m_path, m_hashes[sampleIndex] );
+			}
+			else
+			{
+				m_hashes[sampleIndex] = Sampler::hash( m_scene, m_path );
+			}
+		}
+	}
+
+	private :
+
+		const Context *m_context;
+		const ScenePlug *m_scene;
+		const ScenePlug::ScenePath &m_path;
+		const vector<float> &m_sampleTimes;
+		const vector<size_t> &m_indices;
+		vector<MurmurHash> &m_hashes;
+		vector<typename Sampler::ValueType> *m_values;
+
+};
+
+template<typename Sampler>
+bool sample( const ScenePlug *scene, const ScenePlug::ScenePath &path, const vector<float> &sampleTimes, vector<typename Sampler::ValueType> &samples )
+{
+	const size_t numSamples = sampleTimes.size();
+	samples.resize( numSamples );
+	if( !numSamples )
+	{
+		return false;
+	}
+
+	// Hash all the samples in parallel.
+
+	const Context *context = Context::current();
+	vector<size_t> allIndices( numSamples );
+	for( size_t i = 0; i < numSamples; ++i )
+	{
+		allIndices[i] = i;
+	}
+
+	vector<MurmurHash> hashes( numSamples );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numSamples ),
+		SampleTask<Sampler>( context, scene, path, sampleTimes, allIndices, hashes, NULL )
+	);
+
+	// Find the samples with unique hashes, and map every
+	// other sample onto the unique one it duplicates. The
+	// number of samples is small, so a linear search is fine.
+
+	vector<size_t> uniqueIndices;
+	vector<size_t> sources( numSamples );
+	for( size_t i = 0; i < numSamples; ++i )
+	{
+		sources[i] = i;
+		for( vector<size_t>::const_iterator it = uniqueIndices.begin(), eIt = uniqueIndices.end(); it != eIt; ++it )
+		{
+			if( hashes[*it] == hashes[i] )
+			{
+				sources[i] = *it;
+				break;
+			}
+		}
+		if( sources[i] == i )
+		{
+			uniqueIndices.push_back( i );
+		}
+	}
+
+	// Compute values for the unique samples in parallel,
+	// and copy them into the duplicates.
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, uniqueIndices.size() ),
+		SampleTask<Sampler>( context, scene, path, sampleTimes, uniqueIndices, hashes, &samples )
+	);
+
+	for( size_t i = 0; i < numSamples; ++i )
+	{
+		if( sources[i] != i )
+		{
+			samples[i] = samples[sources[i]];
+		}
+	}
+
+	return uniqueIndices.size() > 1;
+}
+
+} // namespace
+
+bool GafferScene::sampleTransform( const ScenePlug *scene, const ScenePlug::ScenePath &path, const std::vector<float> &sampleTimes, std::vector<Imath::M44f> &samples )
+{
+	return sample<TransformSampler>( scene, path, sampleTimes, samples );
+}
+
+bool GafferScene::sampleFullTransform( const ScenePlug *scene, const ScenePlug::ScenePath &path, const std::vector<float> &sampleTimes, std::vector<Imath::M44f> &samples )
+{
+	return sample<FullTransformSampler>( scene, path, sampleTimes, samples );
+}
+
+bool GafferScene::sampleObject( const ScenePlug *scene, const ScenePlug::ScenePath &path, const std::vector<float> &sampleTimes, std::vector<IECore::ConstObjectPtr> &samples )
+{
+	return sample<ObjectSampler>( scene, path, sampleTimes, samples );
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Camera algo
 //////////////////////////////////////////////////////////////////////////
@@ -484,6 +711,494 @@ IECore::ConstCompoundDataPtr GafferScene::sets( const ScenePlug *scene )
 	return result;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Statistics
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct ObjectTypeStats
+{
+
+	ObjectTypeStats()
+		:	count( 0 ), primitives( 0 ), vertices( 0 ), memory( 0 )
+	{
+	}
+
+	uint64_t count;
+	uint64_t primitives;
+	uint64_t vertices;
+	uint64_t memory;
+
+};
+
+typedef std::map<std::string, ObjectTypeStats> ObjectStatsMap;
+
+struct LocationStats
+{
+
+	LocationStats()
+		:	locations( 0 ), maxDepth( 0 )
+	{
+	}
+
+	uint64_t locations;
+	size_t maxDepth;
+	ObjectStatsMap objects;
+
+};
+
+typedef tbb::enumerable_thread_specific<LocationStats> ThreadLocationStats;
+
+struct MurmurHashCompare
+{
+
+	static size_t hash( const MurmurHash &h )
+	{
+		return hash_value( h );
+	}
+
+	static bool equal( const MurmurHash &h1, const MurmurHash &h2 )
+	{
+		return h1 == h2;
+	}
+
+};
+
+// Used to make sure we only count the memory for
+// each unique object once.
+typedef tbb::concurrent_hash_map<MurmurHash, bool, MurmurHashCompare> ObjectHashes;
+
+// Functor for use with parallelProcessLocations(). Results
+// are accumulated per thread, so that no locking is needed
+// other than for the unique object hashes.
+struct LocationStatsFunctor
+{
+
+	LocationStatsFunctor( ThreadLocationStats &stats, ObjectHashes &objectHashes )
+		:	m_stats( stats ), m_objectHashes( objectHashes )
+	{
+	}
+
+	bool operator()( const ScenePlug *scene, const ScenePlug::ScenePath &path )
+	{
+		LocationStats &stats = m_stats.local();
+		stats.locations++;
+		stats.maxDepth = std::max( stats.maxDepth, path.size() );
+
+		const MurmurHash objectHash = scene->objectPlug()->hash();
+		ConstObjectPtr object = scene->objectPlug()->getValue( &objectHash );
+		if( runTimeCast<const NullObject>( object.get() ) )
+		{
+			return true;
+		}
+
+		ObjectTypeStats &objectStats = stats.objects[object->typeName()];
+		objectStats.count++;
+		if( const Primitive *primitive = runTimeCast<const Primitive>( object.get() ) )
+		{
+			objectStats.primitives += primitive->variableSize( PrimitiveVariable::Uniform );
+			objectStats.vertices += primitive->variableSize( PrimitiveVariable::Vertex );
+		}
+
+		if( m_objectHashes.insert( ObjectHashes::value_type( objectHash, true ) ) )
+		{
+			objectStats.memory += object->memoryUsage();
+		}
+
+		return true;
+	}
+
+	private :
+
+		ThreadLocationStats &m_stats;
+		ObjectHashes &m_objectHashes;
+
+};
+
+struct SetSizes
+{
+
+	SetSizes( const std::vector<InternedString> &names, const CompoundData *sets, std::vector<uint64_t> &sizes )
+		:	m_names( names ), m_sets( sets ), m_sizes( sizes )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		for( size_t i=r.begin(); i!=r.end(); ++i )
+		{
+			const PathMatcher &set = m_sets->member<PathMatcherData>( m_names[i] )->readable();
+			uint64_t size = 0;
+			for( PathMatcher::RawIterator it = set.begin(), eIt = set.end(); it != eIt; ++it )
+			{
+				if( it.exactMatch() )
+				{
+					size++;
+				}
+			}
+			m_sizes[i] = size;
+		}
+	}
+
+	private :
+
+		const std::vector<InternedString> &m_names;
+		const CompoundData *m_sets;
+		std::vector<uint64_t> &m_sizes;
+
+};
+
+} // namespace
+
+IECore::CompoundDataPtr GafferScene::sceneStats( const ScenePlug *scene )
+{
+	// Location and object statistics
+
+	ThreadLocationStats threadStats;
+	ObjectHashes objectHashes;
+	LocationStatsFunctor functor( threadStats, objectHashes );
+	parallelProcessLocations( scene, functor );
+
+	LocationStats locationStats;
+	for( ThreadLocationStats::const_iterator it = threadStats.begin(), eIt = threadStats.end(); it != eIt; ++it )
+	{
+		locationStats.locations += it->locations;
+		locationStats.maxDepth = std::max( locationStats.maxDepth, it->maxDepth );
+		for( ObjectStatsMap::const_iterator oIt = it->objects.begin(), oEIt = it->objects.end(); oIt != oEIt; ++oIt )
+		{
+			ObjectTypeStats &objectStats = locationStats.objects[oIt->first];
+			objectStats.count += oIt->second.count;
+			objectStats.primitives += oIt->second.primitives;
+			objectStats.vertices += oIt->second.vertices;
+			objectStats.memory += oIt->second.memory;
+		}
+	}
+
+	CompoundDataPtr result = new CompoundData;
+	result->writable()["locations"] = new UInt64Data( locationStats.locations );
+	result->writable()["maxDepth"] = new IntData( locationStats.maxDepth );
+
+	CompoundDataPtr objectsData = new CompoundData;
+	for( ObjectStatsMap::const_iterator it = locationStats.objects.begin(), eIt = locationStats.objects.end(); it != eIt; ++it )
+	{
+		CompoundDataPtr objectData = new CompoundData;
+		objectData->writable()["count"] = new UInt64Data( it->second.count );
+		objectData->writable()["primitives"] = new UInt64Data( it->second.primitives );
+		objectData->writable()["vertices"] = new UInt64Data( it->second.vertices );
+		objectData->writable()["memory"] = new UInt64Data( it->second.memory );
+		objectsData->writable()[it->first] = objectData;
+	}
+	result->writable()["objects"] = objectsData;
+
+	// Set statistics
+
+	ConstCompoundDataPtr setsData = sets( scene );
+	std::vector<InternedString> setNames;
+	for( CompoundDataMap::const_iterator it = setsData->readable().begin(), eIt = setsData->readable().end(); it != eIt; ++it )
+	{
+		setNames.push_back( it->first );
+	}
+
+	std::vector<uint64_t> setSizes( setNames.size() );
+	parallel_for( tbb::blocked_range<size_t>( 0, setNames.size() ), SetSizes( setNames, setsData.get(), setSizes ) );
+
+	CompoundDataPtr setSizesData = new CompoundData;
+	for( size_t i = 0; i < setNames.size(); ++i )
+	{
+		setSizesData->writable()[setNames[i]] = new UInt64Data( setSizes[i] );
+	}
+	result->writable()["sets"] = setSizesData;
+
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Diffing
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct DiffResults
+{
+
+	PathMatcher added;
+	PathMatcher removed;
+	PathMatcher bound;
+	PathMatcher transform;
+	PathMatcher attributes;
+	PathMatcher object;
+
+};
+
+typedef tbb::enumerable_thread_specific<DiffResults> ThreadDiffResults;
+
+template<typename T>
+bool valuesEqual( const T &v1, const T &v2 )
+{
+	return v1 == v2;
+}
+
+template<typename T>
+bool valuesEqual( const boost::intrusive_ptr<T> &v1, const boost::intrusive_ptr<T> &v2 )
+{
+	return v1->isEqualTo( v2.get() );
+}
+
+template<typename PlugType, typename ValueType>
+bool differsFrom( const ValueType &value1, const PlugType *plug2, const Context *context2, const MurmurHash &hash2 )
+{
+	Context::Scope scopedContext( context2 );
+	return !valuesEqual( value1, plug2->getValue( &hash2 ) );
+}
+
+// Returns true if the values for the plugs differ in their respective contexts,
+// only fetching the values if the hashes are not enough to tell.
+template<typename PlugType>
+bool differs( const PlugType *plug1, const Context *context1, const PlugType *plug2, const Context *context2 )
+{
+	MurmurHash hash1, hash2;
+	{
+		Context::Scope scopedContext( context1 );
+		hash1 = plug1->hash();
+	}
+	{
+		Context::Scope scopedContext( context2 );
+		hash2 = plug2->hash();
+	}
+	if( hash1 == hash2 )
+	{
+		return false;
+	}
+
+	Context::Scope scopedContext( context1 );
+	return differsFrom( plug1->getValue( &hash1 ), plug2, context2, hash2 );
+}
+
+MurmurHash hierarchyHash( const ScenePlug *scene, const Context *context, const ScenePlug::ScenePath &path )
+{
+	Context::Scope scopedContext( context );
+	return scene->hierarchyHash( path );
+}
+
+void diffWalk( const ScenePlug *scene1, const Context *context1, const ScenePlug *scene2, const Context *context2, const ScenePlug::ScenePath &path, ThreadDiffResults &results );
+
+struct DiffChildren
+{
+
+	DiffChildren( const ScenePlug *scene1, const Context *context1, const ScenePlug *scene2, const Context *context2, const ScenePlug::ScenePath &parentPath, const vector<InternedString> &childNames, ThreadDiffResults &results )
+		:	m_scene1( scene1 ), m_context1( context1 ), m_scene2( scene2 ), m_context2( context2 ), m_parentPath( parentPath ), m_childNames( childNames ), m_results( results )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		ScenePlug::ScenePath childPath( m_parentPath );
+		childPath.push_back( InternedString() ); // space for the child name
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			childPath.back() = m_childNames[i];
+			diffWalk( m_scene1, m_context1, m_scene2, m_context2, childPath, m_results );
+		}
+	}
+
+	private :
+
+		const ScenePlug *m_scene1;
+		const Context *m_context1;
+		const ScenePlug *m_scene2;
+		const Context *m_context2;
+		const ScenePlug::ScenePath &m_parentPath;
+		const vector<InternedString> &m_childNames;
+		ThreadDiffResults &m_results;
+
+};
+
+void diffWalk( const ScenePlug *scene1, const Context *context1, const ScenePlug *scene2, const Context *context2, const ScenePlug::ScenePath &path, ThreadDiffResults &results )
+{
+	if( hierarchyHash( scene1, context1, path ) == hierarchyHash( scene2, context2, path ) )
+	{
+		return;
+	}
+
+	ContextPtr locationContext1 = new Context( *context1, Context::Borrowed );
+	locationContext1->set( ScenePlug::scenePathContextName, path );
+	ContextPtr locationContext2 = new Context( *context2, Context::Borrowed );
+	locationContext2->set( ScenePlug::scenePathContextName, path );
+
+	DiffResults &threadResults = results.local();
+	if( differs( scene1->boundPlug(), locationContext1.get(), scene2->boundPlug(), locationContext2.get() ) )
+	{
+		threadResults.bound.addPath( path );
+	}
+	if( differs( scene1->transformPlug(), locationContext1.get(), scene2->transformPlug(), locationContext2.get() ) )
+	{
+		threadResults.transform.addPath( path );
+	}
+	if( differs( scene1->attributesPlug(), locationContext1.get(), scene2->attributesPlug(), locationContext2.get() ) )
+	{
+		threadResults.attributes.addPath( path );
+	}
+	if( differs( scene1->objectPlug(), locationContext1.get(), scene2->objectPlug(), locationContext2.get() ) )
+	{
+		threadResults.object.addPath( path );
+	}
+
+	MurmurHash childNamesHash1;
+	ConstInternedStringVectorDataPtr childNamesData1;
+	{
+		Context::Scope scopedContext( locationContext1.get() );
+		childNamesHash1 = scene1->childNamesPlug()->hash();
+		childNamesData1 = scene1->childNamesPlug()->getValue( &childNamesHash1 );
+	}
+
+	MurmurHash childNamesHash2;
+	{
+		Context::Scope scopedContext( locationContext2.get() );
+		childNamesHash2 = scene2->childNamesPlug()->hash();
+	}
+
+	vector<InternedString> commonChildNames;
+	const vector<InternedString> *childNames = &childNamesData1->readable();
+	if( childNamesHash1 != childNamesHash2 )
+	{
+		ConstInternedStringVectorDataPtr childNamesData2;
+		{
+			Context::Scope scopedContext( locationContext2.get() );
+			childNamesData2 = scene2->childNamesPlug()->getValue( &childNamesHash2 );
+		}
+		const vector<InternedString> &childNames1 = childNamesData1->readable();
+		const vector<InternedString> &childNames2 = childNamesData2->readable();
+		if( childNames1 != childNames2 )
+		{
+			const std::set<InternedString> childNamesSet1( childNames1.begin(), childNames1.end() );
+			const std::set<InternedString> childNamesSet2( childNames2.begin(), childNames2.end() );
+
+			ScenePlug::ScenePath childPath( path );
+			childPath.push_back( InternedString() ); // space for the child name
+			for( vector<InternedString>::const_iterator it = childNames1.begin(), eIt = childNames1.end(); it != eIt; ++it )
+			{
+				if( childNamesSet2.find( *it ) != childNamesSet2.end() )
+				{
+					commonChildNames.push_back( *it );
+				}
+				else
+				{
+					childPath.back() = *it;
+					threadResults.removed.addPath( childPath );
+				}
+			}
+			for( vector<InternedString>::const_iterator it = childNames2.begin(), eIt = childNames2.end(); it != eIt; ++it )
+			{
+				if( childNamesSet1.find( *it ) == childNamesSet1.end() )
+				{
+					childPath.back() = *it;
+					threadResults.added.addPath( childPath );
+				}
+			}
+			childNames = &commonChildNames;
+		}
+	}
+
+	DiffChildren diffChildren( scene1, context1, scene2, context2, path, *childNames, results );
+	parallel_for( tbb::blocked_range<size_t>( 0, childNames->size() ), diffChildren );
+}
+
+} // namespace
+
+IECore::CompoundDataPtr GafferScene::sceneDiff( const ScenePlug *scene1, const ScenePlug *scene2 )
+{
+	const Context *context = Context::current();
+	return sceneDiff( scene1, context, scene2, context );
+}
+
+IECore::CompoundDataPtr GafferScene::sceneDiff( const ScenePlug *scene1, const Gaffer::Context *context1, const ScenePlug *scene2, const Gaffer::Context *context2 )
+{
+	// Locations
+
+	ThreadDiffResults threadResults;
+	diffWalk( scene1, context1, scene2, context2, ScenePlug::ScenePath(), threadResults );
+
+	DiffResults diffResults;
+	for( ThreadDiffResults::const_iterator it = threadResults.begin(), eIt = threadResults.end(); it != eIt; ++it )
+	{
+		diffResults.added.addPaths( it->added );
+		diffResults.removed.addPaths( it->removed );
+		diffResults.bound.addPaths( it->bound );
+		diffResults.transform.addPaths( it->transform );
+		diffResults.attributes.addPaths( it->attributes );
+		diffResults.object.addPaths( it->object );
+	}
+
+	CompoundDataPtr result = new CompoundData;
+	result->writable()["added"] = new PathMatcherData( diffResults.added );
+	result->writable()["removed"] = new PathMatcherData( diffResults.removed );
+
+	CompoundDataPtr changedData = new CompoundData;
+	changedData->writable()["bound"] = new PathMatcherData( diffResults.bound );
+	changedData->writable()["transform"] = new PathMatcherData( diffResults.transform );
+	changedData->writable()["attributes"] = new PathMatcherData( diffResults.attributes );
+	changedData->writable()["object"] = new PathMatcherData( diffResults.object );
+	result->writable()["changed"] = changedData;
+
+	// Globals
+
+	// The convenience accessors remove the per-location variables for us,
+	// so all we need to do is scope the appropriate context for each scene.
+	Context::Scope scopedContext1( context1 );
+	const MurmurHash globalsHash1 = scene1->globalsHash();
+	ConstCompoundObjectPtr globals1 = scene1->globals();
+	ConstInternedStringVectorDataPtr setNamesData1 = scene1->setNames();
+
+	Context::Scope scopedContext2( context2 );
+	bool globalsDiffer = false;
+	if( globalsHash1 != scene2->globalsHash() )
+	{
+		globalsDiffer = !globals1->isEqualTo( scene2->globals().get() );
+	}
+	result->writable()["globals"] = new BoolData( globalsDiffer );
+
+	// Sets
+
+	ConstInternedStringVectorDataPtr setNamesData2 = scene2->setNames();
+	const vector<InternedString> &setNames1 = setNamesData1->readable();
+	const vector<InternedString> &setNames2 = setNamesData2->readable();
+
+	InternedStringVectorDataPtr setsData = new InternedStringVectorData;
+	for( vector<InternedString>::const_iterator it = setNames1.begin(), eIt = setNames1.end(); it != eIt; ++it )
+	{
+		if( std::find( setNames2.begin(), setNames2.end(), *it ) == setNames2.end() )
+		{
+			setsData->writable().push_back( *it );
+			continue;
+		}
+
+		MurmurHash setHash1;
+		ConstPathMatcherDataPtr set1;
+		{
+			Context::Scope scopedSetContext1( context1 );
+			setHash1 = scene1->setHash( *it );
+			set1 = scene1->set( *it );
+		}
+		if( setHash1 != scene2->setHash( *it ) && !set1->isEqualTo( scene2->set( *it ).get() ) )
+		{
+			setsData->writable().push_back( *it );
+		}
+	}
+	for( vector<InternedString>::const_iterator it = setNames2.begin(), eIt = setNames2.end(); it != eIt; ++it )
+	{
+		if( std::find( setNames1.begin(), setNames1.end(), *it ) == setNames1.end() )
+		{
+			setsData->writable().push_back( *it );
+		}
+	}
+	result->writable()["sets"] = setsData;
+
+	return result;
+}
+
 Imath::Box3f GafferScene::bound( const IECore::Object *object )
 {
 	if( const IECore::VisibleRenderable *renderable = IECore::runTimeCast<const IECore::VisibleRenderable>( object ) )
@@ -35,10 +35,14 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/atomic.h"
+#include "tbb/parallel_for.h"
+
 #include "IECore/NullObject.h"
 
 #include "Gaffer/Context.h"
 #include "Gaffer/StringAlgo.h"
+#include "Gaffer/Private/IECorePreview/LRUCache.h"
 
 #include "GafferScene/ScenePlug.h"
 #include "GafferScene/PathMatcherData.h"
@@ -66,6 +70,94 @@ void removeNonGlobalContextVariables( Context *context )
 	context->remove( ScenePlug::scenePathContextName );
 }
 
+// Hierarchy hash cache. Keys combine the context hash for a location
+// with the generation of the ScenePlug, so entries are implicitly
+// invalidated when the plug is dirtied. Entries for dead generations
+// are never looked up again, and simply age out of the cache. We don't
+// clear the cache explicitly, because that would discard the entries
+// for every other ScenePlug too.
+
+tbb::atomic<uint64_t> g_hierarchyHashGeneration;
+
+IECore::MurmurHash nullGetter( const IECore::MurmurHash &h, size_t &cost )
+{
+	cost = 0;
+	return IECore::MurmurHash();
+}
+
+typedef IECorePreview::LRUCache<IECore::MurmurHash, IECore::MurmurHash> HierarchyHashCache;
+HierarchyHashCache g_hierarchyHashCache( nullGetter, 500000 );
+
+IECore::MurmurHash hierarchyHash( const ScenePlug *scene, const Context *context, const ScenePlug::ScenePath &path, uint64_t generation );
+
+struct HierarchyHashChildren
+{
+
+	HierarchyHashChildren( const ScenePlug *scene, const Context *context, const ScenePlug::ScenePath &parentPath, const std::vector<IECore::InternedString> &childNames, uint64_t generation, std::vector<IECore::MurmurHash> &hashes )
+		:	m_scene( scene ), m_context( context ), m_parentPath( parentPath ), m_childNames( childNames ), m_generation( generation ), m_hashes( hashes )
+	{
+	}
+
+	void operator()( const tbb::blocked_range<size_t> &r ) const
+	{
+		ScenePlug::ScenePath childPath( m_parentPath );
+		childPath.push_back( IECore::InternedString() ); // space for the child name
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			childPath.back() = m_childNames[i];
+			m_hashes[i] = hierarchyHash( m_scene, m_context, childPath, m_generation );
+		}
+	}
+
+	private :
+
+		const ScenePlug *m_scene;
+		const Context *m_context;
+		const ScenePlug::ScenePath &m_parentPath;
+		const std::vector<IECore::InternedString> &m_childNames;
+		const uint64_t m_generation;
+		std::vector<IECore::MurmurHash> &m_hashes;
+
+};
+
+IECore::MurmurHash hierarchyHash( const ScenePlug *scene, const Context *context, const ScenePlug::ScenePath &path, uint64_t generation )
+{
+	ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+	tmpContext->set( ScenePlug::scenePathContextName, path );
+	Context::Scope scopedContext( tmpContext.get() );
+
+	IECore::MurmurHash key = tmpContext->hash();
+	key.append( generation );
+
+	IECore::MurmurHash result = g_hierarchyHashCache.get( key );
+	if( result != IECore::MurmurHash() )
+	{
+		return result;
+	}
+
+	scene->boundPlug()->hash( result );
+	scene->transformPlug()->hash( result );
+	scene->attributesPlug()->hash( result );
+	scene->objectPlug()->hash( result );
+	scene->childNamesPlug()->hash( result );
+
+	IECore::ConstInternedStringVectorDataPtr childNamesData = scene->childNamesPlug()->getValue();
+	const std::vector<IECore::InternedString> &childNames = childNamesData->readable();
+	if( childNames.size() )
+	{
+		std::vector<IECore::MurmurHash> childHashes( childNames.size() );
+		HierarchyHashChildren hashChildren( scene, context, path, childNames, generation, childHashes );
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, childNames.size() ), hashChildren );
+		for( std::vector<IECore::MurmurHash>::const_iterator it = childHashes.begin(), eIt = childHashes.end(); it != eIt; ++it )
+		{
+			result.append( *it );
+		}
+	}
+
+	g_hierarchyHashCache.set( key, result, 1 );
+	return result;
+}
+
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -80,6 +172,8 @@ const IECore::InternedString ScenePlug::setNameContextName( "scene:setName" );
 ScenePlug::ScenePlug( const std::string &name, Direction direction, unsigned flags )
 	:	ValuePlug( name, direction, flags )
 {
+	m_hierarchyHashGeneration = ++g_hierarchyHashGeneration;
+
 	// we don't want the children to be serialised in any way - we always create
 	// them ourselves in this constructor so they aren't Dynamic, and we don't ever
 	// want to store their values because they are meaningless without an input
@@ -454,6 +548,11 @@ IECore::MurmurHash ScenePlug::childNamesHash( const ScenePath &scenePath ) const
 	return childNamesPlug()->hash();
 }
 
+IECore::MurmurHash ScenePlug::hierarchyHash( const ScenePath &scenePath ) const
+{
+	return ::hierarchyHash( this, Context::current(), scenePath, m_hierarchyHashGeneration );
+}
+
 IECore::MurmurHash ScenePlug::globalsHash() const
 {
 	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
@@ -479,6 +578,14 @@ IECore::MurmurHash ScenePlug::setHash( const IECore::InternedString &setName ) c
 	return setPlug()->hash();
 }
 
+void ScenePlug::dirty()
+{
+	ValuePlug::dirty();
+	// Dirtying any child plug also dirties us, so this is
+	// sufficient to invalidate all our hierarchy hashes.
+	m_hierarchyHashGeneration = ++g_hierarchyHashGeneration;
+}
+
 void ScenePlug::stringToPath( const std::string &s, ScenePlug::ScenePath &path )
 {
 	path.clear();
@@ -35,6 +35,10 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/bind.hpp"
+#include "boost/functional/hash.hpp"
+
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
 
 #include "IECore/SharedSceneInterfaces.h"
 #include "IECore/InternedString.h"
@@ -43,6 +47,7 @@
 #include "Gaffer/Context.h"
 #include "Gaffer/StringAlgo.h"
 #include "Gaffer/StringPlug.h"
+#include "Gaffer/Private/IECorePreview/LRUCache.h"
 
 #include "GafferScene/SceneReader.h"
 #include "GafferScene/PathMatcherData.h"
@@ -57,6 +62,88 @@ typedef boost::tokenizer<boost::char_separator<char> > Tokenizer;
 
 IE_CORE_DEFINERUNTIMETYPED( SceneReader );
 
+//////////////////////////////////////////////////////////////////////////
+// Implementation of an LRUCache of SceneInterfaces, keyed by fileName
+// and path.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct SceneCacheKey
+{
+
+	SceneCacheKey( const std::string &fileName, const ScenePlug::ScenePath &path )
+		:	fileName( fileName ), path( path )
+	{
+	}
+
+	bool operator == ( const SceneCacheKey &other ) const
+	{
+		return fileName == other.fileName && path == other.path;
+	}
+
+	std::string fileName;
+	ScenePlug::ScenePath path;
+
+};
+
+size_t hash_value( const SceneCacheKey &key )
+{
+	size_t result = boost::hash<std::string>()( key.fileName );
+	for( ScenePlug::ScenePath::const_iterator it = key.path.begin(), eIt = key.path.end(); it != eIt; ++it )
+	{
+		// InternedStrings are unique, so we can just
+		// hash the address of the string.
+		boost::hash_combine( result, it->c_str() );
+	}
+	return result;
+}
+
+// The cache is populated explicitly by cachedScene(), which resolves each
+// location from the cached handle for its parent. The getter is only
+// used if an entry is evicted between checking for it and retrieving it,
+// in which case we fall back to resolving the full path from the root.
+ConstSceneInterfacePtr sceneCacheGetter( const SceneCacheKey &key, size_t &cost )
+{
+	cost = 1;
+	return SharedSceneInterfaces::get( key.fileName )->scene( key.path );
+}
+
+typedef IECorePreview::LRUCache<SceneCacheKey, ConstSceneInterfacePtr> SceneCache;
+
+SceneCache &sceneCache()
+{
+	// Handles are cheap, so the limit is chosen to comfortably hold
+	// the working set of a parallel traversal of a large scene.
+	static SceneCache *c = new SceneCache( sceneCacheGetter, 10000 );
+	return *c;
+}
+
+ConstSceneInterfacePtr cachedScene( const std::string &fileName, const ScenePlug::ScenePath &path )
+{
+	if( path.empty() )
+	{
+		// SharedSceneInterfaces is already an efficient
+		// cache for the root of each file.
+		return SharedSceneInterfaces::get( fileName );
+	}
+
+	SceneCacheKey key( fileName, path );
+	SceneCache &cache = sceneCache();
+	if( cache.cached( key ) )
+	{
+		return cache.get( key );
+	}
+
+	ScenePlug::ScenePath parentPath( path.begin(), path.end() - 1 );
+	ConstSceneInterfacePtr result = cachedScene( fileName, parentPath )->child( path.back() );
+	cache.set( key, result, 1 );
+	return result;
+}
+
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////
 // SceneReader implementation
 //////////////////////////////////////////////////////////////////////////
@@ -72,6 +159,7 @@ SceneReader::SceneReader( const std::string &name )
 	addChild( new StringPlug( "fileName" ) );
 	addChild( new IntPlug( "refreshCount" ) );
 	addChild( new StringPlug( "tags" ) );
+	addChild( new ObjectPlug( "__sets", Plug::Out, new CompoundData() ) );
 	plugSetSignal().connect( boost::bind( &SceneReader::plugSet, this, ::_1 ) );
 }
 
@@ -109,12 +197,23 @@ const Gaffer::StringPlug *SceneReader::tagsPlug() const
 	return getChild<StringPlug>( g_firstPlugIndex + 2 );
 }
 
+Gaffer::ObjectPlug *SceneReader::setsPlug()
+{
+	return getChild<ObjectPlug>( g_firstPlugIndex + 3 );
+}
+
+const Gaffer::ObjectPlug *SceneReader::setsPlug() const
+{
+	return getChild<ObjectPlug>( g_firstPlugIndex + 3 );
+}
+
 void SceneReader::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	SceneNode::affects( input, outputs );
 
 	if( input == fileNamePlug() || input == refreshCountPlug() )
 	{
+		outputs.push_back( setsPlug() );
 		outputs.push_back( outPlug()->boundPlug() );
 		outputs.push_back( outPlug()->transformPlug() );
 		outputs.push_back( outPlug()->attributesPlug() );
@@ -129,6 +228,32 @@ void SceneReader::affects( const Gaffer::Plug *input, AffectedPlugsContainer &ou
 	{
 		outputs.push_back( outPlug()->childNamesPlug() );
 	}
+	else if( input == setsPlug() )
+	{
+		outputs.push_back( outPlug()->setPlug() );
+	}
+}
+
+void SceneReader::hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	SceneNode::hash( output, context, h );
+
+	if( output == setsPlug() )
+	{
+		fileNamePlug()->hash( h );
+		refreshCountPlug()->hash( h );
+	}
+}
+
+void SceneReader::compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const
+{
+	if( output == setsPlug() )
+	{
+		static_cast<ObjectPlug *>( output )->setValue( loadSets() );
+		return;
+	}
+
+	SceneNode::compute( output, context );
 }
 
 size_t SceneReader::supportedExtensions( std::vector<std::string> &extensions )
@@ -400,44 +525,134 @@ void SceneReader::hashSet( const IECore::InternedString &setName, const Gaffer::
 	h.append( setName );
 }
 
-static void loadSetWalk( const SceneInterface *s, const InternedString &setName, PathMatcher &set, const vector<InternedString> &path )
+//////////////////////////////////////////////////////////////////////////
+// Set loading
+//////////////////////////////////////////////////////////////////////////
+
+namespace
 {
-	if( s->hasTag( setName, SceneInterface::LocalTag ) )
+
+typedef std::map<InternedString, PathMatcher> SetMap;
+typedef tbb::enumerable_thread_specific<SetMap> ThreadLocalSetMaps;
+
+void loadSetsWalk( const SceneInterface *s, const vector<InternedString> &path, ThreadLocalSetMaps &sets );
+
+class LoadSetsChildren
+{
+
+	public :
+
+		LoadSetsChildren( const SceneInterface *s, const vector<InternedString> &path, const SceneInterface::NameList &childNames, ThreadLocalSetMaps &sets )
+			:	m_scene( s ), m_path( path ), m_childNames( childNames ), m_sets( sets )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			vector<InternedString> childPath( m_path );
+			childPath.push_back( InternedString() ); // room for the child name
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				ConstSceneInterfacePtr child = m_scene->child( m_childNames[i] );
+				childPath.back() = m_childNames[i];
+				loadSetsWalk( child.get(), childPath, m_sets );
+			}
+		}
+
+	private :
+
+		const SceneInterface *m_scene;
+		const vector<InternedString> &m_path;
+		const SceneInterface::NameList &m_childNames;
+		ThreadLocalSetMaps &m_sets;
+
+};
+
+void loadSetsWalk( const SceneInterface *s, const vector<InternedString> &path, ThreadLocalSetMaps &sets )
+{
+	SceneInterface::NameList tags;
+	s->readTags( tags, SceneInterface::LocalTag );
+	if( tags.size() )
 	{
-		set.addPath( path );
+		SetMap &localSets = sets.local();
+		for( SceneInterface::NameList::const_iterator it = tags.begin(), eIt = tags.end(); it != eIt; ++it )
+		{
+			localSets[*it].addPath( path );
+		}
 	}
 
-	// Figure out if we need to recurse by querying descendant tags to see if they include
-	// anything we're interested in.
+	// Figure out if we need to recurse by querying descendant tags to see
+	// if there is anything left to find.
 
-	if( !s->hasTag( setName, SceneInterface::DescendantTag ) )
+	tags.clear();
+	s->readTags( tags, SceneInterface::DescendantTag );
+	if( tags.empty() )
 	{
 		return;
 	}
 
-	// Recurse to the children.
+	// Recurse to the children in parallel.
 
 	SceneInterface::NameList childNames;
 	s->childNames( childNames );
-	vector<InternedString> childPath( path );
-	childPath.push_back( InternedString() ); // room for the child name
-	for( SceneInterface::NameList::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; ++it )
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, childNames.size() ),
+		LoadSetsChildren( s, path, childNames, sets )
+	);
+}
+
+} // namespace
+
+IECore::ConstCompoundDataPtr SceneReader::loadSets() const
+{
+	CompoundDataPtr result = new CompoundData;
+
+	ConstSceneInterfacePtr rootScene = scene( ScenePath() );
+	if( !rootScene )
 	{
-		ConstSceneInterfacePtr child = s->child( *it );
-		childPath.back() = *it;
-		loadSetWalk( child.get(), setName, set, childPath );
+		return result;
+	}
+
+	ThreadLocalSetMaps threadLocalSets;
+	loadSetsWalk( rootScene.get(), ScenePath(), threadLocalSets );
+
+	CompoundDataMap &resultSets = result->writable();
+	for( ThreadLocalSetMaps::const_iterator tIt = threadLocalSets.begin(), tEIt = threadLocalSets.end(); tIt != tEIt; ++tIt )
+	{
+		for( SetMap::const_iterator it = tIt->begin(), eIt = tIt->end(); it != eIt; ++it )
+		{
+			DataPtr &set = resultSets[it->first];
+			if( !set )
+			{
+				set = new PathMatcherData( it->second );
+			}
+			else
+			{
+				static_cast<PathMatcherData *>( set.get() )->writable().addPaths( it->second );
+			}
+		}
 	}
+
+	return result;
 }
 
 GafferScene::ConstPathMatcherDataPtr SceneReader::computeSet( const IECore::InternedString &setName, const Gaffer::Context *context, const ScenePlug *parent ) const
 {
-	PathMatcherDataPtr result = new PathMatcherData;
-	ConstSceneInterfacePtr rootScene = scene( ScenePath() );
-	if( rootScene )
+	// Remove the set name from the context, so that all sets share
+	// a single evaluation of setsPlug().
+	ContextPtr setsContext = new Context( *context, Context::Borrowed );
+	setsContext->remove( ScenePlug::setNameContextName );
+	Context::Scope scopedContext( setsContext.get() );
+
+	ConstCompoundDataPtr sets = boost::static_pointer_cast<const CompoundData>( setsPlug()->getValue() );
+	const PathMatcherData *set = sets->member<PathMatcherData>( setName );
+	if( !set )
 	{
-		loadSetWalk( rootScene.get(), setName, result->writable(), ScenePath() );
+		return parent->setPlug()->defaultValue();
 	}
-	return result;
+
+	return set;
 }
 
 void SceneReader::plugSet( Gaffer::Plug *plug )
@@ -449,7 +664,7 @@ void SceneReader::plugSet( Gaffer::Plug *plug )
 	if( plug == refreshCountPlug() )
 	{
 		SharedSceneInterfaces::clear();
-		m_lastScene.clear();
+		sceneCache().clear();
 	}
 }
 
@@ -461,26 +676,5 @@ ConstSceneInterfacePtr SceneReader::scene( const ScenePath &path ) const
 		return NULL;
 	}
 
-	LastScene &lastScene = m_lastScene.local();
-	if( lastScene.fileName == fileName )
-	{
-		if( lastScene.path == path )
-		{
-			return lastScene.pathScene;
-		}
-		else
-		{
-			lastScene.pathScene = lastScene.fileNameScene->scene( path );
-			lastScene.path = path;
-			return lastScene.pathScene;
-		}
-	}
-
-	lastScene.fileNameScene = SharedSceneInterfaces::get( fileName );
-	lastScene.fileName = fileName;
-
-	lastScene.pathScene = lastScene.fileNameScene->scene( path );
-	lastScene.path = path;
-
-	return lastScene.pathScene;
+	return cachedScene( fileName, path );
 }
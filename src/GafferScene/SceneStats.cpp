@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Gaffer/Context.h"
+
+#include "GafferScene/SceneStats.h"
+#include "GafferScene/SceneAlgo.h"
+
+using namespace std;
+using namespace IECore;
+using namespace Gaffer;
+using namespace GafferScene;
+
+//////////////////////////////////////////////////////////////////////////
+// SceneStats
+//////////////////////////////////////////////////////////////////////////
+
+IE_CORE_DEFINERUNTIMETYPED( SceneStats );
+
+size_t SceneStats::g_firstPlugIndex = 0;
+
+SceneStats::SceneStats( const std::string &name )
+	:	ComputeNode( name )
+{
+	storeIndexOfNextChild( g_firstPlugIndex );
+	addChild( new ScenePlug( "in" ) );
+	addChild( new AtomicCompoundDataPlug( "stats", Plug::Out, new CompoundData ) );
+}
+
+SceneStats::~SceneStats()
+{
+}
+
+ScenePlug *SceneStats::inPlug()
+{
+	return getChild<ScenePlug>( g_firstPlugIndex );
+}
+
+const ScenePlug *SceneStats::inPlug() const
+{
+	return getChild<ScenePlug>( g_firstPlugIndex );
+}
+
+Gaffer::AtomicCompoundDataPlug *SceneStats::statsPlug()
+{
+	return getChild<AtomicCompoundDataPlug>( g_firstPlugIndex + 1 );
+}
+
+const Gaffer::AtomicCompoundDataPlug *SceneStats::statsPlug() const
+{
+	return getChild<AtomicCompoundDataPlug>( g_firstPlugIndex + 1 );
+}
+
+void SceneStats::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
+{
+	ComputeNode::affects( input, outputs );
+
+	if(
+		input == inPlug()->objectPlug() ||
+		input == inPlug()->childNamesPlug() ||
+		input == inPlug()->setNamesPlug() ||
+		input == inPlug()->setPlug()
+	)
+	{
+		outputs.push_back( statsPlug() );
+	}
+}
+
+void SceneStats::hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	ComputeNode::hash( output, context, h );
+
+	if( output == statsPlug() )
+	{
+		h.append( inPlug()->hierarchyHash( ScenePlug::ScenePath() ) );
+
+		const MurmurHash setNamesHash = inPlug()->setNamesPlug()->hash();
+		h.append( setNamesHash );
+		ConstInternedStringVectorDataPtr setNamesData = inPlug()->setNamesPlug()->getValue( &setNamesHash );
+
+		ContextPtr setContext = new Context( *context, Context::Borrowed );
+		Context::Scope scopedContext( setContext.get() );
+		const vector<InternedString> &setNames = setNamesData->readable();
+		for( vector<InternedString>::const_iterator it = setNames.begin(), eIt = setNames.end(); it != eIt; ++it )
+		{
+			setContext->set( ScenePlug::setNameContextName, *it );
+			inPlug()->setPlug()->hash( h );
+		}
+	}
+}
+
+void SceneStats::compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const
+{
+	if( output == statsPlug() )
+	{
+		static_cast<AtomicCompoundDataPlug *>( output )->setValue( sceneStats( inPlug() ) );
+		return;
+	}
+
+	ComputeNode::compute( output, context );
+}
@@ -34,7 +34,14 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <map>
+
+#include "tbb/pipeline.h"
+#include "tbb/parallel_for.h"
+
 #include "boost/filesystem.hpp"
+#include "boost/shared_ptr.hpp"
 
 #include "IECore/SceneInterface.h"
 #include "IECore/Transform.h"
@@ -52,6 +59,389 @@ using namespace GafferScene;
 
 IE_CORE_DEFINERUNTIMETYPED( SceneWriter );
 
+//////////////////////////////////////////////////////////////////////////
+// Write pipeline
+//
+// The scene is written using a tbb pipeline, with three stages :
+//
+// 1. A serial stage which generates locations in the depth-first
+//    order required by SceneInterface. This must evaluate the child
+//    names for each location, but nothing else.
+// 2. A parallel stage which computes the remaining properties of each
+//    location. This is where the bulk of the graph evaluation happens.
+// 3. A serial stage which writes the computed locations to the file,
+//    in the same order as they were generated.
+//
+// Each pass of the pipeline processes a batch of frames at once, with
+// each frame evaluated concurrently in its own Context, and the samples
+// for each location written in time order. The hierarchy visited is the
+// union of the hierarchies at each frame, and samples are only written
+// for the frames at which a location exists.
+//
+// The pipeline is limited to a fixed number of locations in flight
+// at once, and a fixed number of frames per batch, bounding the memory
+// used to hold computed locations which haven't been written yet.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+size_t g_maxLocationsInFlight = 1000;
+size_t g_maxFramesInFlight = 4;
+
+typedef vector<ContextPtr> FrameContexts;
+
+struct Sample
+{
+	Sample() : exists( false ) {}
+	bool exists;
+	ConstCompoundObjectPtr attributes;
+	ConstCompoundObjectPtr globals;
+	ConstObjectPtr object;
+	Imath::Box3f bound;
+	Imath::M44f transform;
+};
+
+struct Location
+{
+	ScenePlug::ScenePath path;
+	vector<Sample> samples;
+};
+
+typedef boost::shared_ptr<Location> LocationPtr;
+
+// Specifies a location and the frames at which it exists,
+// prior to it being generated.
+struct PendingLocation
+{
+	ScenePlug::ScenePath path;
+	vector<bool> exists;
+};
+
+class LocationGenerator
+{
+
+	public :
+
+		LocationGenerator( const ScenePlug *scene, const FrameContexts &frameContexts )
+			:	m_scene( scene ), m_frameContexts( frameContexts )
+		{
+			m_pending.push_back( PendingLocation() );
+			m_pending.back().exists.resize( frameContexts.size(), true );
+		}
+
+		LocationPtr operator()( tbb::flow_control &fc ) const
+		{
+			if( m_pending.empty() )
+			{
+				fc.stop();
+				return LocationPtr();
+			}
+
+			LocationPtr location( new Location );
+			location->path.swap( m_pending.back().path );
+			location->samples.resize( m_frameContexts.size() );
+			for( size_t i = 0, e = m_frameContexts.size(); i < e; ++i )
+			{
+				location->samples[i].exists = m_pending.back().exists[i];
+			}
+			m_pending.pop_back();
+
+			// Get the child names at each frame. We
+			// do this in parallel when there are several
+			// frames to consider.
+
+			vector<ConstInternedStringVectorDataPtr> childNames( m_frameContexts.size() );
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, m_frameContexts.size(), 1 ),
+				ChildNamesComputer( m_scene, m_frameContexts, *location, childNames )
+			);
+
+			// Take the union of the children at all frames,
+			// in the order in which they first appear.
+
+			const size_t firstPending = m_pending.size();
+			const vector<InternedString> *previousChildNames = NULL;
+			size_t previousFrame = 0;
+			std::map<InternedString, size_t> pendingIndices;
+			for( size_t i = 0, e = childNames.size(); i < e; ++i )
+			{
+				if( !childNames[i] )
+				{
+					continue;
+				}
+
+				const vector<InternedString> &frameChildNames = childNames[i]->readable();
+				if( previousChildNames && *previousChildNames == frameChildNames )
+				{
+					// Common case of an unchanging hierarchy.
+					for( size_t c = firstPending, ce = m_pending.size(); c < ce; ++c )
+					{
+						m_pending[c].exists[i] = m_pending[c].exists[previousFrame];
+					}
+					previousFrame = i;
+					continue;
+				}
+
+				if( previousChildNames && pendingIndices.empty() )
+				{
+					// The hierarchy has changed. Build an index so we can
+					// find the children which have already been seen.
+					for( size_t c = firstPending, ce = m_pending.size(); c < ce; ++c )
+					{
+						pendingIndices[m_pending[c].path.back()] = c;
+					}
+				}
+
+				for( vector<InternedString>::const_iterator it = frameChildNames.begin(), eIt = frameChildNames.end(); it != eIt; ++it )
+				{
+					size_t c = m_pending.size();
+					if( previousChildNames )
+					{
+						std::map<InternedString, size_t>::const_iterator pIt = pendingIndices.find( *it );
+						if( pIt != pendingIndices.end() )
+						{
+							c = pIt->second;
+						}
+						else
+						{
+							pendingIndices[*it] = c;
+						}
+					}
+
+					if( c == m_pending.size() )
+					{
+						m_pending.push_back( PendingLocation() );
+						m_pending.back().path.reserve( location->path.size() + 1 );
+						m_pending.back().path = location->path;
+						m_pending.back().path.push_back( *it );
+						m_pending.back().exists.resize( m_frameContexts.size(), false );
+					}
+					m_pending[c].exists[i] = true;
+				}
+				previousChildNames = &frameChildNames;
+				previousFrame = i;
+			}
+
+			// Reverse the children, so that they are
+			// popped in their original order.
+			std::reverse( m_pending.begin() + firstPending, m_pending.end() );
+
+			return location;
+		}
+
+	private :
+
+		struct ChildNamesComputer
+		{
+
+			ChildNamesComputer( const ScenePlug *scene, const FrameContexts &frameContexts, const Location &location, vector<ConstInternedStringVectorDataPtr> &childNames )
+				:	m_scene( scene ), m_frameContexts( frameContexts ), m_location( location ), m_childNames( childNames )
+			{
+			}
+
+			void operator()( const tbb::blocked_range<size_t> &r ) const
+			{
+				for( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					if( !m_location.samples[i].exists )
+					{
+						continue;
+					}
+					ContextPtr context = new Context( *m_frameContexts[i], Context::Borrowed );
+					context->set( ScenePlug::scenePathContextName, m_location.path );
+					Context::Scope scopedContext( context.get() );
+					m_childNames[i] = m_scene->childNamesPlug()->getValue();
+				}
+			}
+
+			const ScenePlug *m_scene;
+			const FrameContexts &m_frameContexts;
+			const Location &m_location;
+			vector<ConstInternedStringVectorDataPtr> &m_childNames;
+
+		};
+
+		const ScenePlug *m_scene;
+		const FrameContexts &m_frameContexts;
+		// Mutable because tbb requires the operator to be const,
+		// but each filter is only ever run on one thread at a time.
+		mutable vector<PendingLocation> m_pending;
+
+};
+
+class LocationComputer
+{
+
+	public :
+
+		LocationComputer( const ScenePlug *scene, const FrameContexts &frameContexts )
+			:	m_scene( scene ), m_frameContexts( frameContexts )
+		{
+		}
+
+		LocationPtr operator()( LocationPtr location ) const
+		{
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, m_frameContexts.size(), 1 ),
+				SampleComputer( m_scene, m_frameContexts, *location )
+			);
+			return location;
+		}
+
+	private :
+
+		struct SampleComputer
+		{
+
+			SampleComputer( const ScenePlug *scene, const FrameContexts &frameContexts, Location &location )
+				:	m_scene( scene ), m_frameContexts( frameContexts ), m_location( location )
+			{
+			}
+
+			void operator()( const tbb::blocked_range<size_t> &r ) const
+			{
+				for( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					Sample &sample = m_location.samples[i];
+					if( !sample.exists )
+					{
+						continue;
+					}
+
+					ContextPtr context = new Context( *m_frameContexts[i], Context::Borrowed );
+					context->set( ScenePlug::scenePathContextName, m_location.path );
+					Context::Scope scopedContext( context.get() );
+
+					sample.attributes = m_scene->attributesPlug()->getValue();
+					sample.object = m_scene->objectPlug()->getValue();
+					sample.bound = m_scene->boundPlug()->getValue();
+					if( m_location.path.empty() )
+					{
+						sample.globals = m_scene->globalsPlug()->getValue();
+					}
+					else
+					{
+						sample.transform = m_scene->transformPlug()->getValue();
+					}
+				}
+			}
+
+			const ScenePlug *m_scene;
+			const FrameContexts &m_frameContexts;
+			Location &m_location;
+
+		};
+
+		const ScenePlug *m_scene;
+		const FrameContexts &m_frameContexts;
+
+};
+
+class LocationWriter
+{
+
+	public :
+
+		LocationWriter( SceneInterface *output, const FrameContexts &frameContexts )
+		{
+			m_outputs.push_back( output );
+			for( FrameContexts::const_iterator it = frameContexts.begin(), eIt = frameContexts.end(); it != eIt; ++it )
+			{
+				m_times.push_back( (*it)->getTime() );
+			}
+		}
+
+		void operator()( LocationPtr location ) const
+		{
+			// Locations arrive in depth-first order, so the parent
+			// of this location is always the last output at the
+			// previous depth.
+			const ScenePlug::ScenePath &path = location->path;
+			m_outputs.resize( path.size() + 1 );
+			if( path.size() )
+			{
+				m_outputs.back() = m_outputs[path.size()-1]->child( path.back(), SceneInterface::CreateIfMissing );
+			}
+			SceneInterface *output = m_outputs.back().get();
+
+			for( size_t i = 0, e = location->samples.size(); i < e; ++i )
+			{
+				const Sample &sample = location->samples[i];
+				if( sample.exists )
+				{
+					writeSample( output, path, sample, m_times[i] );
+				}
+			}
+		}
+
+	private :
+
+		void writeSample( SceneInterface *output, const ScenePlug::ScenePath &path, const Sample &sample, double time ) const
+		{
+			const CompoundObject::ObjectMap &attributes = sample.attributes->members();
+			for( CompoundObject::ObjectMap::const_iterator it = attributes.begin(), eIt = attributes.end(); it != eIt; it++ )
+			{
+				output->writeAttribute( it->first, it->second.get(), time );
+			}
+
+			if( path.empty() )
+			{
+				output->writeAttribute( "gaffer:globals", sample.globals.get(), time );
+			}
+
+			if( sample.object->typeId() != IECore::NullObjectTypeId && path.size() > 0 )
+			{
+				output->writeObject( sample.object.get(), time );
+			}
+
+			const Imath::Box3f &b = sample.bound;
+			output->writeBound( Imath::Box3d( Imath::V3f( b.min ), Imath::V3f( b.max ) ), time );
+
+			if( path.size() )
+			{
+				const Imath::M44f &t = sample.transform;
+				Imath::M44d transform(
+					t[0][0], t[0][1], t[0][2], t[0][3],
+					t[1][0], t[1][1], t[1][2], t[1][3],
+					t[2][0], t[2][1], t[2][2], t[2][3],
+					t[3][0], t[3][1], t[3][2], t[3][3]
+				);
+
+				output->writeTransform( new IECore::M44dData( transform ), time );
+			}
+		}
+
+		vector<double> m_times;
+		mutable vector<SceneInterfacePtr> m_outputs;
+
+};
+
+void writeScene( const ScenePlug *scene, const FrameContexts &frameContexts, SceneInterface *output )
+{
+	tbb::parallel_pipeline(
+		g_maxLocationsInFlight,
+		tbb::make_filter<void, LocationPtr>(
+			tbb::filter::serial_in_order,
+			LocationGenerator( scene, frameContexts )
+		) &
+		tbb::make_filter<LocationPtr, LocationPtr>(
+			tbb::filter::parallel,
+			LocationComputer( scene, frameContexts )
+		) &
+		tbb::make_filter<LocationPtr, void>(
+			tbb::filter::serial_in_order,
+			LocationWriter( output, frameContexts )
+		)
+	);
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// SceneWriter
+//////////////////////////////////////////////////////////////////////////
+
 size_t SceneWriter::g_firstPlugIndex = 0;
 
 SceneWriter::SceneWriter( const std::string &name )
@@ -109,8 +499,7 @@ IECore::MurmurHash SceneWriter::hash( const Gaffer::Context *context ) const
 
 	IECore::MurmurHash h = TaskNode::hash( context );
 	h.append( fileNamePlug()->hash() );
-	/// \todo hash the actual scene when we have a hierarchyHash
-	h.append( (uint64_t)scenePlug );
+	h.append( scenePlug->hierarchyHash( ScenePlug::ScenePath() ) );
 	h.append( context->hash() );
 
 	return h;
@@ -137,10 +526,19 @@ void SceneWriter::executeSequence( const std::vector<float> &frames ) const
 	createDirectories( fileName );
 	SceneInterfacePtr output = SceneInterface::create( fileName, IndexedIO::Write );
 
-	for ( std::vector<float>::const_iterator it = frames.begin(); it != frames.end(); ++it )
+	// Write the frames in batches, with the frames in
+	// each batch being evaluated concurrently.
+	FrameContexts frameContexts;
+	for( std::vector<float>::const_iterator it = frames.begin(); it != frames.end(); )
 	{
-		context->setFrame( *it );
-		writeLocation( scene, ScenePlug::ScenePath(), context.get(), output.get(), context->getTime() );
+		frameContexts.clear();
+		for( ; it != frames.end() && frameContexts.size() < g_maxFramesInFlight; ++it )
+		{
+			ContextPtr frameContext = new Context( *context, Context::Borrowed );
+			frameContext->setFrame( *it );
+			frameContexts.push_back( frameContext );
+		}
+		writeScene( scene, frameContexts, output.get() );
 	}
 }
 
@@ -149,58 +547,24 @@ bool SceneWriter::requiresSequenceExecution() const
 	return true;
 }
 
-void SceneWriter::writeLocation( const GafferScene::ScenePlug *scene, const ScenePlug::ScenePath &scenePath, Context *context, IECore::SceneInterface *output, double time ) const
+void SceneWriter::setMaxLocationsInFlight( size_t maxLocationsInFlight )
 {
-	context->set( ScenePlug::scenePathContextName, scenePath );
-
-	ConstCompoundObjectPtr attributes = scene->attributesPlug()->getValue();
-	for( CompoundObject::ObjectMap::const_iterator it = attributes->members().begin(), eIt = attributes->members().end(); it != eIt; it++ )
-	{
-		output->writeAttribute( it->first, it->second.get(), time );
-	}
-
-	if( scenePath.empty() )
-	{
-		ConstCompoundObjectPtr globals = scene->globalsPlug()->getValue();
-		output->writeAttribute( "gaffer:globals", globals.get(), time );
-	}
-
-	ConstObjectPtr object = scene->objectPlug()->getValue();
-
-	if( object->typeId() != IECore::NullObjectTypeId && scenePath.size() > 0 )
-	{
-		output->writeObject( object.get(), time );
-	}
-
-	Imath::Box3f b = scene->boundPlug()->getValue();
-
-	output->writeBound( Imath::Box3d( Imath::V3f( b.min ), Imath::V3f( b.max ) ), time );
-
-	if( scenePath.size() )
-	{
-		Imath::M44f t = scene->transformPlug()->getValue();
-		Imath::M44d transform(
-			t[0][0], t[0][1], t[0][2], t[0][3],
-			t[1][0], t[1][1], t[1][2], t[1][3],
-			t[2][0], t[2][1], t[2][2], t[2][3],
-			t[3][0], t[3][1], t[3][2], t[3][3]
-		);
-
-		output->writeTransform( new IECore::M44dData( transform ), time );
-	}
-
-	ConstInternedStringVectorDataPtr childNames = scene->childNamesPlug()->getValue();
+	g_maxLocationsInFlight = std::max( maxLocationsInFlight, (size_t)1 );
+}
 
-	ScenePlug::ScenePath childScenePath = scenePath;
-	childScenePath.push_back( InternedString() );
-	for( vector<InternedString>::const_iterator it=childNames->readable().begin(); it!=childNames->readable().end(); it++ )
-	{
-		childScenePath[scenePath.size()] = *it;
+size_t SceneWriter::getMaxLocationsInFlight()
+{
+	return g_maxLocationsInFlight;
+}
 
-		SceneInterfacePtr outputChild = output->child( *it, SceneInterface::CreateIfMissing );
+void SceneWriter::setMaxFramesInFlight( size_t maxFramesInFlight )
+{
+	g_maxFramesInFlight = std::max( maxFramesInFlight, (size_t)1 );
+}
 
-		writeLocation( scene, childScenePath, context, outputChild.get(), time );
-	}
+size_t SceneWriter::getMaxFramesInFlight()
+{
+	return g_maxFramesInFlight;
 }
 
 void SceneWriter::createDirectories( const std::string &fileName ) const
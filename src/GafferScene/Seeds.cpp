@@ -35,7 +35,13 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
-#include "IECore/PointDistributionOp.h"
+#include <algorithm>
+
+#include "tbb/parallel_for.h"
+
+#include "IECore/PointDistribution.h"
+#include "IECore/MeshPrimitive.h"
+#include "IECore/PointsPrimitive.h"
 
 #include "Gaffer/StringPlug.h"
 
@@ -47,6 +53,333 @@ using namespace IECore;
 using namespace Gaffer;
 using namespace GafferScene;
 
+//////////////////////////////////////////////////////////////////////////
+// Point distribution
+//
+// Points are distributed in uv space using the blue noise tiles of
+// IECore::PointDistribution, keeping only those which fall within each
+// triangle of the mesh. Because the points generated for a triangle
+// depend only on its own uvs and positions, the faces can be processed
+// in parallel, in fixed size batches which are concatenated in face
+// order. This makes the result identical regardless of the number of
+// threads used. Faces are triangulated on the fly, so the input mesh
+// is never copied.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Provides access to a primitive variable using the vertex
+// numbering of the mesh, regardless of its interpolation.
+template<typename T>
+class MeshVariable
+{
+
+	public :
+
+		MeshVariable( const MeshPrimitive *mesh, const std::string &name, bool required )
+			:	m_data( NULL ), m_interpolation( PrimitiveVariable::Invalid )
+		{
+			PrimitiveVariableMap::const_iterator it = mesh->variables.find( name );
+			if( it == mesh->variables.end() )
+			{
+				if( required )
+				{
+					throw IECore::Exception( "MeshPrimitive has no primitive variable named \"" + name + "\"" );
+				}
+				return;
+			}
+
+			if( const TypedData<vector<T> > *d = runTimeCast<const TypedData<vector<T> > >( it->second.data.get() ) )
+			{
+				m_data = d->readable().empty() ? NULL : &d->readable()[0];
+				m_interpolation = it->second.interpolation;
+			}
+			else if( const TypedData<T> *d = runTimeCast<const TypedData<T> >( it->second.data.get() ) )
+			{
+				m_data = &d->readable();
+				m_interpolation = PrimitiveVariable::Constant;
+			}
+			else
+			{
+				throw IECore::Exception( "Primitive variable \"" + name + "\" has unsupported type \"" + it->second.data->typeName() + "\"" );
+			}
+		}
+
+		bool valid() const
+		{
+			return m_data;
+		}
+
+		/// Returns the value for the specified face, face-vertex
+		/// and vertex indices.
+		const T &operator()( size_t faceIndex, size_t faceVertexIndex, int vertexIndex ) const
+		{
+			switch( m_interpolation )
+			{
+				case PrimitiveVariable::Constant :
+					return m_data[0];
+				case PrimitiveVariable::Uniform :
+					return m_data[faceIndex];
+				case PrimitiveVariable::FaceVarying :
+					return m_data[faceVertexIndex];
+				default :
+					return m_data[vertexIndex];
+			}
+		}
+
+	private :
+
+		const T *m_data;
+		PrimitiveVariable::Interpolation m_interpolation;
+
+};
+
+// Used with PointDistribution to generate the points for
+// a single triangle.
+class TriangleEmitter
+{
+
+	public :
+
+		TriangleEmitter( const V2f uv[3], const V3f p[3], const float density[3], vector<V3f> &points )
+			:	m_uv( uv ), m_p( p ), m_density( density ), m_points( points )
+		{
+			m_denominator = ( m_uv[1] - m_uv[0] ).cross( m_uv[2] - m_uv[0] );
+		}
+
+		float area() const
+		{
+			return fabs( m_denominator ) * 0.5f;
+		}
+
+		float density( const V2f &uv ) const
+		{
+			const V3f b = barycentric( uv );
+			return b[0] * m_density[0] + b[1] * m_density[1] + b[2] * m_density[2];
+		}
+
+		void emit( const V2f &uv ) const
+		{
+			if( !contains( uv ) )
+			{
+				return;
+			}
+			const V3f b = barycentric( uv );
+			m_points.push_back( m_p[0] * b[0] + m_p[1] * b[1] + m_p[2] * b[2] );
+		}
+
+	private :
+
+		// Returns true if the triangle contains uv. Each edge is evaluated
+		// with its endpoints in a canonical order, so neighbouring triangles
+		// compute bit-identical results for a shared edge. Points lying
+		// exactly on the edge are then claimed by only one of the triangles,
+		// rather than being emitted by both.
+		bool contains( const V2f &uv ) const
+		{
+			for( int i = 0; i < 3; ++i )
+			{
+				V2f a = m_uv[(i+1)%3];
+				V2f b = m_uv[(i+2)%3];
+				if( b.x < a.x || ( b.x == a.x && b.y < a.y ) )
+				{
+					std::swap( a, b );
+				}
+
+				const float side = ( b - a ).cross( uv - a );
+				const float oppositeSide = ( b - a ).cross( m_uv[i] - a );
+				if( side == 0.0f )
+				{
+					if( oppositeSide < 0.0f )
+					{
+						return false;
+					}
+				}
+				else if( ( side > 0.0f ) != ( oppositeSide > 0.0f ) )
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		V3f barycentric( const V2f &uv ) const
+		{
+			const float b1 = ( uv - m_uv[0] ).cross( m_uv[2] - m_uv[0] ) / m_denominator;
+			const float b2 = ( m_uv[1] - m_uv[0] ).cross( uv - m_uv[0] ) / m_denominator;
+			return V3f( 1.0f - b1 - b2, b1, b2 );
+		}
+
+		const V2f *m_uv;
+		const V3f *m_p;
+		const float *m_density;
+		float m_denominator;
+		vector<V3f> &m_points;
+
+};
+
+// Adaptors providing the density and point functions
+// required by PointDistribution.
+
+struct TriangleDensity
+{
+	TriangleDensity( const TriangleEmitter &emitter ) : m_emitter( emitter ) {}
+	float operator()( const V2f &uv ) { return m_emitter.density( uv ); }
+	const TriangleEmitter &m_emitter;
+};
+
+struct TrianglePoint
+{
+	TrianglePoint( const TriangleEmitter &emitter ) : m_emitter( emitter ) {}
+	void operator()( const V2f &uv ) { m_emitter.emit( uv ); }
+	const TriangleEmitter &m_emitter;
+};
+
+class FaceBatchDistributor
+{
+
+	public :
+
+		static const size_t batchSize = 1000;
+
+		FaceBatchDistributor(
+			const MeshPrimitive *mesh,
+			const vector<int> &vertexOffsets,
+			const MeshVariable<V3f> &p,
+			const MeshVariable<float> &s,
+			const MeshVariable<float> &t,
+			const MeshVariable<float> &densityVariable,
+			float density,
+			vector<vector<V3f> > &batchPoints
+		)
+			:	m_verticesPerFace( mesh->verticesPerFace()->readable() ), m_vertexIds( mesh->vertexIds()->readable() ), m_vertexOffsets( vertexOffsets ),
+				m_p( p ), m_s( s ), m_t( t ), m_densityVariable( densityVariable ), m_density( density ), m_batchPoints( batchPoints )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			for( size_t batch = r.begin(); batch != r.end(); ++batch )
+			{
+				vector<V3f> &points = m_batchPoints[batch];
+				const size_t endFace = std::min( ( batch + 1 ) * batchSize, m_verticesPerFace.size() );
+				for( size_t face = batch * batchSize; face < endFace; ++face )
+				{
+					distributeFace( face, points );
+				}
+			}
+		}
+
+	private :
+
+		void distributeFace( size_t face, vector<V3f> &points ) const
+		{
+			const int offset = m_vertexOffsets[face];
+			V2f uv[3];
+			V3f p[3];
+			float density[3];
+
+			// Fan triangulation, sharing the first vertex.
+			for( int i = 1; i < m_verticesPerFace[face] - 1; ++i )
+			{
+				const size_t faceVertices[3] = { (size_t)offset, (size_t)( offset + i ), (size_t)( offset + i + 1 ) };
+				for( int v = 0; v < 3; ++v )
+				{
+					const int vertexId = m_vertexIds[faceVertices[v]];
+					uv[v] = V2f( m_s( face, faceVertices[v], vertexId ), m_t( face, faceVertices[v], vertexId ) );
+					p[v] = m_p( face, faceVertices[v], vertexId );
+					density[v] = m_densityVariable.valid() ? m_densityVariable( face, faceVertices[v], vertexId ) : 1.0f;
+				}
+
+				TriangleEmitter emitter( uv, p, density, points );
+				const float uvArea = emitter.area();
+				if( uvArea == 0.0f )
+				{
+					continue;
+				}
+
+				// Scale the density to account for the difference
+				// between areas in uv space and object space.
+				const float area = ( ( p[1] - p[0] ).cross( p[2] - p[0] ) ).length() * 0.5f;
+				const float uvDensity = m_density * area / uvArea;
+
+				Box2f uvBound;
+				for( int v = 0; v < 3; ++v )
+				{
+					uvBound.extendBy( uv[v] );
+				}
+
+				TriangleDensity densityFunctor( emitter );
+				TrianglePoint pointFunctor( emitter );
+				PointDistribution::defaultInstance()( uvBound, uvDensity, densityFunctor, pointFunctor );
+			}
+		}
+
+		const vector<int> &m_verticesPerFace;
+		const vector<int> &m_vertexIds;
+		const vector<int> &m_vertexOffsets;
+		const MeshVariable<V3f> &m_p;
+		const MeshVariable<float> &m_s;
+		const MeshVariable<float> &m_t;
+		const MeshVariable<float> &m_densityVariable;
+		const float m_density;
+		vector<vector<V3f> > &m_batchPoints;
+
+};
+
+PointsPrimitivePtr distributePoints( const MeshPrimitive *mesh, float density, const std::string &densityPrimitiveVariable )
+{
+	const MeshVariable<V3f> p( mesh, "P", true );
+	const MeshVariable<float> s( mesh, "s", true );
+	const MeshVariable<float> t( mesh, "t", true );
+	// The density variable is optional, and if it is missing we
+	// fall back to a uniform distribution.
+	const MeshVariable<float> densityVariable( mesh, densityPrimitiveVariable, false );
+
+	const vector<int> &verticesPerFace = mesh->verticesPerFace()->readable();
+	vector<int> vertexOffsets;
+	vertexOffsets.reserve( verticesPerFace.size() );
+	int offset = 0;
+	for( vector<int>::const_iterator it = verticesPerFace.begin(), eIt = verticesPerFace.end(); it != eIt; ++it )
+	{
+		vertexOffsets.push_back( offset );
+		offset += *it;
+	}
+
+	// Make sure the tile set is loaded before we go parallel.
+	PointDistribution::defaultInstance();
+
+	const size_t numBatches = ( verticesPerFace.size() + FaceBatchDistributor::batchSize - 1 ) / FaceBatchDistributor::batchSize;
+	vector<vector<V3f> > batchPoints( numBatches );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numBatches ),
+		FaceBatchDistributor( mesh, vertexOffsets, p, s, t, densityVariable, density, batchPoints )
+	);
+
+	size_t numPoints = 0;
+	for( vector<vector<V3f> >::const_iterator it = batchPoints.begin(), eIt = batchPoints.end(); it != eIt; ++it )
+	{
+		numPoints += it->size();
+	}
+
+	V3fVectorDataPtr pointsData = new V3fVectorData;
+	vector<V3f> &points = pointsData->writable();
+	points.reserve( numPoints );
+	for( vector<vector<V3f> >::const_iterator it = batchPoints.begin(), eIt = batchPoints.end(); it != eIt; ++it )
+	{
+		points.insert( points.end(), it->begin(), it->end() );
+	}
+
+	return new PointsPrimitive( pointsData );
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Seeds
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( Seeds );
 
 size_t Seeds::g_firstPlugIndex = 0;
@@ -58,6 +391,7 @@ Seeds::Seeds( const std::string &name )
 	addChild( new StringPlug( "name", Plug::In, "seeds" ) );
 	addChild( new FloatPlug( "density", Plug::In, 1.0f, 0.0f ) );
 	addChild( new StringPlug( "pointType", Plug::In, "gl:point" ) );
+	addChild( new StringPlug( "densityPrimitiveVariable", Plug::In, "density" ) );
 }
 
 Seeds::~Seeds()
@@ -94,11 +428,21 @@ const Gaffer::StringPlug *Seeds::pointTypePlug() const
 	return getChild<StringPlug>( g_firstPlugIndex + 2 );
 }
 
+Gaffer::StringPlug *Seeds::densityPrimitiveVariablePlug()
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 3 );
+}
+
+const Gaffer::StringPlug *Seeds::densityPrimitiveVariablePlug() const
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 3 );
+}
+
 void Seeds::affects( const Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	BranchCreator::affects( input, outputs );
 
-	if( input == densityPlug() || input == pointTypePlug() )
+	if( input == densityPlug() || input == pointTypePlug() || input == densityPrimitiveVariablePlug() )
 	{
 		outputs.push_back( outPlug()->objectPlug() );
 	}
@@ -155,6 +499,7 @@ void Seeds::hashBranchObject( const ScenePath &parentPath, const ScenePath &bran
 		h.append( inPlug()->objectHash( parentPath ) );
 		densityPlug()->hash( h );
 		pointTypePlug()->hash( h );
+		densityPrimitiveVariablePlug()->hash( h );
 		return;
 	}
 
@@ -172,11 +517,7 @@ IECore::ConstObjectPtr Seeds::computeBranchObject( const ScenePath &parentPath,
 			return outPlug()->objectPlug()->defaultValue();
 		}
 
-		PointDistributionOpPtr op = new PointDistributionOp();
-		op->meshParameter()->setValue( mesh->copy() );
-		op->densityParameter()->setNumericValue( densityPlug()->getValue() );
-
-		PrimitivePtr result = runTimeCast<Primitive>( op->operate() );
+		PrimitivePtr result = distributePoints( mesh.get(), densityPlug()->getValue(), densityPrimitiveVariablePlug()->getValue() );
 		result->variables["type"] = PrimitiveVariable( PrimitiveVariable::Constant, new StringData( pointTypePlug()->getValue() ) );
 
 		return result;
@@ -34,6 +34,9 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/parallel_reduce.h"
+#include "tbb/blocked_range.h"
+
 #include "Gaffer/StringPlug.h"
 #include "Gaffer/StringAlgo.h"
 
@@ -46,6 +49,76 @@ using namespace GafferScene;
 
 static InternedString g_ellipsis( "..." );
 
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Functor for use with tbb::parallel_reduce, tokenising a range of
+// paths and adding them to a PathMatcher. Each subrange accumulates
+// into its own PathMatcher, and these are merged in join(), so no
+// locking is required.
+struct PathMatcherBuilder
+{
+
+	PathMatcherBuilder( const vector<string> &paths )
+		:	m_paths( paths )
+	{
+	}
+
+	PathMatcherBuilder( const PathMatcherBuilder &rhs, tbb::split )
+		:	m_paths( rhs.m_paths )
+	{
+	}
+
+	void operator() ( const tbb::blocked_range<size_t> &r )
+	{
+		vector<InternedString> tokenizedPath;
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			const string &path = m_paths[i];
+			if( path.empty() )
+			{
+				continue;
+			}
+			tokenizedPath.clear();
+			Gaffer::tokenize( path, '/', tokenizedPath );
+			for( vector<InternedString>::const_iterator nIt = tokenizedPath.begin(), neIt = tokenizedPath.end(); nIt != neIt; ++nIt )
+			{
+				if( Gaffer::hasWildcards( nIt->c_str() ) || *nIt == g_ellipsis )
+				{
+					throw IECore::Exception( "Path \"" + path + "\" contains wildcards." );
+				}
+			}
+			m_pathMatcher.addPath( tokenizedPath );
+		}
+	}
+
+	void join( const PathMatcherBuilder &rhs )
+	{
+		m_pathMatcher.addPaths( rhs.m_pathMatcher );
+	}
+
+	const PathMatcher &result() const
+	{
+		return m_pathMatcher;
+	}
+
+	private :
+
+		const vector<string> &m_paths;
+		PathMatcher m_pathMatcher;
+
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Set
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( Set );
 
 size_t Set::g_firstPlugIndex = 0;
@@ -151,27 +224,19 @@ void Set::compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) c
 		ConstStringVectorDataPtr pathsData = pathsPlug()->getValue();
 		const vector<string> &paths = pathsData->readable();
 
-		PathMatcherDataPtr pathMatcherData = new PathMatcherData;
-		PathMatcher &pathMatcher = pathMatcherData->writable();
-
-		vector<InternedString> tokenizedPath;
-		for( vector<string>::const_iterator it = paths.begin(), eIt = paths.end(); it != eIt; ++it )
-		{
-			if( it->empty() )
-			{
-				continue;
-			}
-			tokenizedPath.clear();
-			Gaffer::tokenize( *it, '/', tokenizedPath );
-			for( vector<InternedString>::const_iterator nIt = tokenizedPath.begin(), neIt = tokenizedPath.end(); nIt != neIt; ++nIt )
-			{
-				if( Gaffer::hasWildcards( nIt->c_str() ) || *nIt == g_ellipsis )
-				{
-					throw IECore::Exception( "Path \"" + *it + "\" contains wildcards." );
-				}
-			}
-			pathMatcher.addPath( tokenizedPath );
-		}
+		// Tokenising and adding the paths is done in parallel, which
+		// pays off when the paths are generated in bulk by expressions.
+		// Note that the result is stored on an internal plug whose
+		// value depends only on the value of `paths`, so it is
+		// independent of `mode` and `name`, and is only recomputed
+		// when `paths` itself changes.
+		PathMatcherBuilder builder( paths );
+		tbb::parallel_reduce(
+			tbb::blocked_range<size_t>( 0, paths.size(), 1000 ),
+			builder
+		);
+
+		PathMatcherDataPtr pathMatcherData = new PathMatcherData( builder.result() );
 
 		static_cast<Gaffer::ObjectPlug *>( output )->setValue( pathMatcherData );
 		return;
@@ -49,6 +49,7 @@
 #include "IECore/Light.h"
 
 #include "GafferScene/Shader.h"
+#include "GafferScene/ScenePlug.h"
 
 using namespace Imath;
 using namespace GafferScene;
@@ -60,12 +61,22 @@ using namespace Gaffer;
 
 static IECore::InternedString g_nodeColorMetadataName( "nodeGadget:color" );
 
+// Shader networks are typically assigned to many locations, so we
+// evaluate the state in a context without the scene path. This lets
+// all locations share a single hash cache and value cache entry.
+static ContextPtr stateContext()
+{
+	ContextPtr result = new Context( *Context::current(), Context::Borrowed );
+	result->remove( ScenePlug::scenePathContextName );
+	return result;
+}
+
 IE_CORE_DEFINERUNTIMETYPED( Shader );
 
 size_t Shader::g_firstPlugIndex = 0;
 
 Shader::Shader( const std::string &name )
-	:	DependencyNode( name )
+	:	ComputeNode( name )
 {
 	storeIndexOfNextChild( g_firstPlugIndex );
 	addChild( new StringPlug( "name" ) );
@@ -75,6 +86,7 @@ Shader::Shader( const std::string &name )
 	addChild( new StringPlug( "__nodeName", Gaffer::Plug::In, name, Plug::Default & ~(Plug::Serialisable | Plug::AcceptsInputs), Context::NoSubstitutions ) );
 	addChild( new Color3fPlug( "__nodeColor", Gaffer::Plug::In, Color3f( 0.0f ) ) );
 	nodeColorPlug()->setFlags( Plug::Serialisable | Plug::AcceptsInputs, false );
+	addChild( new ObjectVectorPlug( "__state", Gaffer::Plug::Out, new IECore::ObjectVector, Plug::Default & ~Plug::Serialisable ) );
 
 	nameChangedSignal().connect( boost::bind( &Shader::nameChanged, this ) );
 	Metadata::nodeValueChangedSignal().connect( boost::bind( &Shader::nodeMetadataChanged, this, ::_1, ::_2, ::_3 ) );
@@ -156,10 +168,21 @@ const Gaffer::Color3fPlug *Shader::nodeColorPlug() const
 	return getChild<Color3fPlug>( g_firstPlugIndex + 5 );
 }
 
+Gaffer::ObjectVectorPlug *Shader::statePlug()
+{
+	return getChild<ObjectVectorPlug>( g_firstPlugIndex + 6 );
+}
+
+const Gaffer::ObjectVectorPlug *Shader::statePlug() const
+{
+	return getChild<ObjectVectorPlug>( g_firstPlugIndex + 6 );
+}
+
 IECore::MurmurHash Shader::stateHash() const
 {
-	NetworkBuilder networkBuilder( this );
-	return networkBuilder.stateHash();
+	ContextPtr context = stateContext();
+	Context::Scope scope( context.get() );
+	return statePlug()->hash();
 }
 
 void Shader::stateHash( IECore::MurmurHash &h ) const
@@ -169,13 +192,14 @@ void Shader::stateHash( IECore::MurmurHash &h ) const
 
 IECore::ConstObjectVectorPtr Shader::state() const
 {
-	NetworkBuilder networkBuilder( this );
-	return networkBuilder.state();
+	ContextPtr context = stateContext();
+	Context::Scope scope( context.get() );
+	return statePlug()->getValue();
 }
 
 void Shader::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
-	DependencyNode::affects( input, outputs );
+	ComputeNode::affects( input, outputs );
 
 	if(
 		parametersPlug()->isAncestorOf( input ) ||
@@ -186,6 +210,8 @@ void Shader::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs
 		input->parent<Plug>() == nodeColorPlug()
 	)
 	{
+		outputs.push_back( statePlug() );
+
 		const Plug *out = outPlug();
 		if( out )
 		{
@@ -207,6 +233,40 @@ void Shader::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs
 	}
 }
 
+void Shader::hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	ComputeNode::hash( output, context, h );
+
+	if( output == statePlug() )
+	{
+		NetworkBuilder networkBuilder( this );
+		h.append( networkBuilder.stateHash() );
+	}
+}
+
+void Shader::compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const
+{
+	if( output == statePlug() )
+	{
+		NetworkBuilder networkBuilder( this );
+		static_cast<ObjectVectorPlug *>( output )->setValue( networkBuilder.state() );
+		return;
+	}
+	else if( const Plug *out = outPlug() )
+	{
+		if( output == out || out->isAncestorOf( output ) )
+		{
+			// The output plugs exist only to make connections
+			// between shaders, and don't carry any meaningful
+			// value of their own.
+			output->setToDefault();
+			return;
+		}
+	}
+
+	ComputeNode::compute( output, context );
+}
+
 void Shader::parameterHash( const Gaffer::Plug *parameterPlug, NetworkBuilder &network, IECore::MurmurHash &h ) const
 {
 	const Plug *inputPlug = parameterPlug->source<Plug>();
@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "GafferScene/SharedScenePath.h"
+
+using namespace IECore;
+using namespace GafferScene;
+
+SharedScenePath::SharedScenePath()
+	:	m_size( 0 )
+{
+	m_data = NULL;
+}
+
+SharedScenePath::SharedScenePath( const SharedScenePath *parent, const IECore::InternedString &name )
+	:	m_parent( parent ), m_name( name ), m_size( parent->m_size + 1 ), m_hash( parent->m_hash )
+{
+	m_hash.append( name.string() );
+	m_data = NULL;
+}
+
+SharedScenePath::~SharedScenePath()
+{
+	if( m_data )
+	{
+		m_data->removeRef();
+	}
+}
+
+const SharedScenePath *SharedScenePath::parent() const
+{
+	return m_parent.get();
+}
+
+const IECore::InternedString &SharedScenePath::name() const
+{
+	return m_name;
+}
+
+size_t SharedScenePath::size() const
+{
+	return m_size;
+}
+
+const IECore::MurmurHash &SharedScenePath::hash() const
+{
+	return m_hash;
+}
+
+bool SharedScenePath::operator == ( const SharedScenePath &other ) const
+{
+	if( m_size != other.m_size || m_hash != other.m_hash )
+	{
+		return false;
+	}
+
+	// Hashes match, but we still compare names so as not to
+	// rely on the absence of collisions. We can stop as soon
+	// as we reach a shared prefix.
+	const SharedScenePath *a = this;
+	const SharedScenePath *b = &other;
+	while( a != b )
+	{
+		if( a->m_name != b->m_name )
+		{
+			return false;
+		}
+		a = a->m_parent.get();
+		b = b->m_parent.get();
+	}
+
+	return true;
+}
+
+bool SharedScenePath::operator != ( const SharedScenePath &other ) const
+{
+	return !( *this == other );
+}
+
+const IECore::InternedStringVectorData *SharedScenePath::data() const
+{
+	InternedStringVectorData *result = m_data;
+	if( result )
+	{
+		return result;
+	}
+
+	InternedStringVectorDataPtr data = new InternedStringVectorData;
+	std::vector<InternedString> &names = data->writable();
+	names.resize( m_size );
+	for( const SharedScenePath *p = this; p->m_parent; p = p->m_parent.get() )
+	{
+		names[p->m_size-1] = p->m_name;
+	}
+
+	// Another thread may have beaten us to it, in which
+	// case we discard our data and use theirs.
+	data->addRef();
+	result = m_data.compare_and_swap( data.get(), NULL );
+	if( result )
+	{
+		data->removeRef();
+		return result;
+	}
+
+	return data.get();
+}
+
+const ScenePlug::ScenePath &SharedScenePath::names() const
+{
+	return data()->readable();
+}
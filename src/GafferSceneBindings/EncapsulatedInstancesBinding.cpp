@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/python.hpp"
+
+#include "IECorePython/RunTimeTypedBinding.h"
+
+#include "GafferScene/EncapsulatedInstances.h"
+
+#include "GafferSceneBindings/EncapsulatedInstancesBinding.h"
+
+using namespace boost::python;
+using namespace IECore;
+using namespace GafferScene;
+
+namespace
+{
+
+ObjectVectorPtr prototypes( const EncapsulatedInstances &instances )
+{
+	return instances.prototypes()->copy();
+}
+
+StringVectorDataPtr prototypeNames( const EncapsulatedInstances &instances )
+{
+	return instances.prototypeNames()->copy();
+}
+
+M44fVectorDataPtr prototypeTransforms( const EncapsulatedInstances &instances )
+{
+	return instances.prototypeTransforms()->copy();
+}
+
+M44fVectorDataPtr instanceTransforms( const EncapsulatedInstances &instances )
+{
+	return instances.instanceTransforms()->copy();
+}
+
+IntVectorDataPtr instanceIds( const EncapsulatedInstances &instances )
+{
+	return instances.instanceIds()->copy();
+}
+
+} // namespace
+
+void GafferSceneBindings::bindEncapsulatedInstances()
+{
+
+	IECorePython::RunTimeTypedClass<EncapsulatedInstances>()
+		.def( init<>() )
+		.def( init<ConstObjectVectorPtr, ConstStringVectorDataPtr, ConstM44fVectorDataPtr, ConstM44fVectorDataPtr, ConstIntVectorDataPtr>() )
+		.def( "prototypes", &prototypes )
+		.def( "prototypeNames", &prototypeNames )
+		.def( "prototypeTransforms", &prototypeTransforms )
+		.def( "instanceTransforms", &instanceTransforms )
+		.def( "instanceIds", &instanceIds )
+		.def( "numInstances", &EncapsulatedInstances::numInstances )
+		.def( "prototypeBound", &EncapsulatedInstances::prototypeBound )
+	;
+
+}
@@ -36,6 +36,8 @@
 
 #include "boost/python.hpp"
 
+#include "IECorePython/ScopedGILRelease.h"
+
 #include "Gaffer/Context.h"
 
 #include "GafferDispatchBindings/TaskNodeBinding.h"
@@ -44,7 +46,9 @@
 #include "GafferScene/InteractiveRender.h"
 #include "GafferScene/Preview/Render.h"
 #include "GafferScene/Preview/InteractiveRender.h"
+#include "GafferScene/Preview/RendererAlgo.h"
 #include "GafferScene/Private/IECoreScenePreview/Renderer.h"
+#include "GafferScene/Private/IECoreScenePreview/CapturingRenderer.h"
 
 #include "GafferSceneBindings/RenderBinding.h"
 
@@ -167,6 +171,88 @@ void objectInterfaceTransform2( Renderer::ObjectInterface &objectInterface, obje
 	return objectInterface.transform( samples, times );
 }
 
+IECore::DataPtr capturedOption( const CapturingRenderer &renderer, const IECore::InternedString &name )
+{
+	const IECore::Data *d = renderer.capturedOption( name );
+	return d ? d->copy() : NULL;
+}
+
+IECore::DisplayPtr capturedOutput( const CapturingRenderer &renderer, const IECore::InternedString &name )
+{
+	const IECore::Display *d = renderer.capturedOutput( name );
+	return d ? d->copy() : NULL;
+}
+
+IECore::CompoundObjectPtr capturedAttributesAttributes( const CapturingRenderer::CapturedAttributes &attributes )
+{
+	return attributes.attributes()->copy();
+}
+
+list capturedObjectCapturedSamples( const CapturingRenderer::CapturedObject &object )
+{
+	list result;
+	for( std::vector<IECore::ConstObjectPtr>::const_iterator it = object.capturedSamples().begin(), eIt = object.capturedSamples().end(); it != eIt; ++it )
+	{
+		result.append( *it ? (*it)->copy() : IECore::ObjectPtr() );
+	}
+	return result;
+}
+
+list capturedObjectCapturedSampleTimes( const CapturingRenderer::CapturedObject &object )
+{
+	list result;
+	for( std::vector<float>::const_iterator it = object.capturedSampleTimes().begin(), eIt = object.capturedSampleTimes().end(); it != eIt; ++it )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+list capturedObjectCapturedTransforms( const CapturingRenderer::CapturedObject &object )
+{
+	list result;
+	const std::vector<Imath::M44f> transforms = object.capturedTransforms();
+	for( std::vector<Imath::M44f>::const_iterator it = transforms.begin(), eIt = transforms.end(); it != eIt; ++it )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+list capturedObjectCapturedTransformTimes( const CapturingRenderer::CapturedObject &object )
+{
+	list result;
+	const std::vector<float> times = object.capturedTransformTimes();
+	for( std::vector<float>::const_iterator it = times.begin(), eIt = times.end(); it != eIt; ++it )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+CapturingRenderer::CapturedAttributesPtr capturedObjectCapturedAttributes( const CapturingRenderer::CapturedObject &object )
+{
+	return boost::const_pointer_cast<CapturingRenderer::CapturedAttributes>( object.capturedAttributes() );
+}
+
+void outputCamerasWrapper( const ScenePlug &scene, const IECore::CompoundObject &globals, Renderer &renderer )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	Preview::outputCameras( &scene, &globals, &renderer );
+}
+
+void outputLightsWrapper( const ScenePlug &scene, const IECore::CompoundObject &globals, Renderer &renderer )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	Preview::outputLights( &scene, &globals, &renderer );
+}
+
+void outputObjectsWrapper( const ScenePlug &scene, const IECore::CompoundObject &globals, Renderer &renderer )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	Preview::outputObjects( &scene, &globals, &renderer );
+}
+
 } // namespace
 
 void GafferSceneBindings::bindRender()
@@ -216,6 +302,12 @@ void GafferSceneBindings::bindRender()
 			;
 		}
 
+		def( "outputCameras", &outputCamerasWrapper );
+		def( "outputLights", &outputLightsWrapper );
+		def( "outputObjects", &outputObjectsWrapper );
+		def( "setMaxObjectsInFlight", &Preview::setMaxObjectsInFlight );
+		def( "getMaxObjectsInFlight", &Preview::getMaxObjectsInFlight );
+
 	}
 
 	{
@@ -270,6 +362,32 @@ void GafferSceneBindings::bindRender()
 
 		;
 
+		{
+			scope s = IECorePython::RefCountedClass<CapturingRenderer, Renderer>( "CapturingRenderer" )
+				.def( init<Renderer::RenderType, const std::string &>( ( arg( "renderType" ) = Renderer::Interactive, arg( "fileName" ) = "" ) ) )
+				.def( "capturedOption", &capturedOption )
+				.def( "capturedOutput", &capturedOutput )
+				.def( "capturedObject", &CapturingRenderer::capturedObject )
+				.def( "numCapturedObjects", &CapturingRenderer::numCapturedObjects )
+				.def( "numAttributesCalls", &CapturingRenderer::numAttributesCalls )
+			;
+
+			IECorePython::RefCountedClass<CapturingRenderer::CapturedAttributes, Renderer::AttributesInterface>( "CapturedAttributes" )
+				.def( "attributes", &capturedAttributesAttributes )
+			;
+
+			IECorePython::RefCountedClass<CapturingRenderer::CapturedObject, IECore::RefCounted>( "CapturedObject" )
+				.def( "name", &CapturingRenderer::CapturedObject::name, return_value_policy<copy_const_reference>() )
+				.def( "capturedSamples", &capturedObjectCapturedSamples )
+				.def( "capturedSampleTimes", &capturedObjectCapturedSampleTimes )
+				.def( "capturedTransforms", &capturedObjectCapturedTransforms )
+				.def( "capturedTransformTimes", &capturedObjectCapturedTransformTimes )
+				.def( "capturedAttributes", &capturedObjectCapturedAttributes )
+				.def( "numTransformEdits", &CapturingRenderer::CapturedObject::numTransformEdits )
+				.def( "numAttributeEdits", &CapturingRenderer::CapturedObject::numAttributeEdits )
+			;
+		}
+
 	}
 
 }
@@ -40,6 +40,8 @@
 
 #include "IECorePython/ScopedGILRelease.h"
 
+#include "Gaffer/Context.h"
+
 #include "GafferScene/SceneAlgo.h"
 #include "GafferScene/ScenePlug.h"
 #include "GafferScene/Filter.h"
@@ -118,6 +120,88 @@ IECore::CompoundDataPtr setsWrapper( const ScenePlug *scene, bool copy )
 	return copy ? result->copy() : boost::const_pointer_cast<IECore::CompoundData>( result );
 }
 
+IECore::CompoundDataPtr sceneStatsWrapper( const ScenePlug *scene )
+{
+	IECorePython::ScopedGILRelease r;
+	return sceneStats( scene );
+}
+
+IECore::CompoundDataPtr sceneDiffWrapper( const ScenePlug *scene1, const ScenePlug *scene2 )
+{
+	IECorePython::ScopedGILRelease r;
+	return sceneDiff( scene1, scene2 );
+}
+
+IECore::CompoundDataPtr sceneDiffWrapper2( const ScenePlug *scene1, const Gaffer::Context *context1, const ScenePlug *scene2, const Gaffer::Context *context2 )
+{
+	IECorePython::ScopedGILRelease r;
+	return sceneDiff( scene1, context1, scene2, context2 );
+}
+
+std::vector<float> sampleTimes( object pythonSampleTimes )
+{
+	std::vector<float> result;
+	for( size_t i = 0, e = len( pythonSampleTimes ); i < e; ++i )
+	{
+		result.push_back( extract<float>( pythonSampleTimes[i] ) );
+	}
+	return result;
+}
+
+boost::python::tuple sampleTransformWrapper( const ScenePlug *scene, const ScenePlug::ScenePath &path, object pythonSampleTimes )
+{
+	const std::vector<float> times = sampleTimes( pythonSampleTimes );
+	std::vector<Imath::M44f> samples;
+	bool moving;
+	{
+		IECorePython::ScopedGILRelease r;
+		moving = sampleTransform( scene, path, times, samples );
+	}
+
+	list result;
+	for( std::vector<Imath::M44f>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
+	{
+		result.append( *it );
+	}
+	return boost::python::make_tuple( result, moving );
+}
+
+boost::python::tuple sampleFullTransformWrapper( const ScenePlug *scene, const ScenePlug::ScenePath &path, object pythonSampleTimes )
+{
+	const std::vector<float> times = sampleTimes( pythonSampleTimes );
+	std::vector<Imath::M44f> samples;
+	bool moving;
+	{
+		IECorePython::ScopedGILRelease r;
+		moving = sampleFullTransform( scene, path, times, samples );
+	}
+
+	list result;
+	for( std::vector<Imath::M44f>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
+	{
+		result.append( *it );
+	}
+	return boost::python::make_tuple( result, moving );
+}
+
+boost::python::tuple sampleObjectWrapper( const ScenePlug *scene, const ScenePlug::ScenePath &path, object pythonSampleTimes, bool copy )
+{
+	const std::vector<float> times = sampleTimes( pythonSampleTimes );
+	std::vector<IECore::ConstObjectPtr> samples;
+	bool moving;
+	{
+		IECorePython::ScopedGILRelease r;
+		moving = sampleObject( scene, path, times, samples );
+	}
+
+	list result;
+	for( std::vector<IECore::ConstObjectPtr>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
+	{
+		result.append( copy ? (*it)->copy() : boost::const_pointer_cast<IECore::Object>( *it ) );
+	}
+	return boost::python::make_tuple( result, moving );
+}
+
 } // namespace
 
 namespace GafferSceneBindings
@@ -131,6 +215,13 @@ void bindSceneAlgo()
 	def( "matchingPaths", &matchingPathsWrapper2 );
 	def( "matchingPaths", &matchingPathsWrapper3 );
 	def( "shutter", &shutterWrapper );
+	def( "sampleTransform", &sampleTransformWrapper );
+	def( "sampleFullTransform", &sampleFullTransformWrapper );
+	def(
+		"sampleObject",
+		&sampleObjectWrapper,
+		( arg( "scene" ), arg( "path" ), arg( "sampleTimes" ), arg( "_copy" ) = true )
+	);
 	def(
 		"camera",
 		&cameraWrapper1,
@@ -142,6 +233,9 @@ void bindSceneAlgo()
 		( arg( "scene" ), args( "cameraPath" ), arg( "globals" ) = object() )
 	);
 	def( "setExists", &setExistsWrapper );
+	def( "sceneStats", &sceneStatsWrapper );
+	def( "sceneDiff", &sceneDiffWrapper );
+	def( "sceneDiff", &sceneDiffWrapper2 );
 	def(
 		"sets",
 		&setsWrapper,
@@ -238,6 +238,12 @@ IECore::MurmurHash fullAttributesHashWrapper( const ScenePlug &plug, const Scene
 	return plug.fullAttributesHash( scenePath );
 }
 
+IECore::MurmurHash hierarchyHashWrapper( const ScenePlug &plug, const ScenePlug::ScenePath &scenePath )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	return plug.hierarchyHash( scenePath );
+}
+
 IECore::MurmurHash globalsHashWrapper( const ScenePlug &plug )
 {
 	IECorePython::ScopedGILRelease gilRelease;
@@ -303,6 +309,7 @@ void GafferSceneBindings::bindScenePlug()
 		.def( "childNamesHash", &childNamesHashWrapper )
 		.def( "attributesHash", &attributesHashWrapper )
 		.def( "fullAttributesHash", &fullAttributesHashWrapper )
+		.def( "hierarchyHash", &hierarchyHashWrapper )
 		.def( "globalsHash", &globalsHashWrapper )
 		.def( "setNamesHash", &setNamesHashWrapper )
 		.def( "setHash", &setHashWrapper )
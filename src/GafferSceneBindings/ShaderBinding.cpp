@@ -36,7 +36,7 @@
 
 #include "boost/python.hpp"
 
-#include "GafferBindings/DependencyNodeBinding.h"
+#include "GafferBindings/ComputeNodeBinding.h"
 
 #include "GafferScene/Shader.h"
 #include "GafferScene/ShaderSwitch.h"
@@ -49,26 +49,21 @@ using namespace Gaffer;
 using namespace GafferBindings;
 using namespace GafferScene;
 
-static IECore::ObjectVectorPtr state( const Shader &s, bool copy=true )
+static IECore::ObjectVectorPtr state( const Shader &s )
 {
-	IECore::ConstObjectVectorPtr o = s.state();
-	if( copy )
-	{
-		return o->copy();
-	}
-	else
-	{
-		return boost::const_pointer_cast<IECore::ObjectVector>( o );
-	}
+	// The state is owned by the compute cache, so
+	// we must return a copy that python may modify.
+	return s.state()->copy();
 }
 
 void GafferSceneBindings::bindShader()
 {
 
-	GafferBindings::DependencyNodeClass<Shader>()
+	typedef ComputeNodeWrapper<Shader> ShaderWrapper;
+	GafferBindings::DependencyNodeClass<Shader, ShaderWrapper>()
 		.def( "stateHash", (IECore::MurmurHash (Shader::*)() const )&Shader::stateHash )
 		.def( "stateHash", (void (Shader::*)( IECore::MurmurHash &h ) const )&Shader::stateHash )
-		.def( "state", &state, ( boost::python::arg_( "_copy" ) = true ) )
+		.def( "state", &state )
 	;
 
 	GafferBindings::DependencyNodeClass<ShaderSwitch>();
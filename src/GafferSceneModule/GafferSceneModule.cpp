@@ -65,6 +65,7 @@
 #include "GafferScene/Text.h"
 #include "GafferScene/MapProjection.h"
 #include "GafferScene/MapOffset.h"
+#include "GafferScene/SceneStats.h"
 
 #include "GafferSceneBindings/ScenePlugBinding.h"
 #include "GafferSceneBindings/SceneNodeBinding.h"
@@ -101,6 +102,7 @@
 #include "GafferSceneBindings/ParametersBinding.h"
 #include "GafferSceneBindings/PathMatcherDataPlugBinding.h"
 #include "GafferSceneBindings/MeshToPointsBinding.h"
+#include "GafferSceneBindings/EncapsulatedInstancesBinding.h"
 
 using namespace boost::python;
 using namespace GafferBindings;
@@ -127,7 +129,12 @@ BOOST_PYTHON_MODULE( _GafferScene )
 	GafferBindings::DependencyNodeClass<GlobalsProcessor>();
 	GafferBindings::DependencyNodeClass<DeleteSets>();
 
-	GafferDispatchBindings::TaskNodeClass<SceneWriter>();
+	GafferDispatchBindings::TaskNodeClass<SceneWriter>()
+		.def( "setMaxLocationsInFlight", &SceneWriter::setMaxLocationsInFlight ).staticmethod( "setMaxLocationsInFlight" )
+		.def( "getMaxLocationsInFlight", &SceneWriter::getMaxLocationsInFlight ).staticmethod( "getMaxLocationsInFlight" )
+		.def( "setMaxFramesInFlight", &SceneWriter::setMaxFramesInFlight ).staticmethod( "setMaxFramesInFlight" )
+		.def( "getMaxFramesInFlight", &SceneWriter::getMaxFramesInFlight ).staticmethod( "getMaxFramesInFlight" )
+	;
 
 	bindDeleteGlobals();
 	bindOutputs();
@@ -146,6 +153,7 @@ BOOST_PYTHON_MODULE( _GafferScene )
 	GafferBindings::DependencyNodeClass<Text>();
 	GafferBindings::DependencyNodeClass<MapProjection>();
 	GafferBindings::DependencyNodeClass<MapOffset>();
+	GafferBindings::DependencyNodeClass<SceneStats>();
 
 	GafferBindings::NodeClass<OpenGLShader>()
 		.def( "loadShader", &OpenGLShader::loadShader )
@@ -184,5 +192,6 @@ BOOST_PYTHON_MODULE( _GafferScene )
 	bindParameters();
 	bindPathMatcherDataPlug();
 	bindMeshToPoints();
+	bindEncapsulatedInstances();
 
 }
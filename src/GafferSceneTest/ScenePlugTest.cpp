@@ -34,12 +34,24 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "boost/assign/list_of.hpp"
+
 #include "IECore/Timer.h"
 
+#include "Gaffer/Context.h"
+
+#include "GafferTest/Assert.h"
+
 #include "GafferScene/ScenePlug.h"
+#include "GafferScene/SceneAlgo.h"
+#include "GafferScene/SharedScenePath.h"
 
 #include "GafferSceneTest/ScenePlugTest.h"
 
+using namespace std;
+using namespace boost;
+using namespace IECore;
+using namespace Gaffer;
 using namespace GafferScene;
 
 void GafferSceneTest::testManyStringToPathCalls()
@@ -56,3 +68,90 @@ void GafferSceneTest::testManyStringToPathCalls()
 	// Uncomment to get timing information.
 	//std::cerr << t.stop() << std::endl;
 }
+
+void GafferSceneTest::testSharedScenePath()
+{
+	vector<InternedString> a = assign::list_of( "a" );
+	vector<InternedString> ab = assign::list_of( "a" )( "b" );
+
+	ConstSharedScenePathPtr root = new SharedScenePath;
+	GAFFERTEST_ASSERT( root->size() == 0 );
+	GAFFERTEST_ASSERT( root->parent() == NULL );
+	GAFFERTEST_ASSERT( root->names().empty() );
+
+	ConstSharedScenePathPtr pathA = new SharedScenePath( root.get(), "a" );
+	ConstSharedScenePathPtr pathAB = new SharedScenePath( pathA.get(), "b" );
+	GAFFERTEST_ASSERT( pathAB->size() == 2 );
+	GAFFERTEST_ASSERT( pathAB->parent() == pathA.get() );
+	GAFFERTEST_ASSERT( pathAB->name() == "b" );
+	GAFFERTEST_ASSERT( pathA->names() == a );
+	GAFFERTEST_ASSERT( pathAB->names() == ab );
+	GAFFERTEST_ASSERT( pathAB->data() == pathAB->data() );
+
+	// Paths built separately but with the same names
+	// must compare and hash equal.
+
+	ConstSharedScenePathPtr pathAB2 = new SharedScenePath( new SharedScenePath( new SharedScenePath, "a" ), "b" );
+	GAFFERTEST_ASSERT( *pathAB2 == *pathAB );
+	GAFFERTEST_ASSERT( pathAB2->hash() == pathAB->hash() );
+
+	ConstSharedScenePathPtr pathAC = new SharedScenePath( pathA.get(), "c" );
+	GAFFERTEST_ASSERT( *pathAC != *pathAB );
+	GAFFERTEST_ASSERT( pathAC->hash() != pathAB->hash() );
+	GAFFERTEST_ASSERT( *pathA != *pathAB );
+
+	// Sharing the data and hash with a context must be
+	// equivalent to setting a copy of the path.
+
+	ContextPtr sharedContext = new Context;
+	sharedContext->set( ScenePlug::scenePathContextName, pathAB->data(), Context::Shared, pathAB->hash() );
+
+	ContextPtr copiedContext = new Context;
+	copiedContext->set( ScenePlug::scenePathContextName, ab );
+
+	GAFFERTEST_ASSERT( sharedContext->get<ScenePlug::ScenePath>( ScenePlug::scenePathContextName ) == ab );
+	GAFFERTEST_ASSERT( sharedContext->hash() == copiedContext->hash() );
+	GAFFERTEST_ASSERT( *sharedContext == *copiedContext );
+
+	// Likewise for the root path.
+
+	sharedContext->set( ScenePlug::scenePathContextName, root->data(), Context::Shared, root->hash() );
+	copiedContext->set( ScenePlug::scenePathContextName, ScenePlug::ScenePath() );
+	GAFFERTEST_ASSERT( sharedContext->hash() == copiedContext->hash() );
+
+	// And the precomputed hash must be discarded if the
+	// value is changed.
+
+	sharedContext->set( ScenePlug::scenePathContextName, pathA->data(), Context::Shared );
+	copiedContext->set( ScenePlug::scenePathContextName, a );
+	GAFFERTEST_ASSERT( sharedContext->hash() == copiedContext->hash() );
+}
+
+namespace
+{
+
+struct ContextHashFunctor
+{
+
+	bool operator()( const ScenePlug *scene, const ScenePlug::ScenePath &path )
+	{
+		const Context *context = Context::current();
+
+		ContextPtr expectedContext = new Context( *context, Context::Borrowed );
+		expectedContext->remove( ScenePlug::scenePathContextName );
+		expectedContext->set( ScenePlug::scenePathContextName, path );
+
+		GAFFERTEST_ASSERT( context->get<ScenePlug::ScenePath>( ScenePlug::scenePathContextName ) == path );
+		GAFFERTEST_ASSERT( context->hash() == expectedContext->hash() );
+		return true;
+	}
+
+};
+
+} // namespace
+
+void GafferSceneTest::testTraversalContextHash( const GafferScene::ScenePlug *scene )
+{
+	ContextHashFunctor f;
+	parallelTraverse( scene, f );
+}
@@ -57,6 +57,12 @@ static void traverseSceneWrapper( const GafferScene::ScenePlug *scenePlug )
 	traverseScene( scenePlug );
 }
 
+static void testTraversalContextHashWrapper( const GafferScene::ScenePlug *scenePlug )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	testTraversalContextHash( scenePlug );
+}
+
 BOOST_PYTHON_MODULE( _GafferSceneTest )
 {
 
@@ -68,6 +74,8 @@ BOOST_PYTHON_MODULE( _GafferSceneTest )
 	def( "connectTraverseSceneToPlugDirtiedSignal", &connectTraverseSceneToPlugDirtiedSignal );
 
 	def( "testManyStringToPathCalls", &testManyStringToPathCalls );
+	def( "testSharedScenePath", &testSharedScenePath );
+	def( "testTraversalContextHash", &testTraversalContextHashWrapper );
 
 	def( "testPathMatcherRawIterator", &testPathMatcherRawIterator );
 	def( "testPathMatcherIteratorPrune", &testPathMatcherIteratorPrune );
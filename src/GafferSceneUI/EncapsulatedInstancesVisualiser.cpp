@@ -0,0 +1,130 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECoreGL/Group.h"
+#include "IECoreGL/CachedConverter.h"
+
+#include "GafferScene/EncapsulatedInstances.h"
+
+#include "GafferSceneUI/ObjectVisualiser.h"
+
+using namespace std;
+using namespace Imath;
+using namespace GafferSceneUI;
+
+namespace
+{
+
+class EncapsulatedInstancesVisualiser : public ObjectVisualiser
+{
+
+	public :
+
+		typedef GafferScene::EncapsulatedInstances ObjectType;
+
+		EncapsulatedInstancesVisualiser()
+		{
+		}
+
+		virtual ~EncapsulatedInstancesVisualiser()
+		{
+		}
+
+		virtual IECoreGL::ConstRenderablePtr visualise( const IECore::Object *object ) const
+		{
+			const GafferScene::EncapsulatedInstances *instances = IECore::runTimeCast<const GafferScene::EncapsulatedInstances>( object );
+
+			// Convert each prototype only once, and then share the
+			// converted renderable between all the instances.
+
+			IECoreGL::GroupPtr prototypesGroup = new IECoreGL::Group;
+			const IECore::ObjectVector::MemberContainer &prototypes = instances->prototypes()->members();
+			const vector<M44f> &prototypeTransforms = instances->prototypeTransforms()->readable();
+			for( size_t i = 0, e = prototypes.size(); i < e; ++i )
+			{
+				IECoreGL::ConstRenderablePtr renderable = prototypeRenderable( prototypes[i].get() );
+				if( !renderable )
+				{
+					continue;
+				}
+				IECoreGL::GroupPtr prototypeGroup = new IECoreGL::Group;
+				prototypeGroup->setTransform( prototypeTransforms[i] );
+				prototypeGroup->addChild( boost::const_pointer_cast<IECoreGL::Renderable>( renderable ) );
+				prototypesGroup->addChild( prototypeGroup );
+			}
+
+			IECoreGL::GroupPtr result = new IECoreGL::Group;
+			const vector<M44f> &instanceTransforms = instances->instanceTransforms()->readable();
+			for( vector<M44f>::const_iterator it = instanceTransforms.begin(), eIt = instanceTransforms.end(); it != eIt; ++it )
+			{
+				IECoreGL::GroupPtr instanceGroup = new IECoreGL::Group;
+				instanceGroup->setTransform( *it );
+				instanceGroup->addChild( prototypesGroup );
+				result->addChild( instanceGroup );
+			}
+
+			return result;
+		}
+
+	protected :
+
+		static ObjectVisualiserDescription<EncapsulatedInstancesVisualiser> g_visualiserDescription;
+
+	private :
+
+		IECoreGL::ConstRenderablePtr prototypeRenderable( const IECore::Object *prototype ) const
+		{
+			if( const ObjectVisualiser *visualiser = ObjectVisualiser::acquire( prototype->typeId() ) )
+			{
+				return visualiser->visualise( prototype );
+			}
+
+			try
+			{
+				IECore::ConstRunTimeTypedPtr glObject = IECoreGL::CachedConverter::defaultCachedConverter()->convert( prototype );
+				return IECore::runTimeCast<const IECoreGL::Renderable>( glObject.get() );
+			}
+			catch( ... )
+			{
+				return NULL;
+			}
+		}
+
+};
+
+ObjectVisualiser::ObjectVisualiserDescription<EncapsulatedInstancesVisualiser> EncapsulatedInstancesVisualiser::g_visualiserDescription;
+
+} // namespace